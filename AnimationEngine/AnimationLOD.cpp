@@ -0,0 +1,255 @@
+#include "AnimationLOD.h"
+#include "Frustum.h"
+#include <cmath>
+
+AnimationLOD::AnimationLOD()
+{
+	mMetric = LODMetric::Distance;
+}
+
+AnimationLOD::AnimationLOD(LODMetric metric)
+{
+	mMetric = metric;
+}
+
+unsigned int AnimationLOD::AddLevel(float threshold, unsigned int updateInterval)
+{
+	return AddLevel(threshold, updateInterval, JointMask());
+}
+
+unsigned int AnimationLOD::AddLevel(float threshold, unsigned int updateInterval, const JointMask& mask)
+{
+	AnimationLODLevel level;
+	level.mThreshold = threshold;
+	level.mUpdateInterval = updateInterval < 1 ? 1 : updateInterval;
+	level.mJointMask = mask;
+
+	mLevels.push_back(level);
+
+	return (unsigned int)mLevels.size() - 1;
+}
+
+unsigned int AnimationLOD::Size() const
+{
+	return (unsigned int)mLevels.size();
+}
+
+const AnimationLODLevel& AnimationLOD::GetLevel(unsigned int index) const
+{
+	return mLevels[index];
+}
+
+LODMetric AnimationLOD::GetMetric() const
+{
+	return mMetric;
+}
+
+void AnimationLOD::SetMetric(LODMetric metric)
+{
+	mMetric = metric;
+}
+
+unsigned int AnimationLOD::SelectLevel(float metricValue) const
+{
+	unsigned int size = (unsigned int)mLevels.size();
+
+	if (size == 0)
+	{
+		return 0;
+	}
+
+	for (unsigned int i = 0; i < size; ++i)
+	{
+		if (mMetric == LODMetric::Distance && metricValue <= mLevels[i].mThreshold)
+		{
+			return i;
+		}
+
+		if (mMetric == LODMetric::ScreenSize && metricValue >= mLevels[i].mThreshold)
+		{
+			return i;
+		}
+	}
+
+	return size - 1;
+}
+
+unsigned int AnimationLOD::SelectLevel(float distance, float boundingRadius, float fovY) const
+{
+	if (mMetric == LODMetric::Distance)
+	{
+		return SelectLevel(distance);
+	}
+
+	return SelectLevel(ScreenSize(distance, boundingRadius, fovY));
+}
+
+float AnimationLOD::ScreenSize(float distance, float boundingRadius, float fovY)
+{
+	if (distance <= boundingRadius)
+	{
+		return 1.0f;
+	}
+
+	// fovY is in degrees, same as perspective
+	float halfFov = fovY * 3.14159265359f / 360.0f;
+
+	return boundingRadius / (distance * tanf(halfFov));
+}
+
+JointMask MakeJointMask(const Pose& restPose, const std::vector<unsigned int>& excludedRoots)
+{
+	unsigned int numJoints = restPose.Size();
+	JointMask mask(numJoints, true);
+
+	for (unsigned int i = 0; i < numJoints; ++i)
+	{
+		for (unsigned int j = 0, size = (unsigned int)excludedRoots.size(); j < size; ++j)
+		{
+			if (excludedRoots[j] < numJoints && restPose.IsInHierarchy(excludedRoots[j], i))
+			{
+				mask[i] = false;
+				break;
+			}
+		}
+	}
+
+	return mask;
+}
+
+static unsigned int CountSampledTracks(Clip& clip, const JointMask& mask)
+{
+	unsigned int size = clip.Size();
+
+	if (mask.size() == 0)
+	{
+		return size;
+	}
+
+	unsigned int result = 0;
+
+	for (unsigned int i = 0; i < size; ++i)
+	{
+		unsigned int joint = clip.GetIdAtIndex(i);
+
+		if (joint >= mask.size() || mask[joint])
+		{
+			result += 1;
+		}
+	}
+
+	return result;
+}
+
+AnimationLODInstance::AnimationLODInstance()
+{
+	mLevel = 0;
+	mPhase = 0;
+	mFramesSinceUpdate = 0;
+	mFramesBetweenSamples = 1;
+	mHasSamples = false;
+}
+
+void AnimationLODInstance::Reset()
+{
+	mFramesSinceUpdate = 0;
+	mFramesBetweenSamples = 1;
+	mHasSamples = false;
+}
+
+unsigned int AnimationLODInstance::GetLevel() const
+{
+	return mLevel;
+}
+
+void AnimationLODInstance::SetPhase(unsigned int phase)
+{
+	mPhase = phase;
+}
+
+unsigned int AnimationLODInstance::Update(const AnimationLOD& lod, unsigned int level, Clip& clip, const Pose& restPose, float playbackTime, float deltaTime, Pose& outPose)
+{
+	const AnimationLODLevel& settings = lod.GetLevel(level);
+	unsigned int interval = settings.mUpdateInterval;
+	unsigned int tracksPerSample = CountSampledTracks(clip, settings.mJointMask);
+
+	if (level != mLevel)
+	{
+		mLevel = level;
+		Reset();
+	}
+
+	if (interval <= 1)
+	{
+		// Full rate, there is nothing to interpolate so sample straight into the output
+		mHasSamples = false;
+		outPose = restPose;
+		clip.Sample(outPose, playbackTime, settings.mJointMask);
+
+		return tracksPerSample;
+	}
+
+	unsigned int numSamples = 0;
+
+	if (!mHasSamples)
+	{
+		mFrom = restPose;
+		clip.Sample(mFrom, playbackTime, settings.mJointMask);
+		numSamples += 1;
+
+		// The first span is shortened so that updates land on the frames given by the phase
+		mFramesBetweenSamples = interval - (mPhase % interval);
+		mTo = restPose;
+		clip.Sample(mTo, playbackTime + deltaTime * (float)mFramesBetweenSamples, settings.mJointMask);
+		numSamples += 1;
+
+		mFramesSinceUpdate = 0;
+		mHasSamples = true;
+	}
+	else if (mFramesSinceUpdate >= mFramesBetweenSamples)
+	{
+		// The pose sampled ahead last update is the pose for this frame, only the next one is needed.
+		// Masked joints hold the rest pose in both poses so sampling over mTo is enough to refresh it
+		mFrom = mTo;
+		mFramesBetweenSamples = interval;
+		clip.Sample(mTo, playbackTime + deltaTime * (float)interval, settings.mJointMask);
+		numSamples += 1;
+
+		mFramesSinceUpdate = 0;
+	}
+
+	if (mFramesSinceUpdate == 0 || outPose.Size() != mFrom.Size())
+	{
+		outPose = mFrom;
+	}
+
+	if (mFramesSinceUpdate != 0)
+	{
+		float t = (float)mFramesSinceUpdate / (float)mFramesBetweenSamples;
+		Blend(outPose, mFrom, mTo, t, settings.mJointMask);
+	}
+
+	mFramesSinceUpdate += 1;
+
+	return numSamples * tracksPerSample;
+}
+
+unsigned int UpdateVisible(FrustumCuller& culler, std::vector<AnimationLODInstance>& instances, const AnimationLOD& lod, const std::vector<unsigned int>& levels,
+	Clip& clip, const Pose& restPose, const std::vector<float>& playbackTimes, float deltaTime, std::vector<Pose>& outPoses)
+{
+	unsigned int numTracks = 0;
+
+	for (unsigned int i = 0, size = (unsigned int)instances.size(); i < size; ++i)
+	{
+		if (culler.IsVisible(i))
+		{
+			numTracks += instances[i].Update(lod, levels[i], clip, restPose, playbackTimes[i], deltaTime, outPoses[i]);
+		}
+		else
+		{
+			instances[i].Reset();
+		}
+	}
+
+	return numTracks;
+}
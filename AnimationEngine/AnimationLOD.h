@@ -0,0 +1,75 @@
+#pragma once
+#include <vector>
+#include "Clip.h"
+#include "Pose.h"
+
+class FrustumCuller;
+
+enum class LODMetric
+{
+	Distance,	// Levels are picked by distance from the camera, thresholds are maximum distances
+	ScreenSize	// Levels are picked by projected height over viewport height, thresholds are minimum sizes
+};
+
+struct AnimationLODLevel
+{
+	float mThreshold;
+	unsigned int mUpdateInterval; // 1 samples every frame, N samples every Nth frame and interpolates in between
+	JointMask mJointMask; // Empty mask samples every joint
+};
+
+class AnimationLOD
+{
+protected:
+	std::vector<AnimationLODLevel> mLevels;
+	LODMetric mMetric;
+public:
+	AnimationLOD();
+	AnimationLOD(LODMetric metric);
+
+	// Levels are expected to be added from the most to the least detailed
+	unsigned int AddLevel(float threshold, unsigned int updateInterval);
+	unsigned int AddLevel(float threshold, unsigned int updateInterval, const JointMask& mask);
+	unsigned int Size() const;
+	const AnimationLODLevel& GetLevel(unsigned int index) const;
+	LODMetric GetMetric() const;
+	void SetMetric(LODMetric metric);
+
+	unsigned int SelectLevel(float metricValue) const;
+	unsigned int SelectLevel(float distance, float boundingRadius, float fovY) const;
+
+	static float ScreenSize(float distance, float boundingRadius, float fovY);
+};
+
+// Builds a mask that skips excluded joints and all of their children, for example finger or face roots
+JointMask MakeJointMask(const Pose& restPose, const std::vector<unsigned int>& excludedRoots);
+
+// Per character LOD state, keeps the two last sampled poses so reduced update rates can interpolate between them
+class AnimationLODInstance
+{
+protected:
+	Pose mFrom;
+	Pose mTo;
+	unsigned int mLevel;
+	unsigned int mPhase;
+	unsigned int mFramesSinceUpdate;
+	unsigned int mFramesBetweenSamples;
+	bool mHasSamples;
+public:
+	AnimationLODInstance();
+
+	void Reset();
+	unsigned int GetLevel() const;
+	// Offsets which frame the reduced rate updates land on, so characters sharing a level don't all sample on the same frame
+	void SetPhase(unsigned int phase);
+	// Writes the pose for playbackTime into outPose and returns how many transform tracks were sampled this frame.
+	// Between updates only the unmasked joints of outPose are written, so the same outPose should be passed every frame
+	unsigned int Update(const AnimationLOD& lod, unsigned int level, Clip& clip, const Pose& restPose, float playbackTime, float deltaTime, Pose& outPose);
+};
+
+// Updates a crowd after FrustumCuller::Cull, every vector is indexed like the culler's boxes. Visible
+// characters run their instance's Update. Culled ones skip sampling and keep their last pose, their
+// instance is Reset so it samples again on the first visible frame instead of blending from poses
+// that went stale while hidden. Returns how many transform tracks were sampled.
+unsigned int UpdateVisible(FrustumCuller& culler, std::vector<AnimationLODInstance>& instances, const AnimationLOD& lod, const std::vector<unsigned int>& levels,
+	Clip& clip, const Pose& restPose, const std::vector<float>& playbackTimes, float deltaTime, std::vector<Pose>& outPoses);
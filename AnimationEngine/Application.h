@@ -1,16 +1,26 @@
 #pragma once
 
+class FrameSnapshot;
+
 class Application
 {
 public: 
 	Application() {}
+	virtual ~Application() {}
 	virtual void Initialize() {}
 	virtual void Update(float DeltaTime) {}
+	// Called after the frame's Updates, copies what Render draws. With an UpdateThread both run on
+	// the update thread, which must not touch GL.
+	virtual void WriteSnapshot(FrameSnapshot& Snapshot) {}
+	// Called on the GL thread before Render with the newest snapshot, which stays valid until the next call
+	virtual void ReadSnapshot(const FrameSnapshot& Snapshot) {}
 	virtual void Render(float AspectRatio) {}
+	// Alpha is how far the frame lies between the last two fixed updates, 1 when every frame updates
+	// once. Applications that don't interpolate can keep overriding Render(AspectRatio).
+	virtual void Render(float AspectRatio, float Alpha) { Render(AspectRatio); }
 	virtual void Shutdown() {}
 
 private:
 	Application(const Application&);
 	Application& operator=(const Application&);
 };
-
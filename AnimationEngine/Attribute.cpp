@@ -2,26 +2,29 @@
 #include "vec2.h"
 #include "vec4.h"
 #include "vec3.h"
+#include "mat4.h"
+#include "VertexEncoding.h"
 #include <vector>
+#include <cstddef>
 #include "glad.h"
-
-template Attribute<int>; 
-template Attribute<float>; 
-template Attribute<vec2>; 
-template Attribute<vec3>; 
-template Attribute<vec4>; 
-template Attribute<ivec4>;
+#include "GLState.h"
 
 template<typename T> 
 Attribute<T>::Attribute() 
 { 
 	glGenBuffers(1, &mHandle); 
 	mCount = 0; 
+	mCapacity = 0;
+	mUsage = AttributeUsage::Static;
+	mSource = mHandle;
+	mOffset = 0;
+	mDivisor = 0;
 } 
 
 template<typename T> 
 Attribute<T>::~Attribute() 
 { 
+	GLState::OnDeleteBuffer(mHandle);
 	glDeleteBuffers(1, &mHandle); 
 }
 
@@ -37,15 +40,77 @@ unsigned int Attribute<T>::GetHandle()
 	return mHandle; 
 }
 
+template<typename T> 
+unsigned int Attribute<T>::Capacity() 
+{
+	return mCapacity; 
+}
+
+template<typename T> 
+void Attribute<T>::SetUsage(AttributeUsage usage) 
+{
+	mUsage = usage; 
+}
+
+template<typename T> 
+AttributeUsage Attribute<T>::GetUsage() 
+{
+	return mUsage; 
+}
+
+template<typename T> 
+void Attribute<T>::SetDivisor(unsigned int divisor) 
+{
+	mDivisor = divisor; 
+}
+
+template<typename T> 
+unsigned int Attribute<T>::GetDivisor() 
+{
+	return mDivisor; 
+}
+
 template<typename T> 
 void Attribute<T>::Set(T* inputArray, unsigned int arrayLength) 
 {
 	mCount = arrayLength; 
+	mSource = mHandle;
+	mOffset = 0;
 	
 	unsigned int size = sizeof(T); 
-	glBindBuffer(GL_ARRAY_BUFFER, mHandle);
-	glBufferData(GL_ARRAY_BUFFER, size * mCount, inputArray, GL_STREAM_DRAW); 
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	GLState::BindBuffer(GL_ARRAY_BUFFER, mHandle);
+
+	if (mUsage == AttributeUsage::Static)
+	{
+		glBufferData(GL_ARRAY_BUFFER, size * mCount, inputArray, GL_STATIC_DRAW); 
+		mCapacity = mCount;
+		return;
+	}
+
+	if (mCount > mCapacity)
+	{
+		// Grow with headroom so meshes that change size a little don't reallocate every frame
+		mCapacity = mCount + mCount / 2;
+		glBufferData(GL_ARRAY_BUFFER, size * mCapacity, 0, GL_DYNAMIC_DRAW);
+	}
+
+	glBufferSubData(GL_ARRAY_BUFFER, 0, size * mCount, inputArray);
+} 
+
+template<typename T> 
+void Attribute<T>::Set(StreamBuffer& stream, T* inputArray, unsigned int arrayLength) 
+{
+	unsigned int offset = 0;
+
+	if (!stream.Write(inputArray, sizeof(T) * arrayLength, offset))
+	{
+		Set(inputArray, arrayLength);
+		return;
+	}
+
+	mCount = arrayLength;
+	mSource = stream.GetHandle();
+	mOffset = offset;
 } 
 
 template<typename T> 
@@ -57,52 +122,140 @@ void Attribute<T>::Set(std::vector<T>& input)
 template<> 
 void Attribute<int>::SetAttribPointer(unsigned int s) 
 { 
-	glVertexAttribIPointer(s, 1, GL_INT, 0, (void*)0); 
+	glVertexAttribIPointer(s, 1, GL_INT, 0, (void*)(size_t)mOffset); 
 } 
 
 template<> 
 void Attribute<ivec4>::SetAttribPointer(unsigned int s) 
 { 
-	glVertexAttribIPointer(s, 4, GL_INT, 0, (void*)0); 
+	glVertexAttribIPointer(s, 4, GL_INT, 0, (void*)(size_t)mOffset); 
 } 
 
 template<> 
 void Attribute<float>::SetAttribPointer(unsigned int s) 
 { 
-	glVertexAttribPointer(s, 1, GL_FLOAT, GL_FALSE, 0, 0); 
+	glVertexAttribPointer(s, 1, GL_FLOAT, GL_FALSE, 0, (void*)(size_t)mOffset); 
 }
 
 template<> 
 void Attribute<vec2>::SetAttribPointer(unsigned int s) 
 { 
-	glVertexAttribPointer(s, 2, GL_FLOAT, GL_FALSE, 0, 0); 
+	glVertexAttribPointer(s, 2, GL_FLOAT, GL_FALSE, 0, (void*)(size_t)mOffset); 
 } 
 
 template<> 
 void Attribute<vec3>::SetAttribPointer(unsigned int s) 
 { 
-	glVertexAttribPointer(s, 3, GL_FLOAT, GL_FALSE, 0, 0); 
+	glVertexAttribPointer(s, 3, GL_FLOAT, GL_FALSE, 0, (void*)(size_t)mOffset); 
 } 
 
 template<>
 void Attribute<vec4>::SetAttribPointer(unsigned int s) 
 { 
-	glVertexAttribPointer(s, 4, GL_FLOAT, GL_FALSE, 0, 0); 
+	glVertexAttribPointer(s, 4, GL_FLOAT, GL_FALSE, 0, (void*)(size_t)mOffset); 
+}
+
+template<> 
+void Attribute<ubvec4>::SetAttribPointer(unsigned int s) 
+{ 
+	glVertexAttribIPointer(s, 4, GL_UNSIGNED_BYTE, 0, (void*)(size_t)mOffset); 
+}
+
+template<> 
+void Attribute<half2>::SetAttribPointer(unsigned int s) 
+{ 
+	glVertexAttribPointer(s, 2, GL_HALF_FLOAT, GL_FALSE, 0, (void*)(size_t)mOffset); 
+}
+
+template<> 
+void Attribute<half4>::SetAttribPointer(unsigned int s) 
+{ 
+	glVertexAttribPointer(s, 4, GL_HALF_FLOAT, GL_FALSE, 0, (void*)(size_t)mOffset); 
+}
+
+template<> 
+void Attribute<snorm16x2>::SetAttribPointer(unsigned int s) 
+{ 
+	glVertexAttribPointer(s, 2, GL_SHORT, GL_TRUE, 0, (void*)(size_t)mOffset); 
+}
+
+template<> 
+void Attribute<unorm8x4>::SetAttribPointer(unsigned int s) 
+{ 
+	glVertexAttribPointer(s, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, (void*)(size_t)mOffset); 
+}
+
+template<> 
+void Attribute<unorm16x4>::SetAttribPointer(unsigned int s) 
+{ 
+	glVertexAttribPointer(s, 4, GL_UNSIGNED_SHORT, GL_TRUE, 0, (void*)(size_t)mOffset); 
+}
+
+// Sets all four columns, slot is the first
+template<> 
+void Attribute<mat4>::SetAttribPointer(unsigned int s) 
+{ 
+	for (unsigned int i = 0; i < 4; ++i)
+	{
+		glVertexAttribPointer(s + i, 4, GL_FLOAT, GL_FALSE, sizeof(mat4), (void*)(size_t)(mOffset + sizeof(vec4) * i)); 
+	}
 }
 
 template<typename T> 
 void Attribute<T>::BindTo(unsigned int slot) 
 {
-	glBindBuffer(GL_ARRAY_BUFFER, mHandle); 
-	glEnableVertexAttribArray(slot);
-	SetAttribPointer(slot); 
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	if (GLState::BindVertexAttrib(slot, mSource, mOffset))
+	{
+		SetAttribPointer(slot);
+	}
+
+	GLState::VertexAttribDivisor(slot, mDivisor);
 } 
 
 template<typename T> 
 void Attribute<T>::UnBindFrom(unsigned int slot) 
 { 
-	glBindBuffer(GL_ARRAY_BUFFER, mHandle); 
-	glDisableVertexAttribArray(slot); 
-	glBindBuffer(GL_ARRAY_BUFFER, 0); 
+	GLState::ReleaseVertexAttrib(slot);
 }
+
+template<> 
+void Attribute<mat4>::BindTo(unsigned int slot) 
+{
+	bool changed = false;
+
+	for (unsigned int i = 0; i < 4; ++i)
+	{
+		// Every column has to be marked in use, so no short circuit
+		bool column = GLState::BindVertexAttrib(slot + i, mSource, mOffset + sizeof(vec4) * i);
+		changed = changed || column;
+		GLState::VertexAttribDivisor(slot + i, mDivisor);
+	}
+
+	if (changed)
+	{
+		SetAttribPointer(slot);
+	}
+} 
+
+template<> 
+void Attribute<mat4>::UnBindFrom(unsigned int slot) 
+{ 
+	for (unsigned int i = 0; i < 4; ++i)
+	{
+		GLState::ReleaseVertexAttrib(slot + i);
+	}
+}
+
+template class Attribute<int>;
+template class Attribute<float>;
+template class Attribute<vec2>;
+template class Attribute<vec3>;
+template class Attribute<vec4>;
+template class Attribute<mat4>;
+template class Attribute<ivec4>;
+template class Attribute<ubvec4>;
+template class Attribute<half2>;
+template class Attribute<half4>;
+template class Attribute<snorm16x2>;
+template class Attribute<unorm8x4>;
+template class Attribute<unorm16x4>;
@@ -1,12 +1,24 @@
 #pragma once
 
 #include <vector>
+#include "StreamBuffer.h"
+
+enum class AttributeUsage
+{
+	Static,		// Written once, every Set reallocates the storage
+	Dynamic		// Rewritten often, the storage is kept and updated in place, it only grows
+};
 
 template<typename T> class Attribute 
 {
 protected: 
 	unsigned int mHandle; 
 	unsigned int mCount; 
+	unsigned int mCapacity;
+	AttributeUsage mUsage;
+	unsigned int mSource; // Buffer the attribute reads from, mHandle unless it was streamed
+	unsigned int mOffset;
+	unsigned int mDivisor;
 private: 
 	Attribute(const Attribute& other);
 	Attribute& operator=(const Attribute& other);
@@ -17,6 +29,16 @@ public:
 	
 	void Set(T* inputArray, unsigned int arrayLength); 
 	void Set(std::vector<T>& input); 
+	// Writes into the stream's current segment, falls back to the attribute's own buffer if it is full.
+	// The offset changes every frame, so a VertexArray using this attribute has to set it again.
+	void Set(StreamBuffer& stream, T* inputArray, unsigned int arrayLength);
+	void SetUsage(AttributeUsage usage);
+	AttributeUsage GetUsage();
+	// 0 advances per vertex, n advances once every n instances. A mat4 takes the slot it is
+	// bound to and the three after it, one column each.
+	void SetDivisor(unsigned int divisor);
+	unsigned int GetDivisor();
+	unsigned int Capacity();
 	void BindTo(unsigned int slot); 
 	void UnBindFrom(unsigned int slot); 
 	unsigned int Count(); 
@@ -0,0 +1,143 @@
+#include "Bounds.h"
+#include "Clip.h"
+#include "Pose.h"
+#include "cgltf.h"
+#include <cmath>
+
+bool IsEmpty(const AABB& box)
+{
+	return box.mMin.x > box.mMax.x || box.mMin.y > box.mMax.y || box.mMin.z > box.mMax.z;
+}
+
+void Expand(AABB& box, const vec3& point)
+{
+	box.mMin.x = fminf(box.mMin.x, point.x);
+	box.mMin.y = fminf(box.mMin.y, point.y);
+	box.mMin.z = fminf(box.mMin.z, point.z);
+	box.mMax.x = fmaxf(box.mMax.x, point.x);
+	box.mMax.y = fmaxf(box.mMax.y, point.y);
+	box.mMax.z = fmaxf(box.mMax.z, point.z);
+}
+
+void Expand(AABB& box, const AABB& other)
+{
+	if (!IsEmpty(other))
+	{
+		Expand(box, other.mMin);
+		Expand(box, other.mMax);
+	}
+}
+
+void Pad(AABB& box, float amount)
+{
+	box.mMin = box.mMin - vec3(amount, amount, amount);
+	box.mMax = box.mMax + vec3(amount, amount, amount);
+}
+
+vec3 GetCenter(const AABB& box)
+{
+	return (box.mMin + box.mMax) * 0.5f;
+}
+
+vec3 GetExtents(const AABB& box)
+{
+	return (box.mMax - box.mMin) * 0.5f;
+}
+
+AABB TransformBounds(const AABB& box, const mat4& m)
+{
+	// Center moves with the matrix, extents grow by the absolute value of each basis vector
+	vec3 c = GetCenter(box);
+	vec3 e = GetExtents(box);
+
+	vec3 center(
+		m.xx * c.x + m.yx * c.y + m.zx * c.z + m.tx,
+		m.xy * c.x + m.yy * c.y + m.zy * c.z + m.ty,
+		m.xz * c.x + m.yz * c.y + m.zz * c.z + m.tz);
+	vec3 extents(
+		fabsf(m.xx) * e.x + fabsf(m.yx) * e.y + fabsf(m.zx) * e.z,
+		fabsf(m.xy) * e.x + fabsf(m.yy) * e.y + fabsf(m.zy) * e.z,
+		fabsf(m.xz) * e.x + fabsf(m.yz) * e.y + fabsf(m.zz) * e.z);
+
+	return AABB(center - extents, center + extents);
+}
+
+AABB ComputeBounds(const vec3* points, unsigned int count)
+{
+	AABB result;
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		Expand(result, points[i]);
+	}
+
+	return result;
+}
+
+AABB ComputeBounds(const std::vector<vec3>& points)
+{
+	return ComputeBounds(points.size() > 0 ? &points[0] : 0, (unsigned int)points.size());
+}
+
+AABB ComputeMeshBounds(const cgltf_mesh* mesh)
+{
+	AABB result;
+
+	for (cgltf_size p = 0; p < mesh->primitives_count; ++p)
+	{
+		const cgltf_primitive& primitive = mesh->primitives[p];
+
+		for (cgltf_size a = 0; a < primitive.attributes_count; ++a)
+		{
+			const cgltf_attribute& attribute = primitive.attributes[a];
+
+			if (attribute.type != cgltf_attribute_type_position)
+			{
+				continue;
+			}
+
+			const cgltf_accessor* accessor = attribute.data;
+
+			if (accessor->has_min && accessor->has_max)
+			{
+				Expand(result, vec3(accessor->min[0], accessor->min[1], accessor->min[2]));
+				Expand(result, vec3(accessor->max[0], accessor->max[1], accessor->max[2]));
+				continue;
+			}
+
+			for (cgltf_size i = 0; i < accessor->count; ++i)
+			{
+				float position[3] = { 0.0f, 0.0f, 0.0f };
+				cgltf_accessor_read_float(accessor, i, position, 3);
+				Expand(result, vec3(position[0], position[1], position[2]));
+			}
+		}
+	}
+
+	return result;
+}
+
+AABB ComputeClipBounds(Clip& clip, const Pose& restPose, float skinPadding, float sampleRate)
+{
+	AABB result;
+	Pose pose = restPose;
+	unsigned int numJoints = pose.Size();
+
+	float start = clip.GetStartTime();
+	float duration = clip.GetDuration();
+	unsigned int numSamples = (unsigned int)ceilf(duration * sampleRate) + 1;
+
+	for (unsigned int s = 0; s < numSamples; ++s)
+	{
+		float time = numSamples > 1 ? start + duration * (float)s / (float)(numSamples - 1) : start;
+		clip.Sample(pose, time);
+
+		for (unsigned int j = 0; j < numJoints; ++j)
+		{
+			Expand(result, pose.GetGlobalTransform(j).position);
+		}
+	}
+
+	Pad(result, skinPadding);
+	return result;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <vector>
+#include "vec3.h"
+#include "mat4.h"
+
+class Clip;
+class Pose;
+struct cgltf_mesh;
+
+// Axis aligned box. An empty box has mMin above mMax, merging anything into it replaces it.
+struct AABB
+{
+	vec3 mMin;
+	vec3 mMax;
+
+	inline AABB() : mMin(1e30f, 1e30f, 1e30f), mMax(-1e30f, -1e30f, -1e30f) { }
+	inline AABB(const vec3& min, const vec3& max) : mMin(min), mMax(max) { }
+};
+
+bool IsEmpty(const AABB& box);
+void Expand(AABB& box, const vec3& point);
+void Expand(AABB& box, const AABB& other);
+// Grows every side by amount
+void Pad(AABB& box, float amount);
+vec3 GetCenter(const AABB& box);
+vec3 GetExtents(const AABB& box);
+// Box around the transformed box, still axis aligned, so it can only grow
+AABB TransformBounds(const AABB& box, const mat4& m);
+
+AABB ComputeBounds(const vec3* points, unsigned int count);
+AABB ComputeBounds(const std::vector<vec3>& points);
+// Bounds of every POSITION accessor of the mesh's primitives, from the accessor min / max that
+// glTF requires, read from the data only if a file leaves them out
+AABB ComputeMeshBounds(const cgltf_mesh* mesh);
+// Model space bounds of a character playing the clip. Joint positions are sampled sampleRate times
+// a second over the whole clip and the box is padded by skinPadding, which has to cover how far
+// the skin reaches past its joints and how far joints move between two samples.
+AABB ComputeClipBounds(Clip& clip, const Pose& restPose, float skinPadding, float sampleRate = 30.0f);
@@ -0,0 +1,193 @@
+#include "Clip.h"
+#include <cmath>
+
+Clip::Clip()
+{
+	mName = "No name given";
+	mStartTime = 0.0f;
+	mEndTime = 0.0f;
+	mLooping = true;
+}
+
+unsigned int Clip::GetIdAtIndex(unsigned int index)
+{
+	return mTracks[index].GetId();
+}
+
+void Clip::SetIdAtIndex(unsigned int index, unsigned int id)
+{
+	mTracks[index].SetId(id);
+}
+
+unsigned int Clip::Size()
+{
+	return (unsigned int)mTracks.size();
+}
+
+float Clip::AdjustTimeToFitRange(float inTime)
+{
+	float duration = mEndTime - mStartTime;
+
+	if (duration <= 0.0f)
+	{
+		return 0.0f;
+	}
+
+	if (mLooping)
+	{
+		inTime = fmodf(inTime - mStartTime, duration);
+
+		if (inTime < 0.0f)
+		{
+			inTime += duration;
+		}
+
+		inTime = inTime + mStartTime;
+	}
+	else
+	{
+		if (inTime < mStartTime)
+		{
+			inTime = mStartTime;
+		}
+
+		if (inTime > mEndTime)
+		{
+			inTime = mEndTime;
+		}
+	}
+
+	return inTime;
+}
+
+float Clip::Sample(Pose& outPose, float inTime)
+{
+	if (GetDuration() == 0.0f)
+	{
+		return 0.0f;
+	}
+
+	inTime = AdjustTimeToFitRange(inTime);
+
+	unsigned int size = (unsigned int)mTracks.size();
+
+	for (unsigned int i = 0; i < size; ++i)
+	{
+		unsigned int joint = mTracks[i].GetId();
+		Transform local = outPose.GetLocalTransform(joint);
+		Transform animated = mTracks[i].Sample(local, inTime, mLooping);
+		outPose.SetLocalTransform(joint, animated);
+	}
+
+	return inTime;
+}
+
+float Clip::Sample(Pose& outPose, float inTime, const JointMask& mask)
+{
+	if (GetDuration() == 0.0f)
+	{
+		return 0.0f;
+	}
+
+	inTime = AdjustTimeToFitRange(inTime);
+
+	unsigned int size = (unsigned int)mTracks.size();
+
+	for (unsigned int i = 0; i < size; ++i)
+	{
+		unsigned int joint = mTracks[i].GetId();
+
+		if (joint < mask.size() && !mask[joint])
+		{
+			continue;
+		}
+
+		Transform local = outPose.GetLocalTransform(joint);
+		Transform animated = mTracks[i].Sample(local, inTime, mLooping);
+		outPose.SetLocalTransform(joint, animated);
+	}
+
+	return inTime;
+}
+
+TransformTrack& Clip::operator[](unsigned int joint)
+{
+	for (unsigned int i = 0, size = (unsigned int)mTracks.size(); i < size; ++i)
+	{
+		if (mTracks[i].GetId() == joint)
+		{
+			return mTracks[i];
+		}
+	}
+
+	mTracks.push_back(TransformTrack());
+	mTracks[mTracks.size() - 1].SetId(joint);
+
+	return mTracks[mTracks.size() - 1];
+}
+
+void Clip::RecalculateDuration()
+{
+	mStartTime = 0.0f;
+	mEndTime = 0.0f;
+	bool startSet = false;
+	bool endSet = false;
+
+	unsigned int tracksSize = (unsigned int)mTracks.size();
+
+	for (unsigned int i = 0; i < tracksSize; ++i)
+	{
+		if (mTracks[i].IsValid())
+		{
+			float startTime = mTracks[i].GetStartTime();
+			float endTime = mTracks[i].GetEndTime();
+
+			if (startTime < mStartTime || !startSet)
+			{
+				mStartTime = startTime;
+				startSet = true;
+			}
+
+			if (endTime > mEndTime || !endSet)
+			{
+				mEndTime = endTime;
+				endSet = true;
+			}
+		}
+	}
+}
+
+std::string& Clip::GetName()
+{
+	return mName;
+}
+
+void Clip::SetName(const std::string& inNewName)
+{
+	mName = inNewName;
+}
+
+float Clip::GetDuration()
+{
+	return mEndTime - mStartTime;
+}
+
+float Clip::GetStartTime()
+{
+	return mStartTime;
+}
+
+float Clip::GetEndTime()
+{
+	return mEndTime;
+}
+
+bool Clip::GetLooping()
+{
+	return mLooping;
+}
+
+void Clip::SetLooping(bool inLooping)
+{
+	mLooping = inLooping;
+}
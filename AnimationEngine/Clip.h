@@ -0,0 +1,36 @@
+#pragma once
+#include <vector>
+#include <string>
+#include "TransformTrack.h"
+#include "Pose.h"
+
+// One flag per joint of the pose, joints set to false are not sampled and keep the value already in the pose
+typedef std::vector<bool> JointMask;
+
+class Clip
+{
+protected:
+	std::vector<TransformTrack> mTracks;
+	std::string mName;
+	float mStartTime;
+	float mEndTime;
+	bool mLooping;
+protected:
+	float AdjustTimeToFitRange(float inTime);
+public:
+	Clip();
+	unsigned int GetIdAtIndex(unsigned int index);
+	void SetIdAtIndex(unsigned int index, unsigned int id);
+	unsigned int Size();
+	float Sample(Pose& outPose, float inTime);
+	float Sample(Pose& outPose, float inTime, const JointMask& mask);
+	TransformTrack& operator[](unsigned int joint);
+	void RecalculateDuration();
+	std::string& GetName();
+	void SetName(const std::string& inNewName);
+	float GetDuration();
+	float GetStartTime();
+	float GetEndTime();
+	bool GetLooping();
+	void SetLooping(bool inLooping);
+};
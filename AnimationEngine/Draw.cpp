@@ -1,5 +1,6 @@
 #include "Draw.h"
 #include "glad.h"
+#include "GLState.h"
 #include <iostream>
 
 static GLenum DrawModeToGLEnum(DrawMode input) 
@@ -32,14 +33,14 @@ void Draw(IndexBuffer& inIndexBuffer, DrawMode mode)
 	unsigned int handle = inIndexBuffer.GetHandle(); 
 	unsigned int numIndices = inIndexBuffer.Count(); 
 	
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, handle); 
-	glDrawElements(DrawModeToGLEnum(mode), numIndices, GL_UNSIGNED_INT, 0); 
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-
+	GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, handle); 
+	GLState::PrepareDraw();
+	glDrawElements(DrawModeToGLEnum(mode), numIndices, inIndexBuffer.GetIndexType(), 0); 
 }
 
 void Draw(unsigned int vertexCount, DrawMode mode)
 {
+	GLState::PrepareDraw();
 	glDrawArrays(DrawModeToGLEnum(mode), 0, vertexCount);
 }
 
@@ -48,12 +49,48 @@ void DrawInstanced(IndexBuffer& inIndexBuffer, DrawMode mode, unsigned int insta
 	unsigned int handle = inIndexBuffer.GetHandle(); 
 	unsigned int numIndices = inIndexBuffer.Count(); 
 	
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, handle); 
-	glDrawElementsInstanced(DrawModeToGLEnum(mode), numIndices, GL_UNSIGNED_INT, 0, instanceCount); 
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, handle); 
+	GLState::PrepareDraw();
+	glDrawElementsInstanced(DrawModeToGLEnum(mode), numIndices, inIndexBuffer.GetIndexType(), 0, instanceCount); 
 }
 
 void DrawInstanced(unsigned int vertexCount, DrawMode mode, unsigned int numInstances)
 {
+	GLState::PrepareDraw();
 	glDrawArraysInstanced(DrawModeToGLEnum(mode), 0, vertexCount, numInstances);
 }
+
+void Draw(VertexArray& vertexArray, DrawMode mode)
+{
+	vertexArray.Bind();
+	IndexBuffer* indexBuffer = vertexArray.GetIndexBuffer();
+
+	if (indexBuffer != 0)
+	{
+		Draw(*indexBuffer, mode);
+	}
+	else
+	{
+		Draw(vertexArray.GetVertexCount(), mode);
+	}
+}
+
+void DrawInstanced(VertexArray& vertexArray, DrawMode mode, unsigned int numInstances)
+{
+	vertexArray.Bind();
+	IndexBuffer* indexBuffer = vertexArray.GetIndexBuffer();
+
+	if (indexBuffer != 0)
+	{
+		DrawInstanced(*indexBuffer, mode, numInstances);
+	}
+	else
+	{
+		DrawInstanced(vertexArray.GetVertexCount(), mode, numInstances);
+	}
+}
+
+unsigned int DrawModeToGL(DrawMode mode)
+{
+	return DrawModeToGLEnum(mode);
+}
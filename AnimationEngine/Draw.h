@@ -1,5 +1,6 @@
 #pragma once
 #include "IndexBuffer.h"
+#include "VertexArray.h"
 
 enum class DrawMode 
 {
@@ -17,3 +18,10 @@ void Draw(unsigned int vertexCount, DrawMode mode);
 
 void DrawInstanced(IndexBuffer& inIndexBuffer, DrawMode mode, unsigned int instanceCount); 
 void DrawInstanced(unsigned int vertexCount, DrawMode mode, unsigned int numInstances);
+
+// Binds the vertex array and draws its index buffer, or all of its vertices if it has none
+void Draw(VertexArray& vertexArray, DrawMode mode);
+void DrawInstanced(VertexArray& vertexArray, DrawMode mode, unsigned int numInstances);
+
+// GL primitive enum of a mode, for code that issues its own draw calls
+unsigned int DrawModeToGL(DrawMode mode);
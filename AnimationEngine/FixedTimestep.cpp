@@ -0,0 +1,76 @@
+#include "FixedTimestep.h"
+#include <cmath>
+
+FixedTimestep::FixedTimestep(double step, unsigned int maxSteps)
+{
+	mStep = step;
+	mMaxSteps = maxSteps;
+	Reset();
+}
+
+unsigned int FixedTimestep::Advance(double frameSeconds)
+{
+	if (frameSeconds > 0.0)
+	{
+		mAccumulator += frameSeconds;
+	}
+
+	double due = floor(mAccumulator / mStep);
+
+	if (due > (double)mMaxSteps)
+	{
+		// Whole steps past the limit are dropped, the fraction of a step left over still carries
+		double excess = (due - (double)mMaxSteps) * mStep;
+		mAccumulator -= excess;
+		mDroppedSeconds += excess;
+		due = (double)mMaxSteps;
+	}
+
+	unsigned int steps = (unsigned int)due;
+	mAccumulator -= due * mStep;
+	mTotalSteps += steps;
+	return steps;
+}
+
+float FixedTimestep::GetAlpha() const
+{
+	float alpha = (float)(mAccumulator / mStep);
+	return alpha < 0.0f ? 0.0f : (alpha > 1.0f ? 1.0f : alpha);
+}
+
+void FixedTimestep::Reset()
+{
+	mAccumulator = 0.0;
+	mDroppedSeconds = 0.0;
+	mTotalSteps = 0;
+}
+
+void FixedTimestep::SetStep(double step)
+{
+	mStep = step;
+}
+
+double FixedTimestep::GetStep() const
+{
+	return mStep;
+}
+
+void FixedTimestep::SetMaxSteps(unsigned int maxSteps)
+{
+	mMaxSteps = maxSteps;
+}
+
+unsigned int FixedTimestep::GetMaxSteps() const
+{
+	return mMaxSteps;
+}
+
+double FixedTimestep::GetDroppedSeconds() const
+{
+	return mDroppedSeconds;
+}
+
+unsigned long long FixedTimestep::GetTotalSteps() const
+{
+	return mTotalSteps;
+}
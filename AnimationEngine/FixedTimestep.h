@@ -0,0 +1,32 @@
+#pragma once
+
+#define FIXED_TIMESTEP_DEFAULT_MAX_STEPS 5
+
+// Turns variable frame times into a whole number of fixed size updates. Advance adds the frame's
+// time and returns how many steps to run, the remainder carries over to the next frame. GetAlpha
+// is how far the remainder reaches into the next step, Render blends the last two updated states
+// with it. A frame that would need more than maxSteps updates drops the excess time instead of
+// falling further behind every frame.
+class FixedTimestep
+{
+protected:
+	double mStep;
+	double mAccumulator;
+	double mDroppedSeconds;
+	unsigned int mMaxSteps;
+	unsigned long long mTotalSteps;
+public:
+	FixedTimestep(double step = 1.0 / 60.0, unsigned int maxSteps = FIXED_TIMESTEP_DEFAULT_MAX_STEPS);
+
+	unsigned int Advance(double frameSeconds);
+	float GetAlpha() const;
+	void Reset();
+
+	void SetStep(double step);
+	double GetStep() const;
+	void SetMaxSteps(unsigned int maxSteps);
+	unsigned int GetMaxSteps() const;
+	// Simulated time given up to the step limit since the last Reset
+	double GetDroppedSeconds() const;
+	unsigned long long GetTotalSteps() const;
+};
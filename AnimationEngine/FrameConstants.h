@@ -0,0 +1,13 @@
+#pragma once
+
+#include "mat4.h"
+#include "vec4.h"
+
+// CPU side of the std140 FrameConstants block, keep the member order in sync with the shaders.
+// Uploaded once per frame and bound at UNIFORM_BINDING_FRAME_CONSTANTS.
+struct FrameConstants
+{
+	mat4 view;
+	mat4 projection;
+	vec4 light; // xyz is the light direction, w is unused
+};
@@ -0,0 +1,69 @@
+#include "FrameSnapshot.h"
+
+FrameSnapshot::FrameSnapshot()
+{
+	mUpdate = 0;
+	mTime = 0.0;
+	mAlpha = 1.0f;
+}
+
+void FrameSnapshot::Resize(unsigned int numCharacters)
+{
+	mModels.resize(numCharacters);
+	mPalettes.resize(numCharacters);
+}
+
+unsigned int FrameSnapshot::GetNumCharacters() const
+{
+	return (unsigned int)mModels.size();
+}
+
+mat4& FrameSnapshot::GetModel(unsigned int character)
+{
+	return mModels[character];
+}
+
+const mat4& FrameSnapshot::GetModel(unsigned int character) const
+{
+	return mModels[character];
+}
+
+std::vector<mat4>& FrameSnapshot::GetPalette(unsigned int character)
+{
+	return mPalettes[character];
+}
+
+const std::vector<mat4>& FrameSnapshot::GetPalette(unsigned int character) const
+{
+	return mPalettes[character];
+}
+
+void FrameSnapshot::SetUpdate(unsigned long long update)
+{
+	mUpdate = update;
+}
+
+unsigned long long FrameSnapshot::GetUpdate() const
+{
+	return mUpdate;
+}
+
+void FrameSnapshot::SetTime(double time)
+{
+	mTime = time;
+}
+
+double FrameSnapshot::GetTime() const
+{
+	return mTime;
+}
+
+void FrameSnapshot::SetAlpha(float alpha)
+{
+	mAlpha = alpha;
+}
+
+float FrameSnapshot::GetAlpha() const
+{
+	return mAlpha;
+}
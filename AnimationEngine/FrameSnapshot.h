@@ -0,0 +1,40 @@
+#pragma once
+#include <vector>
+#include "mat4.h"
+
+// Everything Render needs from one Update, written by the update thread and read by the GL thread.
+// Applications fill it in WriteSnapshot and draw from it after ReadSnapshot, never from state
+// the update thread keeps changing. Resize keeps the storage, so a steady crowd doesn't allocate.
+class FrameSnapshot
+{
+protected:
+	std::vector<mat4> mModels;
+	std::vector<std::vector<mat4> > mPalettes;
+	unsigned long long mUpdate;
+	double mTime;
+	float mAlpha;
+private:
+	FrameSnapshot(const FrameSnapshot&);
+	FrameSnapshot& operator=(const FrameSnapshot&);
+public:
+	FrameSnapshot();
+
+	void Resize(unsigned int numCharacters);
+	unsigned int GetNumCharacters() const;
+
+	mat4& GetModel(unsigned int character);
+	const mat4& GetModel(unsigned int character) const;
+	// Sized by whoever fills it, Pose::GetMatrixPalette writes straight into it
+	std::vector<mat4>& GetPalette(unsigned int character);
+	const std::vector<mat4>& GetPalette(unsigned int character) const;
+
+	// Number of the Update the snapshot was taken after, counting from 1
+	void SetUpdate(unsigned long long update);
+	unsigned long long GetUpdate() const;
+	// Simulated seconds since the first Update
+	void SetTime(double time);
+	double GetTime() const;
+	// See Application::Render
+	void SetAlpha(float alpha);
+	float GetAlpha() const;
+};
@@ -0,0 +1,138 @@
+#include "FrameStats.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+FrameStats::FrameStats()
+{
+	mCapacity = 0;
+	mNext = 0;
+}
+
+void FrameStats::Reserve(unsigned int numFrames)
+{
+	mSamples.reserve(numFrames);
+}
+
+void FrameStats::SetCapacity(unsigned int maxFrames)
+{
+	std::vector<double> samples;
+	samples.reserve(maxFrames);
+	mSamples.swap(samples);
+	mCapacity = maxFrames;
+	mNext = 0;
+}
+
+unsigned int FrameStats::GetCapacity() const
+{
+	return mCapacity;
+}
+
+void FrameStats::Clear()
+{
+	mSamples.clear();
+	mNext = 0;
+}
+
+void FrameStats::Add(double milliseconds)
+{
+	if (mCapacity == 0 || mSamples.size() < mCapacity)
+	{
+		mSamples.push_back(milliseconds);
+		return;
+	}
+
+	mSamples[mNext] = milliseconds;
+	mNext = mNext + 1 == mCapacity ? 0 : mNext + 1;
+}
+
+unsigned int FrameStats::Size() const
+{
+	return (unsigned int)mSamples.size();
+}
+
+const std::vector<double>& FrameStats::GetSamples() const
+{
+	return mSamples;
+}
+
+static double Percentile(const std::vector<double>& sorted, double percentile)
+{
+	unsigned int index = (unsigned int)(percentile * (double)(sorted.size() - 1) + 0.5);
+
+	return sorted[index];
+}
+
+FrameStatsSummary FrameStats::Summarize() const
+{
+	FrameStatsSummary result;
+	memset(&result, 0, sizeof(FrameStatsSummary));
+	result.mCount = (unsigned int)mSamples.size();
+
+	if (result.mCount == 0)
+	{
+		return result;
+	}
+
+	std::vector<double> sorted = mSamples;
+	std::sort(sorted.begin(), sorted.end());
+
+	double sum = 0.0;
+
+	for (unsigned int i = 0; i < result.mCount; ++i)
+	{
+		sum += sorted[i];
+	}
+
+	result.mMean = sum / (double)result.mCount;
+
+	double variance = 0.0;
+
+	for (unsigned int i = 0; i < result.mCount; ++i)
+	{
+		double delta = sorted[i] - result.mMean;
+		variance += delta * delta;
+	}
+
+	result.mStdDev = sqrt(variance / (double)result.mCount);
+	result.mMin = sorted[0];
+	result.mMax = sorted[result.mCount - 1];
+	result.mMedian = Percentile(sorted, 0.5);
+	result.mP95 = Percentile(sorted, 0.95);
+	result.mP99 = Percentile(sorted, 0.99);
+
+	return result;
+}
+
+void FrameStats::Print(const char* label) const
+{
+	FrameStatsSummary s = Summarize();
+
+	printf("%-8s frames %6u  mean %8.4f  min %8.4f  p50 %8.4f  p95 %8.4f  p99 %8.4f  max %8.4f  stddev %8.4f ms\n",
+		label, s.mCount, s.mMean, s.mMin, s.mMedian, s.mP95, s.mP99, s.mMax, s.mStdDev);
+}
+
+bool FrameStats::Write(const char* path) const
+{
+	std::ofstream file(path, std::ios::trunc);
+
+	if (!file.good())
+	{
+		printf("Could not write frame times to %s\n", path);
+		return false;
+	}
+
+	file << "frame,milliseconds\n" << std::fixed << std::setprecision(6);
+
+	// Oldest first, mNext is 0 until a capacity wrapped
+	for (unsigned int i = 0, size = (unsigned int)mSamples.size(); i < size; ++i)
+	{
+		unsigned int index = mNext + i < size ? mNext + i : mNext + i - size;
+		file << i << "," << mSamples[index] << "\n";
+	}
+
+	return file.good();
+}
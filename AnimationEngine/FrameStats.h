@@ -0,0 +1,41 @@
+#pragma once
+#include <vector>
+
+struct FrameStatsSummary
+{
+	unsigned int mCount;
+	double mMin;
+	double mMax;
+	double mMean;
+	double mStdDev;
+	double mMedian;
+	double mP95;
+	double mP99;
+};
+
+// Collects one timing per frame, in milliseconds, and summarizes them at the end of a run.
+// Unbounded by default, SetCapacity keeps only the newest frames for loops without an end.
+class FrameStats
+{
+protected:
+	std::vector<double> mSamples;
+	unsigned int mCapacity; // 0 keeps every sample
+	unsigned int mNext;     // Oldest sample once mSamples reached mCapacity, overwritten by the next Add
+public:
+	FrameStats();
+
+	void Reserve(unsigned int numFrames);
+	// Allocates room for maxFrames samples up front, after that Add replaces the oldest one.
+	// 0 makes it unbounded again. Clears the samples.
+	void SetCapacity(unsigned int maxFrames);
+	unsigned int GetCapacity() const;
+	void Clear();
+	void Add(double milliseconds);
+	unsigned int Size() const;
+	// Oldest first until a capacity is reached, after that they wrap around at the oldest sample
+	const std::vector<double>& GetSamples() const;
+	FrameStatsSummary Summarize() const;
+	void Print(const char* label) const;
+	// One sample per line, for plotting frame times outside the runner
+	bool Write(const char* path) const;
+};
@@ -0,0 +1,247 @@
+#include "Frustum.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define FRUSTUM_USE_SSE2 1
+#else
+#define FRUSTUM_USE_SSE2 0
+#endif
+
+static vec4 NormalizePlane(float x, float y, float z, float w)
+{
+	float length = sqrtf(x * x + y * y + z * z);
+
+	if (length < 1e-12f)
+	{
+		return vec4(x, y, z, w);
+	}
+
+	float inverse = 1.0f / length;
+	return vec4(x * inverse, y * inverse, z * inverse, w * inverse);
+}
+
+Frustum MakeFrustum(const mat4& m)
+{
+	// Rows of the column major matrix, each plane is the last row plus or minus another one
+	Frustum result;
+	result.mPlanes[0] = NormalizePlane(m.xw + m.xx, m.yw + m.yx, m.zw + m.zx, m.tw + m.tx);
+	result.mPlanes[1] = NormalizePlane(m.xw - m.xx, m.yw - m.yx, m.zw - m.zx, m.tw - m.tx);
+	result.mPlanes[2] = NormalizePlane(m.xw + m.xy, m.yw + m.yy, m.zw + m.zy, m.tw + m.ty);
+	result.mPlanes[3] = NormalizePlane(m.xw - m.xy, m.yw - m.yy, m.zw - m.zy, m.tw - m.ty);
+	result.mPlanes[4] = NormalizePlane(m.xw + m.xz, m.yw + m.yz, m.zw + m.zz, m.tw + m.tz);
+	result.mPlanes[5] = NormalizePlane(m.xw - m.xz, m.yw - m.yz, m.zw - m.zz, m.tw - m.tz);
+	return result;
+}
+
+Frustum MakeFrustum(const mat4& projection, const mat4& view)
+{
+	return MakeFrustum(projection * view);
+}
+
+bool Intersects(const Frustum& frustum, const AABB& box)
+{
+	vec3 c = GetCenter(box);
+	vec3 e = GetExtents(box);
+
+	for (unsigned int i = 0; i < 6; ++i)
+	{
+		const vec4& p = frustum.mPlanes[i];
+		float distance = p.x * c.x + p.y * c.y + p.z * c.z + p.w;
+		float radius = fabsf(p.x) * e.x + fabsf(p.y) * e.y + fabsf(p.z) * e.z;
+
+		if (distance + radius < 0.0f)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+FrustumCuller::FrustumCuller()
+{
+	mCount = 0;
+	mStats = FrustumCullerStats();
+}
+
+void FrustumCuller::Reserve(unsigned int numBoxes)
+{
+	unsigned int padded = (numBoxes + 3) & ~3u;
+	mCenterX.reserve(padded);
+	mCenterY.reserve(padded);
+	mCenterZ.reserve(padded);
+	mExtentX.reserve(padded);
+	mExtentY.reserve(padded);
+	mExtentZ.reserve(padded);
+	mVisible.reserve(numBoxes);
+	mVisibleFlags.reserve(numBoxes);
+}
+
+void FrustumCuller::Clear()
+{
+	mCenterX.clear();
+	mCenterY.clear();
+	mCenterZ.clear();
+	mExtentX.clear();
+	mExtentY.clear();
+	mExtentZ.clear();
+	mVisible.clear();
+	mVisibleFlags.clear();
+	mCount = 0;
+}
+
+unsigned int FrustumCuller::Add(const AABB& box)
+{
+	unsigned int index = mCount;
+	mCount += 1;
+
+	// Storage stays a multiple of four, the padding boxes are never reported
+	unsigned int padded = (mCount + 3) & ~3u;
+	mCenterX.resize(padded, 0.0f);
+	mCenterY.resize(padded, 0.0f);
+	mCenterZ.resize(padded, 0.0f);
+	mExtentX.resize(padded, 0.0f);
+	mExtentY.resize(padded, 0.0f);
+	mExtentZ.resize(padded, 0.0f);
+	mVisibleFlags.resize(padded, 0);
+
+	Set(index, box);
+	return index;
+}
+
+void FrustumCuller::Set(unsigned int index, const AABB& box)
+{
+	vec3 c = GetCenter(box);
+	vec3 e = GetExtents(box);
+	mCenterX[index] = c.x;
+	mCenterY[index] = c.y;
+	mCenterZ[index] = c.z;
+	mExtentX[index] = e.x;
+	mExtentY[index] = e.y;
+	mExtentZ[index] = e.z;
+}
+
+unsigned int FrustumCuller::Cull(const Frustum& frustum)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	// Written branch free, every box is stored and the count only advances past visible ones
+	mVisible.resize((mCount + 3) & ~3u);
+	unsigned int* visible = mVisible.size() > 0 ? &mVisible[0] : 0;
+	unsigned int numVisible = 0;
+	unsigned int i = 0;
+
+#if FRUSTUM_USE_SSE2
+	__m128 planeX[6];
+	__m128 planeY[6];
+	__m128 planeZ[6];
+	__m128 planeW[6];
+	__m128 absX[6];
+	__m128 absY[6];
+	__m128 absZ[6];
+
+	for (unsigned int p = 0; p < 6; ++p)
+	{
+		const vec4& plane = frustum.mPlanes[p];
+		planeX[p] = _mm_set1_ps(plane.x);
+		planeY[p] = _mm_set1_ps(plane.y);
+		planeZ[p] = _mm_set1_ps(plane.z);
+		planeW[p] = _mm_set1_ps(plane.w);
+		absX[p] = _mm_set1_ps(fabsf(plane.x));
+		absY[p] = _mm_set1_ps(fabsf(plane.y));
+		absZ[p] = _mm_set1_ps(fabsf(plane.z));
+	}
+
+	__m128 zero = _mm_setzero_ps();
+
+	for (; i < mCount; i += 4)
+	{
+		__m128 cx = _mm_loadu_ps(&mCenterX[i]);
+		__m128 cy = _mm_loadu_ps(&mCenterY[i]);
+		__m128 cz = _mm_loadu_ps(&mCenterZ[i]);
+		__m128 ex = _mm_loadu_ps(&mExtentX[i]);
+		__m128 ey = _mm_loadu_ps(&mExtentY[i]);
+		__m128 ez = _mm_loadu_ps(&mExtentZ[i]);
+		__m128 outside = zero;
+
+		for (unsigned int p = 0; p < 6; ++p)
+		{
+			__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planeX[p], cx), _mm_mul_ps(planeY[p], cy)), _mm_add_ps(_mm_mul_ps(planeZ[p], cz), planeW[p]));
+			__m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(absX[p], ex), _mm_mul_ps(absY[p], ey)), _mm_mul_ps(absZ[p], ez));
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+		}
+
+		unsigned int inside = ~(unsigned int)_mm_movemask_ps(outside);
+
+		for (unsigned int lane = 0; lane < 4; ++lane)
+		{
+			unsigned int flag = (inside >> lane) & 1;
+			mVisibleFlags[i + lane] = (unsigned char)flag;
+			visible[numVisible] = i + lane;
+			numVisible += flag;
+		}
+	}
+
+	// The padding boxes come last, drop any that passed
+	while (numVisible > 0 && visible[numVisible - 1] >= mCount)
+	{
+		numVisible -= 1;
+	}
+#endif
+
+	for (; i < mCount; ++i)
+	{
+		bool inside = true;
+
+		for (unsigned int p = 0; p < 6 && inside; ++p)
+		{
+			const vec4& plane = frustum.mPlanes[p];
+			float distance = plane.x * mCenterX[i] + plane.y * mCenterY[i] + plane.z * mCenterZ[i] + plane.w;
+			float radius = fabsf(plane.x) * mExtentX[i] + fabsf(plane.y) * mExtentY[i] + fabsf(plane.z) * mExtentZ[i];
+			inside = distance + radius >= 0.0f;
+		}
+
+		mVisibleFlags[i] = inside ? 1 : 0;
+
+		if (inside)
+		{
+			visible[numVisible++] = i;
+		}
+	}
+
+	mVisible.resize(numVisible);
+
+	mStats.mTested = mCount;
+	mStats.mVisible = (unsigned int)mVisible.size();
+	mStats.mMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	return mStats.mVisible;
+}
+
+const std::vector<unsigned int>& FrustumCuller::GetVisible()
+{
+	return mVisible;
+}
+
+bool FrustumCuller::IsVisible(unsigned int index)
+{
+	return mVisibleFlags[index] != 0;
+}
+
+unsigned int FrustumCuller::GetNumBoxes()
+{
+	return mCount;
+}
+
+const FrustumCullerStats& FrustumCuller::GetStats()
+{
+	return mStats;
+}
+
+void FrustumCuller::Print(const char* label)
+{
+	double perBox = mStats.mTested > 0 ? mStats.mMilliseconds * 1000000.0 / (double)mStats.mTested : 0.0;
+	printf("%-8s boxes %7u  visible %7u (%5.1f%%)  %.3f ms (%.2f ns per box)\n", label, mStats.mTested, mStats.mVisible,
+		mStats.mTested > 0 ? 100.0 * (double)mStats.mVisible / (double)mStats.mTested : 0.0, mStats.mMilliseconds, perBox);
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+#include "vec4.h"
+#include "mat4.h"
+#include "Bounds.h"
+
+// Six planes facing inwards as (normal, distance), a point p is inside a plane when
+// dot(normal, p) + distance >= 0. Order is left, right, bottom, top, near, far.
+struct Frustum
+{
+	vec4 mPlanes[6];
+};
+
+// Planes of a GL clip space (-w <= z <= w) view projection, normalized
+Frustum MakeFrustum(const mat4& viewProjection);
+Frustum MakeFrustum(const mat4& projection, const mat4& view);
+// Conservative, a box near a frustum corner can pass while outside
+bool Intersects(const Frustum& frustum, const AABB& box);
+
+struct FrustumCullerStats
+{
+	unsigned int mTested;
+	unsigned int mVisible;
+	double mMilliseconds;
+};
+
+// Tests many world space boxes against a frustum four at a time. Boxes are stored as centers and
+// extents in separate arrays per axis so four of them load straight into SSE registers. Boxes keep
+// the index Add returned until Clear, Cull lists the visible ones in ascending order.
+class FrustumCuller
+{
+protected:
+	std::vector<float> mCenterX;
+	std::vector<float> mCenterY;
+	std::vector<float> mCenterZ;
+	std::vector<float> mExtentX;
+	std::vector<float> mExtentY;
+	std::vector<float> mExtentZ;
+	std::vector<unsigned int> mVisible;
+	std::vector<unsigned char> mVisibleFlags;
+	unsigned int mCount;
+	FrustumCullerStats mStats;
+private:
+	FrustumCuller(const FrustumCuller&);
+	FrustumCuller& operator=(const FrustumCuller&);
+public:
+	FrustumCuller();
+
+	void Reserve(unsigned int numBoxes);
+	void Clear();
+	unsigned int Add(const AABB& box);
+	// Moving objects update their box every frame before Cull
+	void Set(unsigned int index, const AABB& box);
+	// Returns how many boxes are at least partly inside
+	unsigned int Cull(const Frustum& frustum);
+
+	const std::vector<unsigned int>& GetVisible();
+	// Result of the last Cull for one box
+	bool IsVisible(unsigned int index);
+	unsigned int GetNumBoxes();
+	const FrustumCullerStats& GetStats();
+	void Print(const char* label);
+};
@@ -0,0 +1,145 @@
+#include "GLExtensions.h"
+#include <iostream>
+
+PFNGLBUFFERSTORAGEPROC GLExtensions::BufferStorage = 0;
+PFNGLGETPROGRAMBINARYPROC GLExtensions::GetProgramBinary = 0;
+PFNGLPROGRAMBINARYPROC GLExtensions::ProgramBinary = 0;
+PFNGLPROGRAMPARAMETERIPROC GLExtensions::ProgramParameteri = 0;
+PFNGLMAXSHADERCOMPILERTHREADSKHRPROC GLExtensions::MaxShaderCompilerThreads = 0;
+PFNGLMULTIDRAWELEMENTSINDIRECTPROC GLExtensions::MultiDrawElementsIndirect = 0;
+
+static std::vector<std::string> sExtensions;
+static int sMajorVersion = 0;
+static int sMinorVersion = 0;
+
+void GLExtensions::Load(GLProcLoader loader)
+{
+	Reset();
+
+	glGetIntegerv(GL_MAJOR_VERSION, &sMajorVersion);
+	glGetIntegerv(GL_MINOR_VERSION, &sMinorVersion);
+
+	int numExtensions = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &numExtensions);
+
+	for (int i = 0; i < numExtensions; ++i)
+	{
+		const char* name = (const char*)glGetStringi(GL_EXTENSIONS, (GLuint)i);
+
+		if (name != 0)
+		{
+			sExtensions.push_back(name);
+		}
+	}
+
+	// Core and ARB versions share the same entry point names
+	if (HasVersion(4, 4) || HasExtension("GL_ARB_buffer_storage"))
+	{
+		BufferStorage = (PFNGLBUFFERSTORAGEPROC)loader("glBufferStorage");
+	}
+
+	if (HasVersion(4, 1) || HasExtension("GL_ARB_get_program_binary"))
+	{
+		int numFormats = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+
+		if (numFormats > 0)
+		{
+			GetProgramBinary = (PFNGLGETPROGRAMBINARYPROC)loader("glGetProgramBinary");
+			ProgramBinary = (PFNGLPROGRAMBINARYPROC)loader("glProgramBinary");
+			ProgramParameteri = (PFNGLPROGRAMPARAMETERIPROC)loader("glProgramParameteri");
+		}
+	}
+
+	// The KHR and ARB versions only differ in the suffix
+	if (HasExtension("GL_KHR_parallel_shader_compile"))
+	{
+		MaxShaderCompilerThreads = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)loader("glMaxShaderCompilerThreadsKHR");
+	}
+	else if (HasExtension("GL_ARB_parallel_shader_compile"))
+	{
+		MaxShaderCompilerThreads = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)loader("glMaxShaderCompilerThreadsARB");
+	}
+
+	if (MaxShaderCompilerThreads != 0)
+	{
+		// Let the driver pick as many threads as it wants
+		MaxShaderCompilerThreads(0xFFFFFFFF);
+	}
+
+	if (HasShaderStorageBuffer() && (HasVersion(4, 3) || HasExtension("GL_ARB_multi_draw_indirect")))
+	{
+		MultiDrawElementsIndirect = (PFNGLMULTIDRAWELEMENTSINDIRECTPROC)loader("glMultiDrawElementsIndirect");
+	}
+
+	std::cout << "Buffer storage " << (HasBufferStorage() ? "supported" : "not supported") << "\n";
+	std::cout << "Program binaries " << (HasProgramBinary() ? "supported" : "not supported") << "\n";
+	std::cout << "Parallel shader compile " << (HasParallelShaderCompile() ? "supported" : "not supported") << "\n";
+	std::cout << "Multi draw indirect " << (HasMultiDrawIndirect() ? "supported" : "not supported") << "\n";
+}
+
+void GLExtensions::Reset()
+{
+	BufferStorage = 0;
+	GetProgramBinary = 0;
+	ProgramBinary = 0;
+	ProgramParameteri = 0;
+	MaxShaderCompilerThreads = 0;
+	MultiDrawElementsIndirect = 0;
+	sExtensions.clear();
+	sMajorVersion = 0;
+	sMinorVersion = 0;
+}
+
+bool GLExtensions::HasExtension(const char* name)
+{
+	for (unsigned int i = 0, size = (unsigned int)sExtensions.size(); i < size; ++i)
+	{
+		if (sExtensions[i] == name)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool GLExtensions::HasVersion(int major, int minor)
+{
+	return sMajorVersion > major || (sMajorVersion == major && sMinorVersion >= minor);
+}
+
+bool GLExtensions::HasBufferStorage()
+{
+	return BufferStorage != 0;
+}
+
+bool GLExtensions::HasProgramBinary()
+{
+	return GetProgramBinary != 0 && ProgramBinary != 0 && ProgramParameteri != 0;
+}
+
+bool GLExtensions::HasParallelShaderCompile()
+{
+	return MaxShaderCompilerThreads != 0;
+}
+
+bool GLExtensions::HasS3TC()
+{
+	return HasExtension("GL_EXT_texture_compression_s3tc");
+}
+
+bool GLExtensions::HasBPTC()
+{
+	return HasVersion(4, 2) || HasExtension("GL_ARB_texture_compression_bptc");
+}
+
+bool GLExtensions::HasMultiDrawIndirect()
+{
+	return MultiDrawElementsIndirect != 0;
+}
+
+bool GLExtensions::HasShaderStorageBuffer()
+{
+	return HasVersion(4, 3) || HasExtension("GL_ARB_shader_storage_buffer_object");
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include "glad.h"
+#include <string>
+#include <vector>
+
+// glad was generated for the 3.3 core profile only, newer entry points are loaded here when the
+// driver has them. Every pointer stays null when the feature is missing, callers check Has*.
+
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT   0x0040
+#define GL_MAP_COHERENT_BIT     0x0080
+#define GL_DYNAMIC_STORAGE_BIT  0x0100
+#define GL_CLIENT_STORAGE_BIT   0x0200
+#endif
+
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#define GL_PROGRAM_BINARY_FORMATS 0x87FF
+#endif
+
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM
+#define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+#endif
+
+#ifndef GL_DRAW_INDIRECT_BUFFER
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#endif
+
+#ifndef GL_SHADER_STORAGE_BUFFER
+#define GL_SHADER_STORAGE_BUFFER 0x90D2
+#endif
+
+typedef void (APIENTRYP PFNGLBUFFERSTORAGEPROC)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+typedef void (APIENTRYP PFNGLGETPROGRAMBINARYPROC)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+typedef void (APIENTRYP PFNGLPROGRAMBINARYPROC)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+typedef void (APIENTRYP PFNGLPROGRAMPARAMETERIPROC)(GLuint program, GLenum pname, GLint value);
+typedef void (APIENTRYP PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)(GLuint count);
+typedef void (APIENTRYP PFNGLMULTIDRAWELEMENTSINDIRECTPROC)(GLenum mode, GLenum type, const void* indirect, GLsizei drawcount, GLsizei stride);
+
+typedef void* (*GLProcLoader)(const char* name);
+
+class GLExtensions
+{
+private:
+	GLExtensions();
+	GLExtensions(const GLExtensions&);
+	GLExtensions& operator=(const GLExtensions&);
+	~GLExtensions();
+public:
+	static PFNGLBUFFERSTORAGEPROC BufferStorage;
+	static PFNGLGETPROGRAMBINARYPROC GetProgramBinary;
+	static PFNGLPROGRAMBINARYPROC ProgramBinary;
+	static PFNGLPROGRAMPARAMETERIPROC ProgramParameteri;
+	static PFNGLMAXSHADERCOMPILERTHREADSKHRPROC MaxShaderCompilerThreads;
+	static PFNGLMULTIDRAWELEMENTSINDIRECTPROC MultiDrawElementsIndirect;
+
+	// Needs a current context and glad already loaded
+	static void Load(GLProcLoader loader);
+	static void Reset();
+
+	static bool HasExtension(const char* name);
+	static bool HasVersion(int major, int minor);
+	static bool HasBufferStorage();
+	// Also false when the driver offers no binary formats, some only expose the entry points
+	static bool HasProgramBinary();
+	// Compiles and links run on driver threads and GL_COMPLETION_STATUS_KHR can be polled
+	static bool HasParallelShaderCompile();
+	// Texture formats only, glCompressedTexImage2D itself is core
+	static bool HasS3TC();
+	static bool HasBPTC();
+	// Loaded only together with shader storage buffers, which indirect draws fetch their data from
+	static bool HasMultiDrawIndirect();
+	static bool HasShaderStorageBuffer();
+};
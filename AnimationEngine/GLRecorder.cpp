@@ -0,0 +1,1492 @@
+#include "GLRecorder.h"
+#include "glad.h"
+#include "GLState.h"
+#include "GLExtensions.h"
+#include <map>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+
+struct RecordedVariable
+{
+	std::string mName;
+	GLenum mType;
+	GLint mSize;
+	GLint mLocation;
+};
+
+struct RecordedShader
+{
+	GLenum mType;
+	std::string mSource;
+};
+
+struct RecordedProgram
+{
+	std::vector<GLuint> mShaders;
+	std::vector<RecordedVariable> mAttributes;
+	std::vector<RecordedVariable> mUniforms;
+	std::vector<RecordedVariable> mUniformBlocks; // mSize is the std140 data size in bytes
+};
+
+static GLBackend sBackend = GLBackend::Native;
+static bool sKeepLog = true;
+static std::vector<GLCommand> sCommands;
+static GLRecorderStats sStats;
+static std::vector<GLRecorderStats> sHistory;
+
+static GLuint sNextName = 1;
+static std::map<GLuint, RecordedShader> sShaders;
+static std::map<GLuint, RecordedProgram> sPrograms;
+
+// Shadowed bindings, only used to tell which binds were redundant
+static std::map<GLenum, GLuint> sBoundBuffers;
+static std::map<GLuint, GLuint> sElementBuffers; // Element array bindings are vertex array state
+static std::map<unsigned long long, unsigned long long> sIndexedBuffers; // Target and index to buffer and offset
+static std::map<unsigned long long, GLuint> sBoundTextures;
+static GLuint sBoundVertexArray = 0;
+static GLuint sBoundProgram = 0;
+static GLenum sActiveTexture = GL_TEXTURE0;
+
+// Mapped ranges point at scratch memory, the bytes are counted as uploaded on unmap
+static std::vector<unsigned char> sMappedScratch;
+static unsigned int sMappedBytes = 0;
+
+// Every function the engine calls, the recorder swaps all of them at once
+#define GL_RECORDED_FUNCTIONS(X) \
+	X(ActiveTexture, ACTIVETEXTURE) \
+	X(AttachShader, ATTACHSHADER) \
+	X(BindBuffer, BINDBUFFER) \
+	X(BindBufferBase, BINDBUFFERBASE) \
+	X(BindBufferRange, BINDBUFFERRANGE) \
+	X(BindTexture, BINDTEXTURE) \
+	X(BindVertexArray, BINDVERTEXARRAY) \
+	X(BufferData, BUFFERDATA) \
+	X(BufferSubData, BUFFERSUBDATA) \
+	X(Clear, CLEAR) \
+	X(ClearColor, CLEARCOLOR) \
+	X(ClientWaitSync, CLIENTWAITSYNC) \
+	X(CompileShader, COMPILESHADER) \
+	X(CompressedTexImage2D, COMPRESSEDTEXIMAGE2D) \
+	X(CreateProgram, CREATEPROGRAM) \
+	X(CreateShader, CREATESHADER) \
+	X(DeleteBuffers, DELETEBUFFERS) \
+	X(DeleteProgram, DELETEPROGRAM) \
+	X(DeleteShader, DELETESHADER) \
+	X(DetachShader, DETACHSHADER) \
+	X(DeleteSync, DELETESYNC) \
+	X(DeleteTextures, DELETETEXTURES) \
+	X(DeleteVertexArrays, DELETEVERTEXARRAYS) \
+	X(Disable, DISABLE) \
+	X(DisableVertexAttribArray, DISABLEVERTEXATTRIBARRAY) \
+	X(DrawArrays, DRAWARRAYS) \
+	X(DrawArraysInstanced, DRAWARRAYSINSTANCED) \
+	X(DrawElements, DRAWELEMENTS) \
+	X(DrawElementsBaseVertex, DRAWELEMENTSBASEVERTEX) \
+	X(DrawElementsInstanced, DRAWELEMENTSINSTANCED) \
+	X(Enable, ENABLE) \
+	X(EnableVertexAttribArray, ENABLEVERTEXATTRIBARRAY) \
+	X(FenceSync, FENCESYNC) \
+	X(Finish, FINISH) \
+	X(Flush, FLUSH) \
+	X(GenBuffers, GENBUFFERS) \
+	X(GenTextures, GENTEXTURES) \
+	X(GenVertexArrays, GENVERTEXARRAYS) \
+	X(GenerateMipmap, GENERATEMIPMAP) \
+	X(GetActiveAttrib, GETACTIVEATTRIB) \
+	X(GetActiveUniform, GETACTIVEUNIFORM) \
+	X(GetActiveUniformBlockName, GETACTIVEUNIFORMBLOCKNAME) \
+	X(GetActiveUniformBlockiv, GETACTIVEUNIFORMBLOCKIV) \
+	X(GetAttribLocation, GETATTRIBLOCATION) \
+	X(GetError, GETERROR) \
+	X(GetIntegerv, GETINTEGERV) \
+	X(GetProgramInfoLog, GETPROGRAMINFOLOG) \
+	X(GetProgramiv, GETPROGRAMIV) \
+	X(GetShaderInfoLog, GETSHADERINFOLOG) \
+	X(GetShaderiv, GETSHADERIV) \
+	X(GetString, GETSTRING) \
+	X(GetStringi, GETSTRINGI) \
+	X(GetUniformLocation, GETUNIFORMLOCATION) \
+	X(LinkProgram, LINKPROGRAM) \
+	X(MapBufferRange, MAPBUFFERRANGE) \
+	X(PixelStorei, PIXELSTOREI) \
+	X(PointSize, POINTSIZE) \
+	X(ShaderSource, SHADERSOURCE) \
+	X(TexImage2D, TEXIMAGE2D) \
+	X(TexImage3D, TEXIMAGE3D) \
+	X(TexParameteri, TEXPARAMETERI) \
+	X(TexSubImage2D, TEXSUBIMAGE2D) \
+	X(TexSubImage3D, TEXSUBIMAGE3D) \
+	X(UnmapBuffer, UNMAPBUFFER) \
+	X(Uniform1i, UNIFORM1I) \
+	X(Uniform1iv, UNIFORM1IV) \
+	X(Uniform2iv, UNIFORM2IV) \
+	X(Uniform4iv, UNIFORM4IV) \
+	X(Uniform1fv, UNIFORM1FV) \
+	X(Uniform2fv, UNIFORM2FV) \
+	X(Uniform3fv, UNIFORM3FV) \
+	X(Uniform4fv, UNIFORM4FV) \
+	X(UniformBlockBinding, UNIFORMBLOCKBINDING) \
+	X(UniformMatrix4fv, UNIFORMMATRIX4FV) \
+	X(UseProgram, USEPROGRAM) \
+	X(VertexAttribDivisor, VERTEXATTRIBDIVISOR) \
+	X(VertexAttribIPointer, VERTEXATTRIBIPOINTER) \
+	X(VertexAttribPointer, VERTEXATTRIBPOINTER) \
+	X(Viewport, VIEWPORT)
+
+#define GL_DECLARE_NATIVE(name, type) static PFNGL##type##PROC sNative##name = 0;
+GL_RECORDED_FUNCTIONS(GL_DECLARE_NATIVE)
+static PFNGLBUFFERSTORAGEPROC sNativeBufferStorage = 0;
+static PFNGLGETPROGRAMBINARYPROC sNativeGetProgramBinary = 0;
+static PFNGLPROGRAMBINARYPROC sNativeProgramBinary = 0;
+static PFNGLPROGRAMPARAMETERIPROC sNativeProgramParameteri = 0;
+static PFNGLMAXSHADERCOMPILERTHREADSKHRPROC sNativeMaxShaderCompilerThreads = 0;
+static PFNGLMULTIDRAWELEMENTSINDIRECTPROC sNativeMultiDrawElementsIndirect = 0;
+
+static void Record(GLCommandType type, const char* name, unsigned int target, unsigned int object, unsigned int bytes)
+{
+	sStats.mCalls += 1;
+
+	switch (type)
+	{
+	case GLCommandType::Bind:
+		sStats.mBinds += 1;
+		break;
+	case GLCommandType::Upload:
+		sStats.mUploads += 1;
+		sStats.mBytesUploaded += bytes;
+		break;
+	case GLCommandType::Draw:
+		sStats.mDraws += 1;
+		break;
+	case GLCommandType::Uniform:
+		sStats.mUniformSets += 1;
+		sStats.mUniformBytes += bytes;
+		break;
+	default:
+		break;
+	}
+
+	if (sKeepLog)
+	{
+		GLCommand command;
+		command.mType = type;
+		command.mName = name;
+		command.mTarget = target;
+		command.mObject = object;
+		command.mBytes = bytes;
+		sCommands.push_back(command);
+	}
+}
+
+static void RecordBind(const char* name, unsigned int target, GLuint& bound, GLuint object)
+{
+	if (bound == object)
+	{
+		sStats.mRedundantBinds += 1;
+	}
+
+	bound = object;
+	Record(GLCommandType::Bind, name, target, object, 0);
+}
+
+static unsigned long long TextureBindingKey(GLenum target)
+{
+	return ((unsigned long long)(sActiveTexture - GL_TEXTURE0) << 32) | (unsigned long long)target;
+}
+
+static unsigned int BytesPerPixel(GLenum format, GLenum type)
+{
+	unsigned int components = 4;
+
+	switch (format)
+	{
+	case GL_RED:
+	case GL_RED_INTEGER:
+	case GL_DEPTH_COMPONENT:
+		components = 1;
+		break;
+	case GL_RG:
+	case GL_RG_INTEGER:
+	case GL_DEPTH_STENCIL:
+		components = 2;
+		break;
+	case GL_RGB:
+	case GL_BGR:
+	case GL_RGB_INTEGER:
+		components = 3;
+		break;
+	default:
+		break;
+	}
+
+	switch (type)
+	{
+	case GL_UNSIGNED_SHORT:
+	case GL_SHORT:
+	case GL_HALF_FLOAT:
+		return components * 2;
+	case GL_UNSIGNED_INT:
+	case GL_INT:
+	case GL_FLOAT:
+		return components * 4;
+	default:
+		break;
+	}
+
+	return components;
+}
+
+static void ForgetDeleted(GLuint name)
+{
+	for (std::map<GLenum, GLuint>::iterator it = sBoundBuffers.begin(); it != sBoundBuffers.end(); ++it)
+	{
+		if (it->second == name)
+		{
+			it->second = 0;
+		}
+	}
+
+	for (std::map<GLuint, GLuint>::iterator it = sElementBuffers.begin(); it != sElementBuffers.end(); ++it)
+	{
+		if (it->second == name)
+		{
+			it->second = 0;
+		}
+	}
+
+	for (std::map<unsigned long long, unsigned long long>::iterator it = sIndexedBuffers.begin(); it != sIndexedBuffers.end(); ++it)
+	{
+		if ((GLuint)(it->second >> 32) == name)
+		{
+			it->second = 0;
+		}
+	}
+
+	for (std::map<unsigned long long, GLuint>::iterator it = sBoundTextures.begin(); it != sBoundTextures.end(); ++it)
+	{
+		if (it->second == name)
+		{
+			it->second = 0;
+		}
+	}
+}
+
+// GLSL scanning, just enough to find top level uniform and vertex input declarations
+
+static std::string StripCommentsAndDirectives(const std::string& source)
+{
+	std::string result;
+	result.reserve(source.size());
+
+	unsigned int size = (unsigned int)source.size();
+	bool lineStart = true;
+
+	for (unsigned int i = 0; i < size; ++i)
+	{
+		char c = source[i];
+
+		if (c == '/' && i + 1 < size && source[i + 1] == '/')
+		{
+			while (i < size && source[i] != '\n')
+			{
+				++i;
+			}
+			c = '\n';
+		}
+		else if (c == '/' && i + 1 < size && source[i + 1] == '*')
+		{
+			i += 2;
+			while (i + 1 < size && !(source[i] == '*' && source[i + 1] == '/'))
+			{
+				++i;
+			}
+			i += 1;
+			c = ' ';
+		}
+		else if (c == '#' && lineStart)
+		{
+			while (i < size && source[i] != '\n')
+			{
+				++i;
+			}
+			c = '\n';
+		}
+
+		if (c == '\n')
+		{
+			lineStart = true;
+		}
+		else if (c != ' ' && c != '\t' && c != '\r')
+		{
+			lineStart = false;
+		}
+
+		result += c;
+	}
+
+	return result;
+}
+
+static GLenum GLSLTypeToGLEnum(const std::string& type)
+{
+	static const struct { const char* mName; GLenum mType; } types[] =
+	{
+		{ "float", GL_FLOAT }, { "vec2", GL_FLOAT_VEC2 }, { "vec3", GL_FLOAT_VEC3 }, { "vec4", GL_FLOAT_VEC4 },
+		{ "int", GL_INT }, { "ivec2", GL_INT_VEC2 }, { "ivec3", GL_INT_VEC3 }, { "ivec4", GL_INT_VEC4 },
+		{ "uint", GL_UNSIGNED_INT }, { "uvec4", GL_UNSIGNED_INT_VEC4 }, { "bool", GL_BOOL },
+		{ "mat2", GL_FLOAT_MAT2 }, { "mat3", GL_FLOAT_MAT3 }, { "mat4", GL_FLOAT_MAT4 },
+		{ "sampler2D", GL_SAMPLER_2D }, { "sampler2DArray", GL_SAMPLER_2D_ARRAY }, { "samplerCube", GL_SAMPLER_CUBE }
+	};
+
+	for (unsigned int i = 0; i < sizeof(types) / sizeof(types[0]); ++i)
+	{
+		if (type == types[i].mName)
+		{
+			return types[i].mType;
+		}
+	}
+
+	return GL_FLOAT;
+}
+
+static GLint LocationsUsed(GLenum type, bool attribute)
+{
+	if (!attribute)
+	{
+		return 1;
+	}
+
+	if (type == GL_FLOAT_MAT4)
+	{
+		return 4;
+	}
+
+	if (type == GL_FLOAT_MAT3)
+	{
+		return 3;
+	}
+
+	if (type == GL_FLOAT_MAT2)
+	{
+		return 2;
+	}
+
+	return 1;
+}
+
+static void ParseStatement(std::string statement, bool attributes, std::vector<RecordedVariable>& out, GLint& nextLocation)
+{
+	// Drop layout(...) qualifiers
+	for (std::size_t layout = statement.find("layout"); layout != std::string::npos; layout = statement.find("layout"))
+	{
+		std::size_t close = statement.find(')', layout);
+
+		if (close == std::string::npos)
+		{
+			return;
+		}
+
+		statement.erase(layout, close - layout + 1);
+	}
+
+	std::vector<std::string> tokens;
+	std::string token;
+
+	for (unsigned int i = 0; i <= statement.size(); ++i)
+	{
+		char c = i < statement.size() ? statement[i] : ' ';
+
+		if (c == ' ' || c == '\t' || c == '\n' || c == '\r')
+		{
+			if (!token.empty())
+			{
+				tokens.push_back(token);
+				token.clear();
+			}
+		}
+		else
+		{
+			token += c;
+		}
+	}
+
+	unsigned int first = 0;
+	bool found = false;
+
+	for (; first < tokens.size(); ++first)
+	{
+		if ((!attributes && tokens[first] == "uniform") || (attributes && (tokens[first] == "in" || tokens[first] == "attribute")))
+		{
+			found = true;
+			break;
+		}
+	}
+
+	if (!found)
+	{
+		return;
+	}
+
+	unsigned int typeIndex = first + 1;
+
+	while (typeIndex < tokens.size() && (tokens[typeIndex] == "lowp" || tokens[typeIndex] == "mediump" || tokens[typeIndex] == "highp" || tokens[typeIndex] == "flat" || tokens[typeIndex] == "smooth"))
+	{
+		++typeIndex;
+	}
+
+	if (typeIndex + 1 >= tokens.size())
+	{
+		return;
+	}
+
+	GLenum type = GLSLTypeToGLEnum(tokens[typeIndex]);
+
+	std::string names;
+
+	for (unsigned int i = typeIndex + 1; i < tokens.size(); ++i)
+	{
+		names += tokens[i];
+	}
+
+	std::size_t start = 0;
+
+	while (start < names.size())
+	{
+		std::size_t comma = names.find(',', start);
+		std::string declaration = names.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+		start = comma == std::string::npos ? names.size() : comma + 1;
+
+		RecordedVariable variable;
+		variable.mType = type;
+		variable.mSize = 1;
+
+		std::size_t bracket = declaration.find('[');
+
+		if (bracket != std::string::npos)
+		{
+			variable.mSize = atoi(declaration.c_str() + bracket + 1);
+			declaration.erase(bracket);
+
+			if (variable.mSize < 1)
+			{
+				variable.mSize = 1;
+			}
+		}
+
+		variable.mName = declaration;
+
+		bool duplicate = false;
+
+		for (unsigned int i = 0; i < out.size(); ++i)
+		{
+			if (out[i].mName == variable.mName)
+			{
+				duplicate = true;
+			}
+		}
+
+		if (!duplicate && !variable.mName.empty())
+		{
+			variable.mLocation = nextLocation;
+			nextLocation += variable.mSize * LocationsUsed(type, attributes);
+			out.push_back(variable);
+		}
+	}
+}
+
+static void ParseDeclarations(const std::string& source, bool attributes, std::vector<RecordedVariable>& out, GLint& nextLocation)
+{
+	std::string code = StripCommentsAndDirectives(source);
+	std::string statement;
+	int depth = 0;
+
+	for (unsigned int i = 0; i < code.size(); ++i)
+	{
+		char c = code[i];
+
+		if (c == '{' || c == '}')
+		{
+			depth += c == '{' ? 1 : -1;
+			statement.clear();
+		}
+		else if (depth == 0 && c == ';')
+		{
+			ParseStatement(statement, attributes, out, nextLocation);
+			statement.clear();
+		}
+		else if (depth == 0)
+		{
+			statement += c;
+		}
+	}
+}
+
+// Size and alignment of a block member under std140, arrays round their element stride up to a vec4
+static void Std140Layout(const std::string& type, GLint count, GLint& outSize, GLint& outAlignment)
+{
+	GLint size = 4;
+	GLint alignment = 4;
+
+	if (type == "vec2" || type == "ivec2")
+	{
+		size = 8;
+		alignment = 8;
+	}
+	else if (type == "vec3" || type == "ivec3")
+	{
+		size = 12;
+		alignment = 16;
+	}
+	else if (type == "vec4" || type == "ivec4" || type == "uvec4")
+	{
+		size = 16;
+		alignment = 16;
+	}
+	else if (type == "mat4")
+	{
+		size = 64;
+		alignment = 16;
+	}
+	else if (type == "mat3")
+	{
+		size = 48;
+		alignment = 16;
+	}
+
+	if (count > 1)
+	{
+		GLint stride = (size + 15) & ~15;
+		size = stride * count;
+		alignment = 16;
+	}
+
+	outSize = size;
+	outAlignment = alignment;
+}
+
+static void ParseUniformBlocks(const std::string& source, std::vector<RecordedVariable>& out)
+{
+	std::string code = StripCommentsAndDirectives(source);
+	std::string statement;
+	RecordedVariable block;
+	bool inBlock = false;
+	int depth = 0;
+
+	for (unsigned int i = 0; i < code.size(); ++i)
+	{
+		char c = code[i];
+
+		if (c == '{' && depth == 0)
+		{
+			// uniform Name { starts a block, layout qualifiers and whitespace before it don't matter
+			std::size_t uniform = statement.find("uniform");
+			inBlock = uniform != std::string::npos;
+
+			if (inBlock)
+			{
+				std::string name;
+
+				for (std::size_t j = uniform + 7; j < statement.size(); ++j)
+				{
+					char n = statement[j];
+
+					if (n == ' ' || n == '\t' || n == '\n' || n == '\r')
+					{
+						if (!name.empty())
+						{
+							break;
+						}
+					}
+					else
+					{
+						name += n;
+					}
+				}
+
+				block.mName = name;
+				block.mType = 0;
+				block.mSize = 0;
+			}
+
+			depth += 1;
+			statement.clear();
+		}
+		else if (c == '{' || c == '}')
+		{
+			depth += c == '{' ? 1 : -1;
+
+			if (depth == 0 && inBlock)
+			{
+				block.mSize = (block.mSize + 15) & ~15;
+				block.mLocation = (GLint)out.size();
+				out.push_back(block);
+				inBlock = false;
+			}
+
+			statement.clear();
+		}
+		else if (c == ';' && depth == 1 && inBlock)
+		{
+			// Member declaration, "type name" or "type name[N]"
+			std::string type;
+			std::size_t j = 0;
+
+			while (j < statement.size() && (statement[j] == ' ' || statement[j] == '\t' || statement[j] == '\n' || statement[j] == '\r'))
+			{
+				++j;
+			}
+
+			while (j < statement.size() && statement[j] != ' ' && statement[j] != '\t' && statement[j] != '\n' && statement[j] != '\r')
+			{
+				type += statement[j++];
+			}
+
+			std::size_t bracket = statement.find('[', j);
+			GLint count = bracket == std::string::npos ? 1 : atoi(statement.c_str() + bracket + 1);
+			GLint size = 0;
+			GLint alignment = 0;
+			Std140Layout(type, count, size, alignment);
+
+			block.mSize = (block.mSize + alignment - 1) / alignment * alignment + size;
+			statement.clear();
+		}
+		else if (c == ';')
+		{
+			statement.clear();
+		}
+		else
+		{
+			statement += c;
+		}
+	}
+}
+
+static const RecordedVariable* FindVariable(const std::vector<RecordedVariable>& variables, const GLchar* name, GLint& element)
+{
+	std::string base = name;
+	element = 0;
+
+	std::size_t bracket = base.find('[');
+
+	if (bracket != std::string::npos)
+	{
+		element = atoi(base.c_str() + bracket + 1);
+		base.erase(bracket);
+	}
+
+	for (unsigned int i = 0; i < variables.size(); ++i)
+	{
+		if (variables[i].mName == base)
+		{
+			if (element < 0 || element >= variables[i].mSize)
+			{
+				return 0;
+			}
+
+			return &variables[i];
+		}
+	}
+
+	return 0;
+}
+
+static void CopyName(const std::string& name, GLsizei bufSize, GLsizei* length, GLchar* out)
+{
+	if (bufSize <= 0 || out == 0)
+	{
+		return;
+	}
+
+	GLsizei size = (GLsizei)name.size() < bufSize - 1 ? (GLsizei)name.size() : bufSize - 1;
+	memcpy(out, name.c_str(), size);
+	out[size] = '\0';
+
+	if (length != 0)
+	{
+		*length = size;
+	}
+}
+
+// Recording stubs
+
+static void APIENTRY RecordActiveTexture(GLenum texture)
+{
+	GLuint active = sActiveTexture;
+	RecordBind("glActiveTexture", 0, active, texture);
+	sActiveTexture = active;
+}
+
+static void APIENTRY RecordAttachShader(GLuint program, GLuint shader)
+{
+	sPrograms[program].mShaders.push_back(shader);
+	Record(GLCommandType::State, "glAttachShader", 0, program, 0);
+}
+
+static void APIENTRY RecordBindBuffer(GLenum target, GLuint buffer)
+{
+	if (target == GL_ELEMENT_ARRAY_BUFFER)
+	{
+		RecordBind("glBindBuffer", target, sElementBuffers[sBoundVertexArray], buffer);
+	}
+	else
+	{
+		RecordBind("glBindBuffer", target, sBoundBuffers[target], buffer);
+	}
+}
+
+static void APIENTRY RecordBindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+	unsigned long long& bound = sIndexedBuffers[((unsigned long long)target << 32) | index];
+	unsigned long long value = ((unsigned long long)buffer << 32) | (unsigned long long)(unsigned int)offset;
+
+	if (bound == value)
+	{
+		sStats.mRedundantBinds += 1;
+	}
+
+	bound = value;
+	sBoundBuffers[target] = buffer;
+	Record(GLCommandType::Bind, "glBindBufferRange", target, buffer, 0);
+}
+
+static void APIENTRY RecordBindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+	RecordBindBufferRange(target, index, buffer, 0, 0);
+}
+
+static void APIENTRY RecordBindTexture(GLenum target, GLuint texture)
+{
+	sStats.mTextureBinds += 1;
+	RecordBind("glBindTexture", target, sBoundTextures[TextureBindingKey(target)], texture);
+}
+
+static void APIENTRY RecordBindVertexArray(GLuint array)
+{
+	RecordBind("glBindVertexArray", 0, sBoundVertexArray, array);
+}
+
+static void APIENTRY RecordBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+{
+	Record(GLCommandType::Upload, "glBufferData", target, 0, data != 0 ? (unsigned int)size : 0);
+}
+
+static void APIENTRY RecordBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+{
+	Record(GLCommandType::Upload, "glBufferSubData", target, 0, (unsigned int)size);
+}
+
+static void APIENTRY RecordClear(GLbitfield mask)
+{
+	Record(GLCommandType::State, "glClear", mask, 0, 0);
+}
+
+static GLenum APIENTRY RecordClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout)
+{
+	Record(GLCommandType::State, "glClientWaitSync", 0, 0, 0);
+
+	return GL_ALREADY_SIGNALED;
+}
+
+static void APIENTRY RecordClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+{
+	Record(GLCommandType::State, "glClearColor", 0, 0, 0);
+}
+
+static void APIENTRY RecordCompileShader(GLuint shader)
+{
+	Record(GLCommandType::State, "glCompileShader", 0, shader, 0);
+}
+
+static void APIENTRY RecordCompressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const void* data)
+{
+	Record(GLCommandType::Upload, "glCompressedTexImage2D", target, 0, (unsigned int)imageSize);
+}
+
+static GLuint APIENTRY RecordCreateProgram(void)
+{
+	GLuint name = sNextName++;
+	sPrograms[name] = RecordedProgram();
+	Record(GLCommandType::Create, "glCreateProgram", 0, name, 0);
+
+	return name;
+}
+
+static GLuint APIENTRY RecordCreateShader(GLenum type)
+{
+	GLuint name = sNextName++;
+	sShaders[name].mType = type;
+	Record(GLCommandType::Create, "glCreateShader", type, name, 0);
+
+	return name;
+}
+
+static void APIENTRY RecordDeleteBuffers(GLsizei n, const GLuint* buffers)
+{
+	for (GLsizei i = 0; i < n; ++i)
+	{
+		ForgetDeleted(buffers[i]);
+	}
+
+	Record(GLCommandType::Delete, "glDeleteBuffers", 0, n > 0 ? buffers[0] : 0, 0);
+}
+
+static void APIENTRY RecordDeleteProgram(GLuint program)
+{
+	sPrograms.erase(program);
+	Record(GLCommandType::Delete, "glDeleteProgram", 0, program, 0);
+}
+
+static void APIENTRY RecordDeleteShader(GLuint shader)
+{
+	sShaders.erase(shader);
+	Record(GLCommandType::Delete, "glDeleteShader", 0, shader, 0);
+}
+
+static void APIENTRY RecordDetachShader(GLuint program, GLuint shader)
+{
+	std::vector<GLuint>& shaders = sPrograms[program].mShaders;
+
+	for (unsigned int i = 0; i < shaders.size(); ++i)
+	{
+		if (shaders[i] == shader)
+		{
+			shaders.erase(shaders.begin() + i);
+			break;
+		}
+	}
+
+	Record(GLCommandType::State, "glDetachShader", 0, program, 0);
+}
+
+static void APIENTRY RecordDeleteSync(GLsync sync)
+{
+	Record(GLCommandType::Delete, "glDeleteSync", 0, 0, 0);
+}
+
+static void APIENTRY RecordDeleteTextures(GLsizei n, const GLuint* textures)
+{
+	for (GLsizei i = 0; i < n; ++i)
+	{
+		ForgetDeleted(textures[i]);
+	}
+
+	Record(GLCommandType::Delete, "glDeleteTextures", 0, n > 0 ? textures[0] : 0, 0);
+}
+
+static void APIENTRY RecordDeleteVertexArrays(GLsizei n, const GLuint* arrays)
+{
+	for (GLsizei i = 0; i < n; ++i)
+	{
+		sElementBuffers.erase(arrays[i]);
+
+		if (sBoundVertexArray == arrays[i])
+		{
+			sBoundVertexArray = 0;
+		}
+	}
+
+	Record(GLCommandType::Delete, "glDeleteVertexArrays", 0, n > 0 ? arrays[0] : 0, 0);
+}
+
+static void APIENTRY RecordDisable(GLenum cap)
+{
+	Record(GLCommandType::State, "glDisable", cap, 0, 0);
+}
+
+static void APIENTRY RecordDisableVertexAttribArray(GLuint index)
+{
+	Record(GLCommandType::State, "glDisableVertexAttribArray", 0, index, 0);
+}
+
+static void APIENTRY RecordDrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+	Record(GLCommandType::Draw, "glDrawArrays", mode, 0, (unsigned int)count);
+}
+
+static void APIENTRY RecordDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instancecount)
+{
+	Record(GLCommandType::Draw, "glDrawArraysInstanced", mode, (unsigned int)instancecount, (unsigned int)count);
+}
+
+static void APIENTRY RecordDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+{
+	Record(GLCommandType::Draw, "glDrawElements", mode, sElementBuffers[sBoundVertexArray], (unsigned int)count);
+}
+
+static void APIENTRY RecordDrawElementsBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* indices, GLint basevertex)
+{
+	Record(GLCommandType::Draw, "glDrawElementsBaseVertex", mode, sElementBuffers[sBoundVertexArray], (unsigned int)count);
+}
+
+static void APIENTRY RecordDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instancecount)
+{
+	Record(GLCommandType::Draw, "glDrawElementsInstanced", mode, (unsigned int)instancecount, (unsigned int)count);
+}
+
+static void APIENTRY RecordEnable(GLenum cap)
+{
+	Record(GLCommandType::State, "glEnable", cap, 0, 0);
+}
+
+static void APIENTRY RecordEnableVertexAttribArray(GLuint index)
+{
+	Record(GLCommandType::State, "glEnableVertexAttribArray", 0, index, 0);
+}
+
+static GLsync APIENTRY RecordFenceSync(GLenum condition, GLbitfield flags)
+{
+	Record(GLCommandType::Create, "glFenceSync", condition, 0, 0);
+
+	return (GLsync)(size_t)(sNextName++);
+}
+
+static void APIENTRY RecordFinish(void)
+{
+	Record(GLCommandType::State, "glFinish", 0, 0, 0);
+}
+
+static void APIENTRY RecordFlush(void)
+{
+	Record(GLCommandType::State, "glFlush", 0, 0, 0);
+}
+
+static void GenerateNames(const char* function, GLsizei n, GLuint* out)
+{
+	for (GLsizei i = 0; i < n; ++i)
+	{
+		out[i] = sNextName++;
+	}
+
+	Record(GLCommandType::Create, function, 0, n > 0 ? out[0] : 0, 0);
+}
+
+static void APIENTRY RecordGenBuffers(GLsizei n, GLuint* buffers)
+{
+	GenerateNames("glGenBuffers", n, buffers);
+}
+
+static void APIENTRY RecordGenTextures(GLsizei n, GLuint* textures)
+{
+	GenerateNames("glGenTextures", n, textures);
+}
+
+static void APIENTRY RecordGenVertexArrays(GLsizei n, GLuint* arrays)
+{
+	GenerateNames("glGenVertexArrays", n, arrays);
+}
+
+static void APIENTRY RecordGenerateMipmap(GLenum target)
+{
+	Record(GLCommandType::State, "glGenerateMipmap", target, 0, 0);
+}
+
+static void APIENTRY RecordGetActiveAttrib(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+{
+	Record(GLCommandType::Query, "glGetActiveAttrib", 0, program, 0);
+	std::vector<RecordedVariable>& attributes = sPrograms[program].mAttributes;
+
+	if (index < attributes.size())
+	{
+		CopyName(attributes[index].mName, bufSize, length, name);
+		*size = attributes[index].mSize;
+		*type = attributes[index].mType;
+	}
+}
+
+static void APIENTRY RecordGetActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+{
+	Record(GLCommandType::Query, "glGetActiveUniform", 0, program, 0);
+	std::vector<RecordedVariable>& uniforms = sPrograms[program].mUniforms;
+
+	if (index < uniforms.size())
+	{
+		// Drivers report arrays as name[0]
+		CopyName(uniforms[index].mSize > 1 ? uniforms[index].mName + "[0]" : uniforms[index].mName, bufSize, length, name);
+		*size = uniforms[index].mSize;
+		*type = uniforms[index].mType;
+	}
+}
+
+static void APIENTRY RecordGetActiveUniformBlockName(GLuint program, GLuint uniformBlockIndex, GLsizei bufSize, GLsizei* length, GLchar* uniformBlockName)
+{
+	Record(GLCommandType::Query, "glGetActiveUniformBlockName", 0, program, 0);
+	std::vector<RecordedVariable>& blocks = sPrograms[program].mUniformBlocks;
+
+	if (uniformBlockIndex < blocks.size())
+	{
+		CopyName(blocks[uniformBlockIndex].mName, bufSize, length, uniformBlockName);
+	}
+}
+
+static void APIENTRY RecordGetActiveUniformBlockiv(GLuint program, GLuint uniformBlockIndex, GLenum pname, GLint* params)
+{
+	Record(GLCommandType::Query, "glGetActiveUniformBlockiv", pname, program, 0);
+	std::vector<RecordedVariable>& blocks = sPrograms[program].mUniformBlocks;
+
+	if (uniformBlockIndex < blocks.size() && pname == GL_UNIFORM_BLOCK_DATA_SIZE)
+	{
+		*params = blocks[uniformBlockIndex].mSize;
+	}
+	else
+	{
+		*params = 0;
+	}
+}
+
+static GLint APIENTRY RecordGetAttribLocation(GLuint program, const GLchar* name)
+{
+	Record(GLCommandType::Query, "glGetAttribLocation", 0, program, 0);
+	GLint element = 0;
+	const RecordedVariable* variable = FindVariable(sPrograms[program].mAttributes, name, element);
+
+	return variable == 0 ? -1 : variable->mLocation + element;
+}
+
+static GLenum APIENTRY RecordGetError(void)
+{
+	Record(GLCommandType::Query, "glGetError", 0, 0, 0);
+
+	return GL_NO_ERROR;
+}
+
+static void APIENTRY RecordGetIntegerv(GLenum pname, GLint* data)
+{
+	Record(GLCommandType::Query, "glGetIntegerv", pname, 0, 0);
+
+	switch (pname)
+	{
+	case GL_MAJOR_VERSION:
+		*data = 3;
+		break;
+	case GL_MINOR_VERSION:
+		*data = 3;
+		break;
+	case GL_MAX_TEXTURE_SIZE:
+		*data = 16384;
+		break;
+	case GL_MAX_VERTEX_ATTRIBS:
+		*data = 16;
+		break;
+	case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS:
+		*data = 32;
+		break;
+	case GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT:
+		*data = 256;
+		break;
+	case GL_MAX_UNIFORM_BLOCK_SIZE:
+		*data = 65536;
+		break;
+	default:
+		*data = 0;
+		break;
+	}
+}
+
+static void APIENTRY RecordGetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+{
+	Record(GLCommandType::Query, "glGetProgramInfoLog", 0, program, 0);
+	CopyName("", bufSize, length, infoLog);
+}
+
+static void APIENTRY RecordGetProgramiv(GLuint program, GLenum pname, GLint* params)
+{
+	Record(GLCommandType::Query, "glGetProgramiv", pname, program, 0);
+	RecordedProgram& recorded = sPrograms[program];
+
+	switch (pname)
+	{
+	case GL_LINK_STATUS:
+	case GL_VALIDATE_STATUS:
+		*params = GL_TRUE;
+		break;
+	case GL_ACTIVE_ATTRIBUTES:
+		*params = (GLint)recorded.mAttributes.size();
+		break;
+	case GL_ACTIVE_UNIFORMS:
+		*params = (GLint)recorded.mUniforms.size();
+		break;
+	case GL_ACTIVE_UNIFORM_BLOCKS:
+		*params = (GLint)recorded.mUniformBlocks.size();
+		break;
+	case GL_ACTIVE_ATTRIBUTE_MAX_LENGTH:
+	case GL_ACTIVE_UNIFORM_MAX_LENGTH:
+		*params = 128;
+		break;
+	default:
+		*params = 0;
+		break;
+	}
+}
+
+static void APIENTRY RecordGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+{
+	Record(GLCommandType::Query, "glGetShaderInfoLog", 0, shader, 0);
+	CopyName("", bufSize, length, infoLog);
+}
+
+static void APIENTRY RecordGetShaderiv(GLuint shader, GLenum pname, GLint* params)
+{
+	Record(GLCommandType::Query, "glGetShaderiv", pname, shader, 0);
+	*params = pname == GL_COMPILE_STATUS ? GL_TRUE : 0;
+}
+
+static const GLubyte* APIENTRY RecordGetString(GLenum name)
+{
+	Record(GLCommandType::Query, "glGetString", name, 0, 0);
+
+	switch (name)
+	{
+	case GL_VENDOR:
+		return (const GLubyte*)"AnimationEngine";
+	case GL_RENDERER:
+		return (const GLubyte*)"GLRecorder";
+	case GL_VERSION:
+		return (const GLubyte*)"3.3 Recording";
+	case GL_SHADING_LANGUAGE_VERSION:
+		return (const GLubyte*)"3.30";
+	default:
+		break;
+	}
+
+	return (const GLubyte*)"";
+}
+
+static const GLubyte* APIENTRY RecordGetStringi(GLenum name, GLuint index)
+{
+	Record(GLCommandType::Query, "glGetStringi", name, index, 0);
+
+	return (const GLubyte*)"";
+}
+
+static GLint APIENTRY RecordGetUniformLocation(GLuint program, const GLchar* name)
+{
+	Record(GLCommandType::Query, "glGetUniformLocation", 0, program, 0);
+	GLint element = 0;
+	const RecordedVariable* variable = FindVariable(sPrograms[program].mUniforms, name, element);
+
+	return variable == 0 ? -1 : variable->mLocation + element;
+}
+
+static void APIENTRY RecordLinkProgram(GLuint program)
+{
+	Record(GLCommandType::State, "glLinkProgram", 0, program, 0);
+
+	RecordedProgram& recorded = sPrograms[program];
+	recorded.mAttributes.clear();
+	recorded.mUniforms.clear();
+	recorded.mUniformBlocks.clear();
+
+	GLint nextAttribute = 0;
+	GLint nextUniform = 0;
+
+	for (unsigned int i = 0; i < recorded.mShaders.size(); ++i)
+	{
+		std::map<GLuint, RecordedShader>::iterator shader = sShaders.find(recorded.mShaders[i]);
+
+		if (shader == sShaders.end())
+		{
+			continue;
+		}
+
+		if (shader->second.mType == GL_VERTEX_SHADER)
+		{
+			ParseDeclarations(shader->second.mSource, true, recorded.mAttributes, nextAttribute);
+		}
+
+		ParseDeclarations(shader->second.mSource, false, recorded.mUniforms, nextUniform);
+
+		// Blocks declared in several stages are one block
+		std::vector<RecordedVariable> blocks;
+		ParseUniformBlocks(shader->second.mSource, blocks);
+
+		for (unsigned int j = 0; j < blocks.size(); ++j)
+		{
+			bool duplicate = false;
+
+			for (unsigned int k = 0; k < recorded.mUniformBlocks.size(); ++k)
+			{
+				duplicate = duplicate || recorded.mUniformBlocks[k].mName == blocks[j].mName;
+			}
+
+			if (!duplicate)
+			{
+				blocks[j].mLocation = (GLint)recorded.mUniformBlocks.size();
+				recorded.mUniformBlocks.push_back(blocks[j]);
+			}
+		}
+	}
+}
+
+static void* APIENTRY RecordMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+{
+	Record(GLCommandType::State, "glMapBufferRange", target, 0, 0);
+
+	if (sMappedScratch.size() < (size_t)length)
+	{
+		sMappedScratch.resize((size_t)length);
+	}
+
+	sMappedBytes = (access & GL_MAP_WRITE_BIT) ? (unsigned int)length : 0;
+
+	return sMappedScratch.empty() ? 0 : &sMappedScratch[0];
+}
+
+static void APIENTRY RecordPixelStorei(GLenum pname, GLint param)
+{
+	Record(GLCommandType::State, "glPixelStorei", pname, 0, 0);
+}
+
+static void APIENTRY RecordPointSize(GLfloat size)
+{
+	Record(GLCommandType::State, "glPointSize", 0, 0, 0);
+}
+
+static void APIENTRY RecordShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length)
+{
+	std::string& source = sShaders[shader].mSource;
+	source.clear();
+
+	for (GLsizei i = 0; i < count; ++i)
+	{
+		if (length != 0 && length[i] >= 0)
+		{
+			source.append(string[i], length[i]);
+		}
+		else
+		{
+			source.append(string[i]);
+		}
+	}
+
+	Record(GLCommandType::State, "glShaderSource", 0, shader, 0);
+}
+
+static void APIENTRY RecordTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels)
+{
+	unsigned int bytes = pixels != 0 ? (unsigned int)width * (unsigned int)height * BytesPerPixel(format, type) : 0;
+	Record(GLCommandType::Upload, "glTexImage2D", target, 0, bytes);
+}
+
+static void APIENTRY RecordTexImage3D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLsizei depth, GLint border, GLenum format, GLenum type, const void* pixels)
+{
+	unsigned int bytes = pixels != 0 ? (unsigned int)width * (unsigned int)height * (unsigned int)depth * BytesPerPixel(format, type) : 0;
+	Record(GLCommandType::Upload, "glTexImage3D", target, 0, bytes);
+}
+
+static void APIENTRY RecordTexParameteri(GLenum target, GLenum pname, GLint param)
+{
+	Record(GLCommandType::State, "glTexParameteri", target, 0, 0);
+}
+
+static void APIENTRY RecordTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels)
+{
+	Record(GLCommandType::Upload, "glTexSubImage2D", target, 0, (unsigned int)width * (unsigned int)height * BytesPerPixel(format, type));
+}
+
+static void APIENTRY RecordTexSubImage3D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const void* pixels)
+{
+	Record(GLCommandType::Upload, "glTexSubImage3D", target, 0, (unsigned int)width * (unsigned int)height * (unsigned int)depth * BytesPerPixel(format, type));
+}
+
+static void APIENTRY RecordUniform1i(GLint location, GLint v0)
+{
+	Record(GLCommandType::Uniform, "glUniform1i", 0, (unsigned int)location, sizeof(GLint));
+}
+
+#define GL_RECORD_UNIFORM(name, type, components) \
+static void APIENTRY Record##name(GLint location, GLsizei count, const type* value) { \
+	Record(GLCommandType::Uniform, "gl" #name, 0, (unsigned int)location, (unsigned int)(count * components * sizeof(type))); \
+}
+
+GL_RECORD_UNIFORM(Uniform1iv, GLint, 1)
+GL_RECORD_UNIFORM(Uniform2iv, GLint, 2)
+GL_RECORD_UNIFORM(Uniform4iv, GLint, 4)
+GL_RECORD_UNIFORM(Uniform1fv, GLfloat, 1)
+GL_RECORD_UNIFORM(Uniform2fv, GLfloat, 2)
+GL_RECORD_UNIFORM(Uniform3fv, GLfloat, 3)
+GL_RECORD_UNIFORM(Uniform4fv, GLfloat, 4)
+
+static void APIENTRY RecordUniformBlockBinding(GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding)
+{
+	Record(GLCommandType::State, "glUniformBlockBinding", uniformBlockBinding, program, 0);
+}
+
+static void APIENTRY RecordUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+	Record(GLCommandType::Uniform, "glUniformMatrix4fv", 0, (unsigned int)location, (unsigned int)(count * 16 * sizeof(GLfloat)));
+}
+
+static GLboolean APIENTRY RecordUnmapBuffer(GLenum target)
+{
+	Record(GLCommandType::Upload, "glUnmapBuffer", target, 0, sMappedBytes);
+	sMappedBytes = 0;
+
+	return GL_TRUE;
+}
+
+static void APIENTRY RecordUseProgram(GLuint program)
+{
+	RecordBind("glUseProgram", 0, sBoundProgram, program);
+}
+
+static void APIENTRY RecordVertexAttribDivisor(GLuint index, GLuint divisor)
+{
+	Record(GLCommandType::State, "glVertexAttribDivisor", 0, index, 0);
+}
+
+static void APIENTRY RecordVertexAttribIPointer(GLuint index, GLint size, GLenum type, GLsizei stride, const void* pointer)
+{
+	Record(GLCommandType::State, "glVertexAttribIPointer", 0, index, 0);
+}
+
+static void APIENTRY RecordVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer)
+{
+	Record(GLCommandType::State, "glVertexAttribPointer", 0, index, 0);
+}
+
+static void APIENTRY RecordViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+	Record(GLCommandType::State, "glViewport", 0, 0, 0);
+}
+
+// GLRecorder
+
+void GLRecorder::SetBackend(GLBackend backend)
+{
+	if (backend == sBackend)
+	{
+		return;
+	}
+
+	if (backend == GLBackend::Recording)
+	{
+#define GL_SWAP_TO_RECORDING(name, type) sNative##name = glad_gl##name; glad_gl##name = Record##name;
+		GL_RECORDED_FUNCTIONS(GL_SWAP_TO_RECORDING)
+#undef GL_SWAP_TO_RECORDING
+
+		// Extensions are reported missing while recording, so callers take their 3.3 paths
+		sNativeBufferStorage = GLExtensions::BufferStorage;
+		sNativeGetProgramBinary = GLExtensions::GetProgramBinary;
+		sNativeProgramBinary = GLExtensions::ProgramBinary;
+		sNativeProgramParameteri = GLExtensions::ProgramParameteri;
+		sNativeMaxShaderCompilerThreads = GLExtensions::MaxShaderCompilerThreads;
+		sNativeMultiDrawElementsIndirect = GLExtensions::MultiDrawElementsIndirect;
+		GLExtensions::BufferStorage = 0;
+		GLExtensions::GetProgramBinary = 0;
+		GLExtensions::ProgramBinary = 0;
+		GLExtensions::ProgramParameteri = 0;
+		GLExtensions::MaxShaderCompilerThreads = 0;
+		GLExtensions::MultiDrawElementsIndirect = 0;
+	}
+	else
+	{
+#define GL_SWAP_TO_NATIVE(name, type) glad_gl##name = sNative##name;
+		GL_RECORDED_FUNCTIONS(GL_SWAP_TO_NATIVE)
+#undef GL_SWAP_TO_NATIVE
+
+		GLExtensions::BufferStorage = sNativeBufferStorage;
+		GLExtensions::GetProgramBinary = sNativeGetProgramBinary;
+		GLExtensions::ProgramBinary = sNativeProgramBinary;
+		GLExtensions::ProgramParameteri = sNativeProgramParameteri;
+		GLExtensions::MaxShaderCompilerThreads = sNativeMaxShaderCompilerThreads;
+		GLExtensions::MultiDrawElementsIndirect = sNativeMultiDrawElementsIndirect;
+	}
+
+	// Bindings made on one backend mean nothing on the other
+	GLState::Invalidate();
+	sBackend = backend;
+}
+
+GLBackend GLRecorder::GetBackend()
+{
+	return sBackend;
+}
+
+void GLRecorder::SetLogging(bool keepLog)
+{
+	sKeepLog = keepLog;
+
+	if (!keepLog)
+	{
+		sCommands.clear();
+	}
+}
+
+void GLRecorder::BeginFrame()
+{
+	sCommands.clear();
+	memset(&sStats, 0, sizeof(GLRecorderStats));
+}
+
+void GLRecorder::EndFrame()
+{
+	sHistory.push_back(sStats);
+}
+
+const std::vector<GLCommand>& GLRecorder::GetCommands()
+{
+	return sCommands;
+}
+
+GLRecorderStats GLRecorder::GetCurrentStats()
+{
+	return sStats;
+}
+
+const std::vector<GLRecorderStats>& GLRecorder::GetFrameHistory()
+{
+	return sHistory;
+}
+
+void GLRecorder::ClearFrameHistory()
+{
+	sHistory.clear();
+}
+
+GLRecorderStats GLRecorder::Average(const std::vector<GLRecorderStats>& frames, unsigned int first)
+{
+	GLRecorderStats result;
+	memset(&result, 0, sizeof(GLRecorderStats));
+
+	if (first >= frames.size())
+	{
+		return result;
+	}
+
+	unsigned long long calls = 0, binds = 0, redundant = 0, textureBinds = 0, uploads = 0, draws = 0, uniforms = 0;
+	unsigned long long bytes = 0, uniformBytes = 0;
+
+	for (unsigned int i = first; i < frames.size(); ++i)
+	{
+		calls += frames[i].mCalls;
+		binds += frames[i].mBinds;
+		redundant += frames[i].mRedundantBinds;
+		textureBinds += frames[i].mTextureBinds;
+		uploads += frames[i].mUploads;
+		bytes += frames[i].mBytesUploaded;
+		draws += frames[i].mDraws;
+		uniforms += frames[i].mUniformSets;
+		uniformBytes += frames[i].mUniformBytes;
+	}
+
+	unsigned long long count = frames.size() - first;
+	result.mCalls = (unsigned int)(calls / count);
+	result.mBinds = (unsigned int)(binds / count);
+	result.mRedundantBinds = (unsigned int)(redundant / count);
+	result.mTextureBinds = (unsigned int)(textureBinds / count);
+	result.mUploads = (unsigned int)(uploads / count);
+	result.mBytesUploaded = bytes / count;
+	result.mDraws = (unsigned int)(draws / count);
+	result.mUniformSets = (unsigned int)(uniforms / count);
+	result.mUniformBytes = uniformBytes / count;
+
+	return result;
+}
+
+void GLRecorder::Print(const char* label, const GLRecorderStats& stats)
+{
+	printf("%-8s gl calls %7u  binds %6u (redundant %6u, textures %6u)  uploads %5u (%llu bytes)  uniforms %6u (%llu bytes)  draws %6u\n",
+		label, stats.mCalls, stats.mBinds, stats.mRedundantBinds, stats.mTextureBinds, stats.mUploads, stats.mBytesUploaded, stats.mUniformSets, stats.mUniformBytes, stats.mDraws);
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <vector>
+
+enum class GLBackend
+{
+	Native,		// Calls go to the driver through glad
+	Recording	// Calls are logged and counted but never executed, no context is needed
+};
+
+enum class GLCommandType
+{
+	Bind,
+	Upload,
+	Draw,
+	Uniform,
+	Create,
+	Delete,
+	Query,
+	State
+};
+
+struct GLCommand
+{
+	GLCommandType mType;
+	const char* mName;
+	unsigned int mTarget;
+	unsigned int mObject;
+	unsigned int mBytes; // Bytes uploaded, or elements drawn for draw calls
+};
+
+struct GLRecorderStats
+{
+	unsigned int mCalls;
+	unsigned int mBinds;
+	unsigned int mRedundantBinds; // Binds of the object that was already bound
+	unsigned int mTextureBinds;   // glBindTexture calls, also counted in mBinds
+	unsigned int mUploads;
+	unsigned long long mBytesUploaded;
+	unsigned int mDraws;
+	unsigned int mUniformSets;
+	unsigned long long mUniformBytes;
+};
+
+// Swaps the glad function pointers for recording stubs, so the existing wrappers can be profiled
+// on machines without a GPU. Shaders handed to the recorder are scanned for their uniform and
+// attribute declarations so Shader introspection still finds them.
+class GLRecorder
+{
+private:
+	GLRecorder();
+	GLRecorder(const GLRecorder&);
+	GLRecorder& operator=(const GLRecorder&);
+	~GLRecorder();
+public:
+	static void SetBackend(GLBackend backend);
+	static GLBackend GetBackend();
+
+	// Keeping the command log is optional, the counters are always updated while recording
+	static void SetLogging(bool keepLog);
+	static void BeginFrame();
+	static void EndFrame();
+
+	static const std::vector<GLCommand>& GetCommands();
+	static GLRecorderStats GetCurrentStats();
+	static const std::vector<GLRecorderStats>& GetFrameHistory();
+	static void ClearFrameHistory();
+
+	static GLRecorderStats Average(const std::vector<GLRecorderStats>& frames, unsigned int first);
+	static void Print(const char* label, const GLRecorderStats& stats);
+};
@@ -0,0 +1,460 @@
+#include "GLState.h"
+#include "GLExtensions.h"
+#include <unordered_map>
+
+#define GLSTATE_UNKNOWN 0xFFFFFFFF
+#define GLSTATE_NUM_BUFFER_TARGETS 8
+#define GLSTATE_NUM_TEXTURE_TARGETS 3
+
+struct VertexArrayState
+{
+	unsigned int mElementBuffer;
+	unsigned int mEnabled;  // Slots known to be enabled
+	unsigned int mKnown;    // Slots whose enabled flag is known
+	unsigned int mReleased; // Slots to disable at the next draw unless they are bound again
+	unsigned int mSources[GLSTATE_MAX_VERTEX_ATTRIBS];
+	unsigned int mOffsets[GLSTATE_MAX_VERTEX_ATTRIBS];
+	unsigned int mDivisors[GLSTATE_MAX_VERTEX_ATTRIBS];
+};
+
+static unsigned int sBuffers[GLSTATE_NUM_BUFFER_TARGETS] = { GLSTATE_UNKNOWN, GLSTATE_UNKNOWN, GLSTATE_UNKNOWN, GLSTATE_UNKNOWN, GLSTATE_UNKNOWN, GLSTATE_UNKNOWN, GLSTATE_UNKNOWN, GLSTATE_UNKNOWN };
+static unsigned int sTextures[GLSTATE_MAX_TEXTURE_UNITS][GLSTATE_NUM_TEXTURE_TARGETS];
+static unsigned int sVertexArray = GLSTATE_UNKNOWN;
+static unsigned int sProgram = GLSTATE_UNKNOWN;
+static unsigned int sActiveTexture = GLSTATE_UNKNOWN;
+static bool sTexturesKnown = false;
+
+struct IndexedBufferState
+{
+	unsigned int mBuffer;
+	unsigned int mOffset;
+	unsigned int mSize;
+};
+
+static IndexedBufferState sUniformBindings[GLSTATE_MAX_UNIFORM_BINDINGS];
+
+static std::unordered_map<unsigned int, VertexArrayState> sVertexArrays;
+static VertexArrayState* sCurrentArray = 0;
+
+static int BufferTargetIndex(unsigned int target)
+{
+	switch (target)
+	{
+	case GL_ARRAY_BUFFER:
+		return 0;
+	case GL_UNIFORM_BUFFER:
+		return 1;
+	case GL_PIXEL_UNPACK_BUFFER:
+		return 2;
+	case GL_PIXEL_PACK_BUFFER:
+		return 3;
+	case GL_COPY_READ_BUFFER:
+		return 4;
+	case GL_COPY_WRITE_BUFFER:
+		return 5;
+	case GL_DRAW_INDIRECT_BUFFER:
+		return 6;
+	case GL_SHADER_STORAGE_BUFFER:
+		return 7;
+	}
+
+	return -1;
+}
+
+static int TextureTargetIndex(unsigned int target)
+{
+	switch (target)
+	{
+	case GL_TEXTURE_2D:
+		return 0;
+	case GL_TEXTURE_2D_ARRAY:
+		return 1;
+	case GL_TEXTURE_CUBE_MAP:
+		return 2;
+	}
+
+	return -1;
+}
+
+static VertexArrayState* GetVertexArrayState(unsigned int vertexArray)
+{
+	std::unordered_map<unsigned int, VertexArrayState>::iterator it = sVertexArrays.find(vertexArray);
+
+	if (it != sVertexArrays.end())
+	{
+		return &it->second;
+	}
+
+	// The array may have been set up before the cache saw it, so nothing about it is known yet
+	VertexArrayState& state = sVertexArrays[vertexArray];
+	state.mElementBuffer = GLSTATE_UNKNOWN;
+	state.mEnabled = 0;
+	state.mKnown = 0;
+	state.mReleased = 0;
+
+	for (unsigned int i = 0; i < GLSTATE_MAX_VERTEX_ATTRIBS; ++i)
+	{
+		state.mSources[i] = GLSTATE_UNKNOWN;
+		state.mOffsets[i] = 0;
+		state.mDivisors[i] = GLSTATE_UNKNOWN;
+	}
+
+	return &state;
+}
+
+void GLState::Invalidate()
+{
+	for (unsigned int i = 0; i < GLSTATE_NUM_BUFFER_TARGETS; ++i)
+	{
+		sBuffers[i] = GLSTATE_UNKNOWN;
+	}
+
+	for (unsigned int i = 0; i < GLSTATE_MAX_UNIFORM_BINDINGS; ++i)
+	{
+		sUniformBindings[i].mBuffer = GLSTATE_UNKNOWN;
+	}
+
+	sVertexArray = GLSTATE_UNKNOWN;
+	sProgram = GLSTATE_UNKNOWN;
+	sActiveTexture = GLSTATE_UNKNOWN;
+	sTexturesKnown = false;
+	sVertexArrays.clear();
+	sCurrentArray = 0;
+}
+
+void GLState::BindBuffer(unsigned int target, unsigned int buffer)
+{
+	if (target == GL_ELEMENT_ARRAY_BUFFER)
+	{
+		if (sCurrentArray == 0)
+		{
+			glBindBuffer(target, buffer);
+			return;
+		}
+
+		if (sCurrentArray->mElementBuffer != buffer)
+		{
+			glBindBuffer(target, buffer);
+			sCurrentArray->mElementBuffer = buffer;
+		}
+		return;
+	}
+
+	int index = BufferTargetIndex(target);
+
+	if (index < 0)
+	{
+		glBindBuffer(target, buffer);
+	}
+	else if (sBuffers[index] != buffer)
+	{
+		glBindBuffer(target, buffer);
+		sBuffers[index] = buffer;
+	}
+}
+
+void GLState::BindBufferBase(unsigned int target, unsigned int index, unsigned int buffer)
+{
+	BindBufferRange(target, index, buffer, 0, 0);
+}
+
+void GLState::BindBufferRange(unsigned int target, unsigned int index, unsigned int buffer, unsigned int offset, unsigned int size)
+{
+	if (target != GL_UNIFORM_BUFFER || index >= GLSTATE_MAX_UNIFORM_BINDINGS)
+	{
+		if (size == 0)
+		{
+			glBindBufferBase(target, index, buffer);
+		}
+		else
+		{
+			glBindBufferRange(target, index, buffer, offset, size);
+		}
+
+		// The generic binding point changes too
+		int generic = BufferTargetIndex(target);
+		if (generic >= 0)
+		{
+			sBuffers[generic] = buffer;
+		}
+		return;
+	}
+
+	IndexedBufferState& binding = sUniformBindings[index];
+
+	if (binding.mBuffer == buffer && binding.mOffset == offset && binding.mSize == size)
+	{
+		return;
+	}
+
+	if (size == 0)
+	{
+		glBindBufferBase(target, index, buffer);
+	}
+	else
+	{
+		glBindBufferRange(target, index, buffer, offset, size);
+	}
+
+	binding.mBuffer = buffer;
+	binding.mOffset = offset;
+	binding.mSize = size;
+	sBuffers[BufferTargetIndex(GL_UNIFORM_BUFFER)] = buffer;
+}
+
+void GLState::BindVertexArray(unsigned int vertexArray)
+{
+	if (sVertexArray == vertexArray)
+	{
+		return;
+	}
+
+	glBindVertexArray(vertexArray);
+	sVertexArray = vertexArray;
+	sCurrentArray = GetVertexArrayState(vertexArray);
+}
+
+void GLState::UseProgram(unsigned int program)
+{
+	if (sProgram != program)
+	{
+		glUseProgram(program);
+		sProgram = program;
+	}
+}
+
+void GLState::ActiveTexture(unsigned int unit)
+{
+	if (sActiveTexture != unit)
+	{
+		glActiveTexture(GL_TEXTURE0 + unit);
+		sActiveTexture = unit;
+	}
+}
+
+void GLState::BindTexture(unsigned int unit, unsigned int target, unsigned int texture)
+{
+	int index = TextureTargetIndex(target);
+
+	if (!sTexturesKnown)
+	{
+		for (unsigned int i = 0; i < GLSTATE_MAX_TEXTURE_UNITS; ++i)
+		{
+			for (unsigned int j = 0; j < GLSTATE_NUM_TEXTURE_TARGETS; ++j)
+			{
+				sTextures[i][j] = GLSTATE_UNKNOWN;
+			}
+		}
+
+		sTexturesKnown = true;
+	}
+
+	if (index >= 0 && unit < GLSTATE_MAX_TEXTURE_UNITS && sTextures[unit][index] == texture)
+	{
+		return;
+	}
+
+	ActiveTexture(unit);
+	glBindTexture(target, texture);
+
+	if (index >= 0 && unit < GLSTATE_MAX_TEXTURE_UNITS)
+	{
+		sTextures[unit][index] = texture;
+	}
+}
+
+unsigned int GLState::GetBuffer(unsigned int target)
+{
+	if (target == GL_ELEMENT_ARRAY_BUFFER)
+	{
+		return sCurrentArray == 0 ? GLSTATE_UNKNOWN : sCurrentArray->mElementBuffer;
+	}
+
+	int index = BufferTargetIndex(target);
+
+	return index < 0 ? GLSTATE_UNKNOWN : sBuffers[index];
+}
+
+unsigned int GLState::GetVertexArray()
+{
+	return sVertexArray;
+}
+
+unsigned int GLState::GetProgram()
+{
+	return sProgram;
+}
+
+unsigned int GLState::GetActiveTexture()
+{
+	// Nothing has been bound through the cache yet, unit 0 is as good as any
+	if (sActiveTexture == GLSTATE_UNKNOWN)
+	{
+		ActiveTexture(0);
+	}
+
+	return sActiveTexture;
+}
+
+bool GLState::BindVertexAttrib(unsigned int slot, unsigned int buffer, unsigned int offset)
+{
+	if (sCurrentArray == 0 || slot >= GLSTATE_MAX_VERTEX_ATTRIBS)
+	{
+		BindBuffer(GL_ARRAY_BUFFER, buffer);
+		glEnableVertexAttribArray(slot);
+		return true;
+	}
+
+	unsigned int bit = 1 << slot;
+	sCurrentArray->mReleased &= ~bit;
+
+	if (!(sCurrentArray->mEnabled & bit) || !(sCurrentArray->mKnown & bit))
+	{
+		glEnableVertexAttribArray(slot);
+		sCurrentArray->mEnabled |= bit;
+		sCurrentArray->mKnown |= bit;
+	}
+
+	if (sCurrentArray->mSources[slot] == buffer && sCurrentArray->mOffsets[slot] == offset)
+	{
+		return false;
+	}
+
+	BindBuffer(GL_ARRAY_BUFFER, buffer);
+	sCurrentArray->mSources[slot] = buffer;
+	sCurrentArray->mOffsets[slot] = offset;
+
+	return true;
+}
+
+void GLState::VertexAttribDivisor(unsigned int slot, unsigned int divisor)
+{
+	if (sCurrentArray == 0 || slot >= GLSTATE_MAX_VERTEX_ATTRIBS)
+	{
+		glVertexAttribDivisor(slot, divisor);
+		return;
+	}
+
+	if (sCurrentArray->mDivisors[slot] != divisor)
+	{
+		glVertexAttribDivisor(slot, divisor);
+		sCurrentArray->mDivisors[slot] = divisor;
+	}
+}
+
+void GLState::ReleaseVertexAttrib(unsigned int slot)
+{
+	if (sCurrentArray == 0 || slot >= GLSTATE_MAX_VERTEX_ATTRIBS)
+	{
+		glDisableVertexAttribArray(slot);
+		return;
+	}
+
+	sCurrentArray->mReleased |= 1 << slot;
+}
+
+void GLState::PrepareDraw()
+{
+	if (sCurrentArray == 0 || sCurrentArray->mReleased == 0)
+	{
+		return;
+	}
+
+	unsigned int disable = sCurrentArray->mReleased & (sCurrentArray->mEnabled | ~sCurrentArray->mKnown);
+
+	for (unsigned int i = 0; i < GLSTATE_MAX_VERTEX_ATTRIBS; ++i)
+	{
+		if (disable & (1 << i))
+		{
+			glDisableVertexAttribArray(i);
+		}
+	}
+
+	sCurrentArray->mEnabled &= ~sCurrentArray->mReleased;
+	sCurrentArray->mKnown |= sCurrentArray->mReleased;
+	sCurrentArray->mReleased = 0;
+}
+
+void GLState::OnDeleteBuffer(unsigned int buffer)
+{
+	// GL unbinds a deleted buffer from the current context, and its name may be handed out again
+	for (unsigned int i = 0; i < GLSTATE_NUM_BUFFER_TARGETS; ++i)
+	{
+		if (sBuffers[i] == buffer)
+		{
+			sBuffers[i] = 0;
+		}
+	}
+
+	for (unsigned int i = 0; i < GLSTATE_MAX_UNIFORM_BINDINGS; ++i)
+	{
+		if (sUniformBindings[i].mBuffer == buffer)
+		{
+			sUniformBindings[i].mBuffer = GLSTATE_UNKNOWN;
+		}
+	}
+
+	for (std::unordered_map<unsigned int, VertexArrayState>::iterator it = sVertexArrays.begin(); it != sVertexArrays.end(); ++it)
+	{
+		if (it->second.mElementBuffer == buffer)
+		{
+			it->second.mElementBuffer = it->first == sVertexArray ? 0 : GLSTATE_UNKNOWN;
+		}
+	}
+
+	OnBufferLayoutChanged(buffer);
+}
+
+void GLState::OnBufferLayoutChanged(unsigned int buffer)
+{
+	for (std::unordered_map<unsigned int, VertexArrayState>::iterator it = sVertexArrays.begin(); it != sVertexArrays.end(); ++it)
+	{
+		for (unsigned int i = 0; i < GLSTATE_MAX_VERTEX_ATTRIBS; ++i)
+		{
+			if (it->second.mSources[i] == buffer)
+			{
+				it->second.mSources[i] = GLSTATE_UNKNOWN;
+			}
+		}
+	}
+}
+
+void GLState::OnDeleteVertexArray(unsigned int vertexArray)
+{
+	sVertexArrays.erase(vertexArray);
+
+	// Deleting the bound array reverts the binding to zero
+	if (sVertexArray == vertexArray)
+	{
+		sVertexArray = 0;
+		sCurrentArray = GetVertexArrayState(0);
+	}
+}
+
+void GLState::OnDeleteProgram(unsigned int program)
+{
+	// A deleted program stays in use until another one is bound, only the name can't be trusted
+	if (sProgram == program)
+	{
+		sProgram = GLSTATE_UNKNOWN;
+	}
+}
+
+void GLState::OnDeleteTexture(unsigned int texture)
+{
+	if (!sTexturesKnown)
+	{
+		return;
+	}
+
+	for (unsigned int i = 0; i < GLSTATE_MAX_TEXTURE_UNITS; ++i)
+	{
+		for (unsigned int j = 0; j < GLSTATE_NUM_TEXTURE_TARGETS; ++j)
+		{
+			if (sTextures[i][j] == texture)
+			{
+				sTextures[i][j] = 0;
+			}
+		}
+	}
+}
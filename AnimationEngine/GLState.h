@@ -0,0 +1,52 @@
+#pragma once
+
+#define GLSTATE_MAX_TEXTURE_UNITS 16
+#define GLSTATE_MAX_VERTEX_ATTRIBS 16
+#define GLSTATE_MAX_UNIFORM_BINDINGS 16
+
+// Shadows the GL bindings the engine changes and skips calls that would not change anything.
+// Wrappers bind through here and leave objects bound, nothing is reset to zero after use.
+// Anything that changes bindings behind its back must call Invalidate.
+class GLState
+{
+private:
+	GLState();
+	GLState(const GLState&);
+	GLState& operator=(const GLState&);
+	~GLState();
+public:
+	static void Invalidate();
+
+	// GL_ELEMENT_ARRAY_BUFFER is stored with the bound vertex array, other targets are global
+	static void BindBuffer(unsigned int target, unsigned int buffer);
+	// Indexed buffer bindings, a size of 0 binds the whole buffer. Both also bind the generic target,
+	// only GL_UNIFORM_BUFFER indices are cached.
+	static void BindBufferBase(unsigned int target, unsigned int index, unsigned int buffer);
+	static void BindBufferRange(unsigned int target, unsigned int index, unsigned int buffer, unsigned int offset, unsigned int size);
+	static void BindVertexArray(unsigned int vertexArray);
+	static void UseProgram(unsigned int program);
+	static void ActiveTexture(unsigned int unit);
+	static void BindTexture(unsigned int unit, unsigned int target, unsigned int texture);
+
+	static unsigned int GetBuffer(unsigned int target);
+	static unsigned int GetVertexArray();
+	static unsigned int GetProgram();
+	static unsigned int GetActiveTexture();
+
+	// Returns true if the slot was not already sourced from this buffer and offset, the caller
+	// then issues glVertexAttrib*Pointer with GL_ARRAY_BUFFER bound. The slot is enabled either way.
+	static bool BindVertexAttrib(unsigned int slot, unsigned int buffer, unsigned int offset);
+	// Stored with the bound vertex array like the slot's source, 0 advances per vertex
+	static void VertexAttribDivisor(unsigned int slot, unsigned int divisor);
+	// Disabling is deferred to the next draw, so a slot that is released and bound again
+	// with the same buffer between two draws costs no GL calls at all
+	static void ReleaseVertexAttrib(unsigned int slot);
+	static void PrepareDraw();
+
+	static void OnDeleteBuffer(unsigned int buffer);
+	// Vertex slots sourcing from the buffer issue their pointers again, for layout changes
+	static void OnBufferLayoutChanged(unsigned int buffer);
+	static void OnDeleteVertexArray(unsigned int vertexArray);
+	static void OnDeleteProgram(unsigned int program);
+	static void OnDeleteTexture(unsigned int texture);
+};
@@ -1,5 +1,6 @@
 #include "GLTFLoader.h"
 #include <iostream>
+#include <cstring>
 
 cgltf_data* LoadGLTFFile(const char* path)
 {
@@ -48,3 +49,22 @@ void FreeGLTFFile(cgltf_data* handle)
 		cgltf_free(handle);
 	}
 }
+
+std::vector<AABB> LoadMeshBounds(cgltf_data* data)
+{
+	std::vector<AABB> result;
+
+	if (data == 0)
+	{
+		return result;
+	}
+
+	result.resize(data->meshes_count);
+
+	for (unsigned int i = 0; i < (unsigned int)data->meshes_count; ++i)
+	{
+		result[i] = ComputeMeshBounds(&data->meshes[i]);
+	}
+
+	return result;
+}
@@ -1,7 +1,12 @@
 #pragma once
 
+#include <vector>
 #include "cgltf.h" 
+#include "Bounds.h"
 
 cgltf_data* LoadGLTFFile(const char* path); 
 
 void FreeGLTFFile(cgltf_data* handle); 
+
+// Model space bounds of every mesh in the file, in the order of data->meshes, for culling
+std::vector<AABB> LoadMeshBounds(cgltf_data* data);
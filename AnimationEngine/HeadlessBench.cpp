@@ -0,0 +1,837 @@
+#include "HeadlessBench.h"
+#include "glad.h"
+#include "Attribute.h"
+#include "Draw.h"
+#include "GLRecorder.h"
+#include "GLState.h"
+#include "IndexBuffer.h"
+#include "InterleavedBuffer.h"
+#include "MeshOptimizer.h"
+#include "MipGenerator.h"
+#include "RenderQueue.h"
+#include "Shader.h"
+#include "Texture.h"
+#include "ThreadPool.h"
+#include "Timer.h"
+#include "VertexArray.h"
+#include "vec2.h"
+#include "vec3.h"
+#include "vec4.h"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// Each benchmark reports its best run, these match the runs the quoted numbers came from
+#define BENCH_MIP_SIZE 4096
+#define BENCH_MIP_REPEATS 5
+#define BENCH_QUEUE_DRAWS 10000
+#define BENCH_QUEUE_FRAMES 30
+#define BENCH_INTERLEAVED_MESHES 500
+#define BENCH_INTERLEAVED_VERTICES 2000
+#define BENCH_INTERLEAVED_FRAMES 20
+
+static const char* sQueueVertex =
+	"#version 330 core\n"
+	"uniform mat4 model;\n"
+	"in vec3 position;\n"
+	"in vec2 texCoord;\n"
+	"out vec2 uv;\n"
+	"void main() { uv = texCoord; gl_Position = model * vec4(position, 1.0); }\n";
+
+static const char* sQueueFragment =
+	"#version 330 core\n"
+	"uniform sampler2D tex0;\n"
+	"in vec2 uv;\n"
+	"out vec4 color;\n"
+	"void main() { color = texture(tex0, uv); }\n";
+
+static const char* sInterleavedVertex =
+	"#version 330 core\n"
+	"in vec3 position;\n"
+	"in vec3 normal;\n"
+	"in vec2 texCoord;\n"
+	"in vec4 weights;\n"
+	"in ivec4 joints;\n"
+	"out vec3 color;\n"
+	"void main() { color = normal * weights.x + vec3(texCoord, float(joints.x)); gl_Position = vec4(position * 0.001, 1.0); }\n";
+
+static const char* sInterleavedFragment =
+	"#version 330 core\n"
+	"in vec3 color;\n"
+	"out vec4 fragColor;\n"
+	"void main() { fragColor = vec4(color, 1.0); }\n";
+
+static unsigned int sFailures = 0;
+
+static bool Expect(bool condition, const char* what)
+{
+	if (!condition)
+	{
+		printf("FAILED   %s\n", what);
+		sFailures += 1;
+	}
+
+	return condition;
+}
+
+static void FillRandom(std::vector<unsigned char>& bytes, std::mt19937& random)
+{
+	for (unsigned int i = 0, size = (unsigned int)bytes.size(); i < size; ++i)
+	{
+		bytes[i] = (unsigned char)(random() >> 24);
+	}
+}
+
+// The plain 2x2 average the SSE2 box filter has to match byte for byte
+static void ReferenceBox(const unsigned char* source, unsigned int width, unsigned int height, unsigned char* target)
+{
+	unsigned int targetWidth = width > 1 ? width / 2 : 1;
+	unsigned int targetHeight = height > 1 ? height / 2 : 1;
+
+	for (unsigned int y = 0; y < targetHeight; ++y)
+	{
+		unsigned int y0 = y * 2;
+		unsigned int y1 = y0 + 1 < height ? y0 + 1 : y0;
+
+		for (unsigned int x = 0; x < targetWidth; ++x)
+		{
+			unsigned int x0 = x * 2;
+			unsigned int x1 = x0 + 1 < width ? x0 + 1 : x0;
+
+			for (unsigned int c = 0; c < 4; ++c)
+			{
+				unsigned int sum = source[(y0 * width + x0) * 4 + c] + source[(y0 * width + x1) * 4 + c] +
+					source[(y1 * width + x0) * 4 + c] + source[(y1 * width + x1) * 4 + c];
+				target[(y * targetWidth + x) * 4 + c] = (unsigned char)((sum + 2) / 4);
+			}
+		}
+	}
+}
+
+static int MaxDifference(const std::vector<unsigned char>& a, const std::vector<unsigned char>& b)
+{
+	int result = 0;
+
+	for (unsigned int i = 0, size = (unsigned int)a.size(); i < size; ++i)
+	{
+		int difference = abs((int)a[i] - (int)b[i]);
+		result = difference > result ? difference : result;
+	}
+
+	return result;
+}
+
+// SSE2 against the portable loops for every filter, the linear box against the plain average,
+// threaded against single threaded, and constant images staying constant
+static void CheckMips()
+{
+	const unsigned int sizes[][2] = { { 1, 1 }, { 1, 7 }, { 7, 1 }, { 2, 2 }, { 3, 5 }, { 17, 9 }, { 33, 64 }, { 100, 3 }, { 257, 129 }, { 640, 480 } };
+	const unsigned int numSizes = sizeof(sizes) / sizeof(sizes[0]);
+	std::mt19937 random(43);
+	ThreadPool pool(3);
+	unsigned int cases = 0;
+	unsigned int exact = 0;
+	char what[128];
+
+	for (unsigned int i = 0; i < numSizes; ++i)
+	{
+		unsigned int width = sizes[i][0];
+		unsigned int height = sizes[i][1];
+		unsigned int targetBytes = (width > 1 ? width / 2 : 1) * (height > 1 ? height / 2 : 1) * 4;
+		std::vector<unsigned char> source(width * height * 4);
+		std::vector<unsigned char> constant(width * height * 4);
+		std::vector<unsigned char> simd(targetBytes);
+		std::vector<unsigned char> scalar(targetBytes);
+		std::vector<unsigned char> threaded(targetBytes);
+		FillRandom(source, random);
+
+		for (unsigned int p = 0; p < width * height; ++p)
+		{
+			constant[p * 4 + 0] = 37;
+			constant[p * 4 + 1] = 128;
+			constant[p * 4 + 2] = 255;
+			constant[p * 4 + 3] = 90;
+		}
+
+		for (unsigned int filter = 0; filter < 2; ++filter)
+		{
+			for (unsigned int sRGB = 0; sRGB < 2; ++sRGB)
+			{
+				const char* name = filter == 0 ? (sRGB ? "sRGB box" : "box") : (sRGB ? "sRGB Kaiser" : "Kaiser");
+				MipOptions options;
+				options.mFilter = filter == 0 ? MipFilter::Box : MipFilter::Kaiser;
+				options.mSRGB = sRGB != 0;
+				DownsampleRGBA8(&source[0], width, height, &simd[0], options);
+
+				options.mSIMD = false;
+				DownsampleRGBA8(&source[0], width, height, &scalar[0], options);
+				// The SSE2 conversion rounds halves to even where the portable one rounds them up
+				int difference = MaxDifference(simd, scalar);
+				snprintf(what, sizeof(what), "mips %s %ux%u SIMD differs from scalar by %d", name, width, height, difference);
+				Expect(difference <= (filter == 1 && sRGB == 0 ? 1 : 0), what);
+				exact += difference == 0 ? 1 : 0;
+				cases += 1;
+
+				options.mSIMD = true;
+				options.mPool = &pool;
+				DownsampleRGBA8(&source[0], width, height, &threaded[0], options);
+				snprintf(what, sizeof(what), "mips %s %ux%u threaded differs from single threaded", name, width, height);
+				Expect(threaded == simd, what);
+
+				DownsampleRGBA8(&constant[0], width, height, &simd[0], options);
+				bool unchanged = true;
+				for (unsigned int b = 0; b < targetBytes; ++b)
+				{
+					unchanged = unchanged && simd[b] == constant[b];
+				}
+				snprintf(what, sizeof(what), "mips %s %ux%u changes a constant image", name, width, height);
+				Expect(unchanged, what);
+			}
+		}
+
+		MipOptions options;
+		DownsampleRGBA8(&source[0], width, height, &simd[0], options);
+		ReferenceBox(&source[0], width, height, &scalar[0]);
+		snprintf(what, sizeof(what), "mips box %ux%u differs from the plain average", width, height);
+		Expect(simd == scalar, what);
+	}
+
+	printf("mips     %u cases, SIMD output identical to scalar in %u\n", cases, exact);
+}
+
+// Exposes the queue's sort items, so the radix sort runs on chosen keys without GL objects
+class RenderQueueSortCheck : public RenderQueue
+{
+public:
+	// Compares the radix sort against a stable sort of the same keys, returns the passes it took
+	unsigned int Check(const std::vector<unsigned long long>& keys, const char* label)
+	{
+		mItems.clear();
+
+		for (unsigned int i = 0, size = (unsigned int)keys.size(); i < size; ++i)
+		{
+			SortItem item;
+			item.mKey = keys[i];
+			item.mIndex = i;
+			item.mPad = 0;
+			mItems.push_back(item);
+		}
+
+		std::vector<SortItem> expected = mItems;
+		std::stable_sort(expected.begin(), expected.end(), [](const SortItem& a, const SortItem& b) { return a.mKey < b.mKey; });
+		Sort();
+
+		bool same = mItems.size() == expected.size();
+		for (unsigned int i = 0, size = (unsigned int)expected.size(); same && i < size; ++i)
+		{
+			same = mItems[i].mKey == expected[i].mKey && mItems[i].mIndex == expected[i].mIndex;
+		}
+
+		char what[128];
+		snprintf(what, sizeof(what), "radix sort of %s differs from a stable sort", label);
+		Expect(same, what);
+
+		unsigned int passes = mStats.mSortPasses;
+		mItems.clear();
+		return passes;
+	}
+};
+
+static void CheckRadixSort()
+{
+	RenderQueueSortCheck queue;
+	std::mt19937_64 random(45);
+	std::vector<unsigned long long> keys;
+
+	queue.Check(keys, "no keys");
+	keys.push_back(7);
+	queue.Check(keys, "one key");
+	keys.push_back(3);
+	queue.Check(keys, "two keys");
+
+	keys.assign(100, 0x0123456789abcdefull);
+	Expect(queue.Check(keys, "equal keys") == 0, "radix sort ran passes over equal keys");
+
+	keys.resize(BENCH_QUEUE_DRAWS);
+	for (unsigned int i = 0; i < BENCH_QUEUE_DRAWS; ++i)
+	{
+		keys[i] = random();
+	}
+	queue.Check(keys, "random 64 bit keys");
+
+	// Few programs, textures and vertex arrays, so keys repeat and most bytes are shared
+	for (unsigned int i = 0; i < BENCH_QUEUE_DRAWS; ++i)
+	{
+		unsigned int r = (unsigned int)random();
+		keys[i] = RenderQueue::MakeSortKey(1 + r % 8, 1 + (r >> 3) % 64, 1 + (r >> 9) % 32, (float)((r >> 14) % 1000) / 1000.0f);
+	}
+	unsigned int passes = queue.Check(keys, "render keys");
+	Expect(passes < 8, "radix sort didn't skip the bytes every render key shares");
+
+	printf("sort     radix sort matches a stable sort, %u of 8 passes for render keys\n", passes);
+}
+
+// A regular grid of n by n vertices, two triangles per cell in row order
+static void MakeGrid(unsigned int n, std::vector<unsigned int>& indices)
+{
+	indices.clear();
+
+	for (unsigned int y = 0; y + 1 < n; ++y)
+	{
+		for (unsigned int x = 0; x + 1 < n; ++x)
+		{
+			unsigned int a = y * n + x;
+			unsigned int triangles[6] = { a, a + n, a + 1, a + 1, a + n, a + n + 1 };
+			indices.insert(indices.end(), triangles, triangles + 6);
+		}
+	}
+}
+
+// Shuffles the triangles and renumbers the vertices, the worst case a careless exporter produces
+static void ShuffleMesh(std::vector<unsigned int>& indices, unsigned int vertexCount, std::mt19937& random)
+{
+	unsigned int triangleCount = (unsigned int)indices.size() / 3;
+	std::vector<unsigned int> order(triangleCount);
+	for (unsigned int i = 0; i < triangleCount; ++i)
+	{
+		order[i] = i;
+	}
+	std::shuffle(order.begin(), order.end(), random);
+
+	std::vector<unsigned int> numbers(vertexCount);
+	for (unsigned int i = 0; i < vertexCount; ++i)
+	{
+		numbers[i] = i;
+	}
+	std::shuffle(numbers.begin(), numbers.end(), random);
+
+	std::vector<unsigned int> result;
+	result.reserve(indices.size());
+	for (unsigned int i = 0; i < triangleCount; ++i)
+	{
+		for (unsigned int k = 0; k < 3; ++k)
+		{
+			result.push_back(numbers[indices[order[i] * 3 + k]]);
+		}
+	}
+	indices.swap(result);
+}
+
+// Every triangle rotated to start at its smallest index, which keeps the winding, then sorted
+static std::vector<std::array<unsigned int, 3> > SortedTriangles(const std::vector<unsigned int>& indices)
+{
+	std::vector<std::array<unsigned int, 3> > result;
+
+	for (unsigned int i = 0, size = (unsigned int)indices.size(); i + 2 < size; i += 3)
+	{
+		unsigned int first = 0;
+		for (unsigned int k = 1; k < 3; ++k)
+		{
+			first = indices[i + k] < indices[i + first] ? k : first;
+		}
+
+		std::array<unsigned int, 3> triangle = { { indices[i + first], indices[i + (first + 1) % 3], indices[i + (first + 2) % 3] } };
+		result.push_back(triangle);
+	}
+
+	std::sort(result.begin(), result.end());
+	return result;
+}
+
+static void CheckIndexMesh(const char* label, const std::vector<unsigned int>& mesh, unsigned int vertexCount, float maxACMR)
+{
+	char what[128];
+	std::vector<unsigned int> indices = mesh;
+	VertexCacheStats before = AnalyzeVertexCache(&indices[0], (unsigned int)indices.size(), vertexCount);
+	OptimizeVertexCache(&indices[0], (unsigned int)indices.size(), vertexCount);
+	VertexCacheStats after = AnalyzeVertexCache(&indices[0], (unsigned int)indices.size(), vertexCount);
+
+	snprintf(what, sizeof(what), "index %s cache pass changed the triangles", label);
+	Expect(SortedTriangles(indices) == SortedTriangles(mesh), what);
+	snprintf(what, sizeof(what), "index %s ACMR went from %.3f to %.3f", label, before.mACMR, after.mACMR);
+	Expect(after.mACMR <= before.mACMR && after.mACMR <= maxACMR, what);
+
+	std::vector<unsigned int> cached = indices;
+	std::vector<unsigned int> remap;
+	unsigned int used = OptimizeVertexFetch(&indices[0], (unsigned int)indices.size(), vertexCount, remap);
+
+	// Old vertices map one to one onto 0..used - 1 in the order the triangles first reach them
+	std::vector<unsigned int> owners(used, ~0u);
+	unsigned int next = 0;
+	bool consistent = remap.size() == vertexCount;
+	for (unsigned int i = 0, size = (unsigned int)indices.size(); consistent && i < size; ++i)
+	{
+		consistent = indices[i] == remap[cached[i]] && indices[i] < used && indices[i] <= next;
+		if (consistent && indices[i] == next)
+		{
+			owners[next++] = cached[i];
+		}
+		consistent = consistent && owners[indices[i]] == cached[i];
+	}
+	consistent = consistent && next == used;
+	for (unsigned int v = 0; consistent && v < vertexCount; ++v)
+	{
+		consistent = remap[v] == ~0u || (remap[v] < used && owners[remap[v]] == v);
+	}
+	snprintf(what, sizeof(what), "index %s fetch pass remap is inconsistent", label);
+	Expect(consistent, what);
+
+	printf("index    %-24s ACMR %.3f -> %.3f, %u of %u vertices used\n", label, before.mACMR, after.mACMR, used, vertexCount);
+}
+
+static void CheckIndexOptimizer()
+{
+	std::mt19937 random(35);
+	std::vector<unsigned int> indices;
+
+	MakeGrid(64, indices);
+	CheckIndexMesh("grid 64 (row order)", indices, 64 * 64, 0.75f);
+
+	ShuffleMesh(indices, 64 * 64, random);
+	CheckIndexMesh("grid 64 (shuffled)", indices, 64 * 64, 0.75f);
+
+	// Vertices no triangle uses have to come out unmapped
+	CheckIndexMesh("grid 64 (unused vertices)", indices, 64 * 64 + 100, 0.75f);
+
+	indices.assign(3, 0);
+	CheckIndexMesh("degenerate triangle", indices, 1, 3.0f);
+}
+
+bool RunChecks()
+{
+	sFailures = 0;
+	CheckMips();
+	CheckRadixSort();
+	CheckIndexOptimizer();
+
+	printf("%s, %u failed\n", sFailures == 0 ? "All checks passed" : "Checks failed", sFailures);
+	return sFailures == 0;
+}
+
+static void PrintMipRun(const char* label, double milliseconds)
+{
+	double megapixels = (double)BENCH_MIP_SIZE * BENCH_MIP_SIZE / 1000000.0;
+	printf("%-28s %8.1f ms  %7.0f MPix/s\n", label, milliseconds, megapixels / (milliseconds / 1000.0));
+}
+
+// A full mip chain of a random BENCH_MIP_SIZE square texture, best of BENCH_MIP_REPEATS
+static void BenchMips(bool hasContext, bool recording)
+{
+	unsigned int levels = GetMipCount(BENCH_MIP_SIZE, BENCH_MIP_SIZE);
+	std::vector<unsigned char> chain(GetMipChainSize(BENCH_MIP_SIZE, BENCH_MIP_SIZE, levels));
+	std::vector<unsigned char> level0(BENCH_MIP_SIZE * BENCH_MIP_SIZE * 4);
+	std::mt19937 random(43);
+	FillRandom(level0, random);
+	memcpy(&chain[0], &level0[0], level0.size());
+
+	ThreadPool pool;
+	printf("%ux%u RGBA8, %u levels, best of %u, %u pool threads\n", BENCH_MIP_SIZE, BENCH_MIP_SIZE, levels, BENCH_MIP_REPEATS, pool.GetNumThreads());
+
+	for (unsigned int threaded = 0; threaded < 2; ++threaded)
+	{
+		for (unsigned int run = 0; run < 5; ++run)
+		{
+			// The portable box loops first, then every filter with SSE2
+			MipOptions options;
+			options.mSIMD = run != 0;
+			options.mFilter = run >= 3 ? MipFilter::Kaiser : MipFilter::Box;
+			options.mSRGB = run == 2 || run == 4;
+			options.mPool = threaded ? &pool : 0;
+
+			double best = 0.0;
+			for (unsigned int i = 0; i < BENCH_MIP_REPEATS; ++i)
+			{
+				Timer timer;
+				GenerateMipChain(&chain[0], BENCH_MIP_SIZE, BENCH_MIP_SIZE, levels, options);
+				double milliseconds = timer.GetElapsedMilliseconds();
+				best = i == 0 || milliseconds < best ? milliseconds : best;
+			}
+
+			const char* names[] = { "scalar box", "box", "sRGB box", "Kaiser", "sRGB Kaiser" };
+			char label[64];
+			snprintf(label, sizeof(label), "%s%s", names[run], threaded ? " (pool)" : "");
+			PrintMipRun(label, best);
+		}
+	}
+
+	if (!hasContext || recording)
+	{
+		return;
+	}
+
+	Texture texture;
+	texture.Upload(BENCH_MIP_SIZE, BENCH_MIP_SIZE, 4, &level0[0]);
+	glFinish();
+
+	double best = 0.0;
+	for (unsigned int i = 0; i < BENCH_MIP_REPEATS; ++i)
+	{
+		Timer timer;
+		GLState::BindTexture(0, GL_TEXTURE_2D, texture.GetHandle());
+		glGenerateMipmap(GL_TEXTURE_2D);
+		glFinish();
+		double milliseconds = timer.GetElapsedMilliseconds();
+		best = i == 0 || milliseconds < best ? milliseconds : best;
+	}
+	PrintMipRun("glGenerateMipmap", best);
+}
+
+static void BenchIndexMesh(const char* label, unsigned int n, bool shuffle)
+{
+	std::mt19937 random(7);
+	std::vector<unsigned int> indices;
+	unsigned int vertexCount = n * n;
+	MakeGrid(n, indices);
+	if (shuffle)
+	{
+		ShuffleMesh(indices, vertexCount, random);
+	}
+
+	unsigned int indexCount = (unsigned int)indices.size();
+	VertexCacheStats before = AnalyzeVertexCache(&indices[0], indexCount, vertexCount);
+	float fetchBefore = AnalyzeVertexFetch(&indices[0], indexCount, vertexCount, 24);
+
+	Timer timer;
+	OptimizeVertexCache(&indices[0], indexCount, vertexCount);
+	double cacheMilliseconds = timer.GetElapsedMilliseconds();
+	VertexCacheStats after = AnalyzeVertexCache(&indices[0], indexCount, vertexCount);
+
+	std::vector<unsigned int> remap;
+	timer.Reset();
+	unsigned int used = OptimizeVertexFetch(&indices[0], indexCount, vertexCount, remap);
+	double fetchMilliseconds = timer.GetElapsedMilliseconds();
+	float fetchAfter = AnalyzeVertexFetch(&indices[0], indexCount, used, 24);
+
+	printf("%-22s %8u verts %8u tris | ACMR %.3f -> %.3f  ATVR %.2f -> %.2f | overfetch %.2f -> %.2f | cache pass %.1f ms (%.2f Mtri/s)  fetch pass %.2f ms | %s indices %u KB\n",
+		label, vertexCount, indexCount / 3, before.mACMR, after.mACMR, before.mATVR, after.mATVR, fetchBefore, fetchAfter,
+		cacheMilliseconds, (double)(indexCount / 3) / cacheMilliseconds / 1000.0, fetchMilliseconds,
+		used <= 65536 ? "16 bit" : "32 bit", indexCount * (used <= 65536 ? 2 : 4) / 1024);
+}
+
+// ACMR on a 16 entry FIFO, overfetch with 24 byte vertices
+static void BenchIndices()
+{
+	BenchIndexMesh("grid 200 (row order)", 200, false);
+	BenchIndexMesh("grid 200 (shuffled)", 200, true);
+	BenchIndexMesh("grid 1024 (shuffled)", 1024, true);
+}
+
+// Random draws over a few programs, textures and vertex arrays, issued in submission order and sorted
+static void BenchRenderQueue(bool recording)
+{
+	const unsigned int numShaders = 8;
+	const unsigned int numTextures = 64;
+	const unsigned int numVertexArrays = 32;
+
+	std::vector<Shader*> shaders(numShaders);
+	for (unsigned int i = 0; i < numShaders; ++i)
+	{
+		shaders[i] = new Shader(sQueueVertex, sQueueFragment);
+	}
+
+	std::vector<unsigned char> pixels(64 * 64 * 4, 200);
+	std::vector<Texture*> textures(numTextures);
+	for (unsigned int i = 0; i < numTextures; ++i)
+	{
+		textures[i] = new Texture();
+		textures[i]->Upload(64, 64, 4, &pixels[0]);
+	}
+
+	vec3 positions[3] = { vec3(0.0f, 0.0f, 0.0f), vec3(0.001f, 0.0f, 0.0f), vec3(0.0f, 0.001f, 0.0f) };
+	vec2 texCoords[3] = { vec2(0.0f, 0.0f), vec2(1.0f, 0.0f), vec2(0.0f, 1.0f) };
+	unsigned int triangle[3] = { 0, 1, 2 };
+	Attribute<vec3> position;
+	Attribute<vec2> texCoord;
+	IndexBuffer indexBuffer;
+	position.Set(positions, 3);
+	texCoord.Set(texCoords, 3);
+	indexBuffer.Set(triangle, 3);
+
+	std::vector<VertexArray*> vertexArrays(numVertexArrays);
+	for (unsigned int i = 0; i < numVertexArrays; ++i)
+	{
+		vertexArrays[i] = new VertexArray();
+		vertexArrays[i]->SetAttribute(shaders[0]->GetAttribute("position"), position);
+		vertexArrays[i]->SetAttribute(shaders[0]->GetAttribute("texCoord"), texCoord);
+		vertexArrays[i]->SetIndexBuffer(indexBuffer);
+	}
+
+	std::mt19937 random(7);
+	std::vector<RenderCommand> commands(BENCH_QUEUE_DRAWS);
+	std::vector<float> depths(BENCH_QUEUE_DRAWS);
+	for (unsigned int i = 0; i < BENCH_QUEUE_DRAWS; ++i)
+	{
+		commands[i].mShader = shaders[random() % numShaders];
+		commands[i].mTexture = textures[random() % numTextures];
+		commands[i].mVertexArray = vertexArrays[random() % numVertexArrays];
+		commands[i].mModel.v[12] = (float)(random() % 100) * 0.01f;
+		depths[i] = (float)(random() % 1000) / 1000.0f;
+	}
+
+	RenderQueue queue;
+	queue.Reserve(BENCH_QUEUE_DRAWS);
+	printf("%u draws over %u programs, %u textures and %u vertex arrays, best of %u frames\n",
+		BENCH_QUEUE_DRAWS, numShaders, numTextures, numVertexArrays, BENCH_QUEUE_FRAMES);
+
+	for (unsigned int sorted = 0; sorted < 2; ++sorted)
+	{
+		const char* label = sorted ? "sorted" : "submitted";
+		double bestSubmit = 0.0;
+		double bestSort = 0.0;
+		double bestExecute = 0.0;
+		queue.SetSortEnabled(sorted != 0);
+
+		if (recording)
+		{
+			GLRecorder::ClearFrameHistory();
+		}
+
+		for (unsigned int frame = 0; frame < BENCH_QUEUE_FRAMES; ++frame)
+		{
+			if (recording)
+			{
+				GLRecorder::BeginFrame();
+			}
+
+			Timer timer;
+			for (unsigned int i = 0; i < BENCH_QUEUE_DRAWS; ++i)
+			{
+				queue.Submit(commands[i], depths[i]);
+			}
+			double submit = timer.GetElapsedMilliseconds();
+			queue.Execute();
+
+			if (recording)
+			{
+				GLRecorder::EndFrame();
+			}
+			else
+			{
+				glFinish();
+			}
+
+			const RenderQueueStats& stats = queue.GetStats();
+			bool first = frame == 0;
+			bestSubmit = first || submit < bestSubmit ? submit : bestSubmit;
+			bestSort = first || stats.mSortMilliseconds < bestSort ? stats.mSortMilliseconds : bestSort;
+			bestExecute = first || stats.mExecuteMilliseconds < bestExecute ? stats.mExecuteMilliseconds : bestExecute;
+		}
+
+		queue.Print(label);
+		printf("         best submit %.3f ms  sort %.3f ms  execute %.3f ms\n", bestSubmit, bestSort, bestExecute);
+
+		if (recording)
+		{
+			GLRecorder::Print(label, GLRecorder::Average(GLRecorder::GetFrameHistory(), 0));
+		}
+	}
+
+	for (unsigned int i = 0; i < numVertexArrays; ++i)
+	{
+		delete vertexArrays[i];
+	}
+	for (unsigned int i = 0; i < numTextures; ++i)
+	{
+		delete textures[i];
+	}
+	for (unsigned int i = 0; i < numShaders; ++i)
+	{
+		delete shaders[i];
+	}
+}
+
+struct SeparateMesh
+{
+	Attribute<vec3> mPosition;
+	Attribute<vec3> mNormal;
+	Attribute<vec2> mTexCoord;
+	Attribute<vec4> mWeights;
+	Attribute<ivec4> mJoints;
+};
+
+// Skinned vertices, one buffer per attribute against one interleaved buffer per mesh
+static void BenchInterleaved(bool recording)
+{
+	const unsigned int numMeshes = BENCH_INTERLEAVED_MESHES;
+	const unsigned int numVertices = BENCH_INTERLEAVED_VERTICES;
+	Shader shader(sInterleavedVertex, sInterleavedFragment);
+	unsigned int slots[5] = { shader.GetAttribute("position"), shader.GetAttribute("normal"), shader.GetAttribute("texCoord"),
+		shader.GetAttribute("weights"), shader.GetAttribute("joints") };
+
+	std::vector<vec3> positions(numVertices);
+	std::vector<vec3> normals(numVertices, vec3(0.0f, 1.0f, 0.0f));
+	std::vector<vec2> texCoords(numVertices, vec2(0.5f, 0.5f));
+	std::vector<vec4> weights(numVertices, vec4(1.0f, 0.0f, 0.0f, 0.0f));
+	std::vector<ivec4> joints(numVertices, ivec4(0, 0, 0, 0));
+	std::vector<unsigned int> indices;
+	for (unsigned int i = 0; i < numVertices; ++i)
+	{
+		positions[i] = vec3((float)(i % 50), (float)(i / 50), 0.0f);
+	}
+	for (unsigned int i = 0; i + 2 < numVertices; ++i)
+	{
+		indices.push_back(i);
+		indices.push_back(i + 1);
+		indices.push_back(i + 2);
+	}
+	IndexBuffer indexBuffer;
+	indexBuffer.Set(indices);
+
+	VertexLayout layout;
+	layout.Add(slots[0], VertexFormat::Float3).Add(slots[1], VertexFormat::Float3).Add(slots[2], VertexFormat::Float2)
+		.Add(slots[3], VertexFormat::Float4).Add(slots[4], VertexFormat::Int4);
+	const void* streams[5] = { &positions[0], &normals[0], &texCoords[0], &weights[0], &joints[0] };
+
+	std::vector<SeparateMesh> separate(numMeshes);
+	std::vector<InterleavedBuffer> interleaved(numMeshes);
+
+	Timer timer;
+	for (unsigned int m = 0; m < numMeshes; ++m)
+	{
+		separate[m].mPosition.Set(positions);
+		separate[m].mNormal.Set(normals);
+		separate[m].mTexCoord.Set(texCoords);
+		separate[m].mWeights.Set(weights);
+		separate[m].mJoints.Set(joints);
+	}
+	if (!recording)
+	{
+		glFinish();
+	}
+	double uploadSeparate = timer.Lap();
+
+	std::vector<unsigned char> packed(numVertices * layout.GetStride());
+	for (unsigned int m = 0; m < numMeshes; ++m)
+	{
+		PackVertices(layout, streams, numVertices, &packed[0]);
+	}
+	double pack = timer.Lap();
+
+	for (unsigned int m = 0; m < numMeshes; ++m)
+	{
+		interleaved[m].Set(layout, streams, numVertices);
+	}
+	if (!recording)
+	{
+		glFinish();
+	}
+	double uploadInterleaved = timer.Lap();
+
+	printf("upload %u meshes x %u vertices (%u bytes each): separate %.2f ms, interleaved %.2f ms (packing alone %.2f ms)\n",
+		numMeshes, numVertices, layout.GetStride(), uploadSeparate * 1000.0, uploadInterleaved * 1000.0, pack * 1000.0);
+
+	for (unsigned int mode = 0; mode < 2; ++mode)
+	{
+		const char* label = mode ? "interleaved" : "separate";
+		double bind = 0.0;
+		Timer frameTimer;
+
+		if (recording)
+		{
+			GLRecorder::ClearFrameHistory();
+		}
+
+		for (unsigned int frame = 0; frame < BENCH_INTERLEAVED_FRAMES; ++frame)
+		{
+			if (recording)
+			{
+				GLRecorder::BeginFrame();
+			}
+			shader.Bind();
+
+			for (unsigned int m = 0; m < numMeshes; ++m)
+			{
+				Timer bindTimer;
+				if (mode == 0)
+				{
+					separate[m].mPosition.BindTo(slots[0]);
+					separate[m].mNormal.BindTo(slots[1]);
+					separate[m].mTexCoord.BindTo(slots[2]);
+					separate[m].mWeights.BindTo(slots[3]);
+					separate[m].mJoints.BindTo(slots[4]);
+				}
+				else
+				{
+					interleaved[m].BindTo();
+				}
+				bind += bindTimer.GetElapsedMilliseconds();
+
+				Draw(indexBuffer, DrawMode::Triangles);
+
+				if (mode == 0)
+				{
+					separate[m].mPosition.UnBindFrom(slots[0]);
+					separate[m].mNormal.UnBindFrom(slots[1]);
+					separate[m].mTexCoord.UnBindFrom(slots[2]);
+					separate[m].mWeights.UnBindFrom(slots[3]);
+					separate[m].mJoints.UnBindFrom(slots[4]);
+				}
+				else
+				{
+					interleaved[m].UnBindFrom();
+				}
+			}
+
+			if (recording)
+			{
+				GLRecorder::EndFrame();
+			}
+			else
+			{
+				glFinish();
+			}
+		}
+
+		printf("%-12s bind %.3f ms per frame, frame %.3f ms\n", label, bind / BENCH_INTERLEAVED_FRAMES,
+			frameTimer.GetElapsedMilliseconds() / BENCH_INTERLEAVED_FRAMES);
+
+		if (recording)
+		{
+			GLRecorder::Print(label, GLRecorder::Average(GLRecorder::GetFrameHistory(), 0));
+		}
+	}
+}
+
+bool RunBenchmark(const char* name, bool hasContext, bool recording)
+{
+	if (strcmp(name, "mips") == 0)
+	{
+		BenchMips(hasContext, recording);
+		return true;
+	}
+
+	if (strcmp(name, "index") == 0)
+	{
+		BenchIndices();
+		return true;
+	}
+
+	bool draws = strcmp(name, "queue") == 0 || strcmp(name, "interleaved") == 0;
+
+	if (!draws)
+	{
+		printf("Unknown benchmark: %s, expected mips, index, queue or interleaved\n", name);
+		return false;
+	}
+
+	if (!hasContext && !recording)
+	{
+		printf("The %s benchmark draws, run it with a GL context or --record-gl\n", name);
+		return false;
+	}
+
+	if (strcmp(name, "queue") == 0)
+	{
+		BenchRenderQueue(recording);
+	}
+	else
+	{
+		BenchInterleaved(recording);
+	}
+
+	return true;
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+// Benchmarks and equivalence checks run by the headless runner with --bench and --check, so the
+// numbers quoted for the mip generator, mesh optimizer, render queue and interleaved buffers can
+// be measured again and their fast paths compared against the plain ones.
+
+// mips, index, queue or interleaved. queue and interleaved draw, they need a current context or
+// the GLRecorder backend. Returns false for an unknown name or a benchmark that can't run.
+bool RunBenchmark(const char* name, bool hasContext, bool recording);
+
+// Runs every check without GL, prints each failure and returns true when nothing failed
+bool RunChecks();
@@ -0,0 +1,576 @@
+// Headless entry point for the Linux build and perf machines, drives the Application from the command
+// line with a fixed dt and reports per frame timings. WinMain.cpp is the windowed entry point on Windows.
+//
+// Build: cmake -S .. -B build && cmake --build build, see CMakeLists.txt next to AnimationEngine.sln
+// Usage: AnimationEngine [--frames N] [--dt seconds] [--width W] [--height H] [--no-gl] [--record-gl] [--finish] [--shader-cache dir]
+//        [--fixed-step seconds] [--real-time] [--capture frames.csv] [--threaded]
+//        AnimationEngine --bake-texture input output [--bake-texture input output ...] [--mip-filter box|kaiser] [--srgb-mips]
+//        AnimationEngine --bench mips|index|queue|interleaved [--no-gl] [--record-gl]
+//        AnimationEngine --check
+#if !defined(_WIN32)
+
+#include "glad.h"
+#include <dlfcn.h>
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "Application.h"
+#include "FixedTimestep.h"
+#include "FrameStats.h"
+#include "GLRecorder.h"
+#include "GLState.h"
+#include "GLExtensions.h"
+#include "HeadlessBench.h"
+#include "ShaderCache.h"
+#include "TextureFile.h"
+#include "ThreadPool.h"
+#include "Timer.h"
+#include "UpdateThread.h"
+
+// EGL is loaded at runtime, so the runner needs neither the EGL headers nor libEGL when running with --no-gl
+#define EGL_DEFAULT_DISPLAY                   ((void*)0)
+#define EGL_NONE                              0x3038
+#define EGL_SURFACE_TYPE                      0x3033
+#define EGL_PBUFFER_BIT                       0x0001
+#define EGL_RENDERABLE_TYPE                   0x3040
+#define EGL_OPENGL_BIT                        0x0008
+#define EGL_RED_SIZE                          0x3024
+#define EGL_GREEN_SIZE                        0x3023
+#define EGL_BLUE_SIZE                         0x3022
+#define EGL_DEPTH_SIZE                        0x3025
+#define EGL_STENCIL_SIZE                      0x3026
+#define EGL_WIDTH                             0x3057
+#define EGL_HEIGHT                            0x3056
+#define EGL_OPENGL_API                        0x30A2
+#define EGL_CONTEXT_MAJOR_VERSION             0x3098
+#define EGL_CONTEXT_MINOR_VERSION             0x30FB
+#define EGL_CONTEXT_OPENGL_PROFILE_MASK       0x30FD
+#define EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT   0x00000001
+
+typedef void* EGLDisplay;
+typedef void* EGLConfig;
+typedef void* EGLSurface;
+typedef void* EGLContext;
+typedef int EGLint;
+typedef unsigned int EGLBoolean;
+typedef unsigned int EGLenum;
+
+typedef EGLDisplay(*PFNEGLGETDISPLAYPROC) (void* display_id);
+typedef EGLBoolean(*PFNEGLINITIALIZEPROC) (EGLDisplay dpy, EGLint* major, EGLint* minor);
+typedef EGLBoolean(*PFNEGLCHOOSECONFIGPROC) (EGLDisplay dpy, const EGLint* attrib_list, EGLConfig* configs, EGLint config_size, EGLint* num_config);
+typedef EGLSurface(*PFNEGLCREATEPBUFFERSURFACEPROC) (EGLDisplay dpy, EGLConfig config, const EGLint* attrib_list);
+typedef EGLBoolean(*PFNEGLBINDAPIPROC) (EGLenum api);
+typedef EGLContext(*PFNEGLCREATECONTEXTPROC) (EGLDisplay dpy, EGLConfig config, EGLContext share_context, const EGLint* attrib_list);
+typedef EGLBoolean(*PFNEGLMAKECURRENTPROC) (EGLDisplay dpy, EGLSurface draw, EGLSurface read, EGLContext ctx);
+typedef EGLBoolean(*PFNEGLDESTROYCONTEXTPROC) (EGLDisplay dpy, EGLContext ctx);
+typedef EGLBoolean(*PFNEGLDESTROYSURFACEPROC) (EGLDisplay dpy, EGLSurface surface);
+typedef EGLBoolean(*PFNEGLTERMINATEPROC) (EGLDisplay dpy);
+typedef void* (*PFNEGLGETPROCADDRESSPROC) (const char* procname);
+
+struct HeadlessOptions
+{
+	unsigned int mFrames;
+	float mDeltaTime;
+	int mWidth;
+	int mHeight;
+	bool mUseGL;
+	bool mRecordGL;
+	bool mFinish;
+	const char* mShaderCache;
+	// Update runs in steps of this size, 0 runs one Update per frame with the frame time
+	double mFixedStep;
+	// Frame time is measured instead of taken from --dt, runs stop being repeatable
+	bool mRealTime;
+	const char* mCapture;
+	// Update runs on an UpdateThread one frame ahead of Render instead of before it
+	bool mThreaded;
+	// Pairs of input image and output container, the runner bakes them and exits
+	std::vector<const char*> mBakeTextures;
+	MipOptions mBakeMips;
+	// Runs this benchmark from HeadlessBench.h instead of the frame loop
+	const char* mBench;
+	// Runs the equivalence checks and exits with 1 if any failed
+	bool mCheck;
+};
+
+struct HeadlessContext
+{
+	void* mLibrary;
+	EGLDisplay mDisplay;
+	EGLSurface mSurface;
+	EGLContext mContext;
+	PFNEGLMAKECURRENTPROC mMakeCurrent;
+	PFNEGLDESTROYCONTEXTPROC mDestroyContext;
+	PFNEGLDESTROYSURFACEPROC mDestroySurface;
+	PFNEGLTERMINATEPROC mTerminate;
+};
+
+Application* gApplication = 0;
+GLuint gVertexArrayObject = 0;
+PFNEGLGETPROCADDRESSPROC gEglGetProcAddress = 0;
+
+static void* GetGLProcAddress(const char* name)
+{
+	return gEglGetProcAddress(name);
+}
+
+static bool ParseOptions(int argc, char** argv, HeadlessOptions& options)
+{
+	options.mFrames = 1000;
+	options.mDeltaTime = 1.0f / 60.0f;
+	options.mWidth = 800;
+	options.mHeight = 600;
+	options.mUseGL = true;
+	options.mRecordGL = false;
+	options.mFinish = false;
+	options.mShaderCache = 0;
+	options.mFixedStep = 0.0;
+	options.mRealTime = false;
+	options.mCapture = 0;
+	options.mThreaded = false;
+	options.mBench = 0;
+	options.mCheck = false;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		bool hasValue = i + 1 < argc;
+
+		if (strcmp(argv[i], "--frames") == 0 && hasValue)
+		{
+			options.mFrames = (unsigned int)strtoul(argv[++i], 0, 10);
+		}
+		else if (strcmp(argv[i], "--dt") == 0 && hasValue)
+		{
+			options.mDeltaTime = (float)atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--width") == 0 && hasValue)
+		{
+			options.mWidth = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--height") == 0 && hasValue)
+		{
+			options.mHeight = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--no-gl") == 0)
+		{
+			options.mUseGL = false;
+		}
+		else if (strcmp(argv[i], "--record-gl") == 0)
+		{
+			options.mRecordGL = true;
+			options.mUseGL = true;
+		}
+		else if (strcmp(argv[i], "--finish") == 0)
+		{
+			options.mFinish = true;
+		}
+		else if (strcmp(argv[i], "--shader-cache") == 0 && hasValue)
+		{
+			options.mShaderCache = argv[++i];
+		}
+		else if (strcmp(argv[i], "--fixed-step") == 0 && hasValue)
+		{
+			options.mFixedStep = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--real-time") == 0)
+		{
+			options.mRealTime = true;
+		}
+		else if (strcmp(argv[i], "--capture") == 0 && hasValue)
+		{
+			options.mCapture = argv[++i];
+		}
+		else if (strcmp(argv[i], "--threaded") == 0)
+		{
+			options.mThreaded = true;
+		}
+		else if (strcmp(argv[i], "--bake-texture") == 0 && i + 2 < argc)
+		{
+			options.mBakeTextures.push_back(argv[++i]);
+			options.mBakeTextures.push_back(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--mip-filter") == 0 && hasValue)
+		{
+			++i;
+			if (strcmp(argv[i], "box") == 0)
+			{
+				options.mBakeMips.mFilter = MipFilter::Box;
+			}
+			else if (strcmp(argv[i], "kaiser") == 0)
+			{
+				options.mBakeMips.mFilter = MipFilter::Kaiser;
+			}
+			else
+			{
+				std::cout << "Unknown mip filter: " << argv[i] << "\n";
+				return false;
+			}
+		}
+		else if (strcmp(argv[i], "--srgb-mips") == 0)
+		{
+			options.mBakeMips.mSRGB = true;
+		}
+		else if (strcmp(argv[i], "--bench") == 0 && hasValue)
+		{
+			options.mBench = argv[++i];
+		}
+		else if (strcmp(argv[i], "--check") == 0)
+		{
+			options.mCheck = true;
+		}
+		else
+		{
+			std::cout << "Unknown option: " << argv[i] << "\n";
+			std::cout << "Usage: " << argv[0] << " [--frames N] [--dt seconds] [--width W] [--height H] [--no-gl] [--record-gl] [--finish] [--shader-cache dir] [--fixed-step seconds] [--real-time] [--capture frames.csv] [--threaded] [--bake-texture input output] [--mip-filter box|kaiser] [--srgb-mips] [--bench mips|index|queue|interleaved] [--check]\n";
+			return false;
+		}
+	}
+
+	if (options.mWidth <= 0 || options.mHeight <= 0)
+	{
+		std::cout << "Invalid surface size\n";
+		return false;
+	}
+
+	return true;
+}
+
+static bool CreateHeadlessContext(int width, int height, HeadlessContext& out)
+{
+	memset(&out, 0, sizeof(HeadlessContext));
+
+	// Without a display server Mesa can still create pbuffer contexts on its surfaceless platform
+	if (getenv("DISPLAY") == 0 && getenv("WAYLAND_DISPLAY") == 0)
+	{
+		setenv("EGL_PLATFORM", "surfaceless", 0);
+	}
+
+	out.mLibrary = dlopen("libEGL.so.1", RTLD_NOW | RTLD_GLOBAL);
+
+	if (out.mLibrary == 0)
+	{
+		std::cout << "Could not load libEGL.so.1\n";
+		return false;
+	}
+
+	PFNEGLGETDISPLAYPROC eglGetDisplay = (PFNEGLGETDISPLAYPROC)dlsym(out.mLibrary, "eglGetDisplay");
+	PFNEGLINITIALIZEPROC eglInitialize = (PFNEGLINITIALIZEPROC)dlsym(out.mLibrary, "eglInitialize");
+	PFNEGLCHOOSECONFIGPROC eglChooseConfig = (PFNEGLCHOOSECONFIGPROC)dlsym(out.mLibrary, "eglChooseConfig");
+	PFNEGLCREATEPBUFFERSURFACEPROC eglCreatePbufferSurface = (PFNEGLCREATEPBUFFERSURFACEPROC)dlsym(out.mLibrary, "eglCreatePbufferSurface");
+	PFNEGLBINDAPIPROC eglBindAPI = (PFNEGLBINDAPIPROC)dlsym(out.mLibrary, "eglBindAPI");
+	PFNEGLCREATECONTEXTPROC eglCreateContext = (PFNEGLCREATECONTEXTPROC)dlsym(out.mLibrary, "eglCreateContext");
+	out.mMakeCurrent = (PFNEGLMAKECURRENTPROC)dlsym(out.mLibrary, "eglMakeCurrent");
+	out.mDestroyContext = (PFNEGLDESTROYCONTEXTPROC)dlsym(out.mLibrary, "eglDestroyContext");
+	out.mDestroySurface = (PFNEGLDESTROYSURFACEPROC)dlsym(out.mLibrary, "eglDestroySurface");
+	out.mTerminate = (PFNEGLTERMINATEPROC)dlsym(out.mLibrary, "eglTerminate");
+	gEglGetProcAddress = (PFNEGLGETPROCADDRESSPROC)dlsym(out.mLibrary, "eglGetProcAddress");
+
+	if (eglGetDisplay == 0 || eglInitialize == 0 || eglChooseConfig == 0 || eglCreatePbufferSurface == 0 || eglBindAPI == 0 ||
+		eglCreateContext == 0 || out.mMakeCurrent == 0 || gEglGetProcAddress == 0)
+	{
+		std::cout << "libEGL is missing entry points\n";
+		return false;
+	}
+
+	out.mDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+	EGLint major = 0;
+	EGLint minor = 0;
+
+	if (out.mDisplay == 0 || !eglInitialize(out.mDisplay, &major, &minor))
+	{
+		std::cout << "Could not initialize EGL display\n";
+		return false;
+	}
+
+	const EGLint configAttribs[] = { EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_DEPTH_SIZE, 24, EGL_STENCIL_SIZE, 8, EGL_NONE };
+	EGLConfig config = 0;
+	EGLint numConfigs = 0;
+
+	if (!eglChooseConfig(out.mDisplay, configAttribs, &config, 1, &numConfigs) || numConfigs == 0)
+	{
+		std::cout << "No EGL config supports desktop OpenGL pbuffers\n";
+		return false;
+	}
+
+	const EGLint surfaceAttribs[] = { EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE };
+	out.mSurface = eglCreatePbufferSurface(out.mDisplay, config, surfaceAttribs);
+	eglBindAPI(EGL_OPENGL_API);
+
+	const EGLint contextAttribs[] = { EGL_CONTEXT_MAJOR_VERSION, 3, EGL_CONTEXT_MINOR_VERSION, 3, EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT, EGL_NONE };
+	out.mContext = eglCreateContext(out.mDisplay, config, 0, contextAttribs);
+
+	if (out.mSurface == 0 || out.mContext == 0 || !out.mMakeCurrent(out.mDisplay, out.mSurface, out.mSurface, out.mContext))
+	{
+		std::cout << "Could not create an OpenGL 3.3 core context\n";
+		return false;
+	}
+
+	return true;
+}
+
+static void DestroyHeadlessContext(HeadlessContext& context)
+{
+	if (context.mDisplay != 0)
+	{
+		context.mMakeCurrent(context.mDisplay, 0, 0, 0);
+
+		if (context.mContext != 0)
+		{
+			context.mDestroyContext(context.mDisplay, context.mContext);
+		}
+
+		if (context.mSurface != 0)
+		{
+			context.mDestroySurface(context.mDisplay, context.mSurface);
+		}
+
+		context.mTerminate(context.mDisplay);
+	}
+
+	if (context.mLibrary != 0)
+	{
+		dlclose(context.mLibrary);
+	}
+
+	memset(&context, 0, sizeof(HeadlessContext));
+}
+
+int main(int argc, char** argv)
+{
+	HeadlessOptions options;
+
+	if (!ParseOptions(argc, argv, options))
+	{
+		return 1;
+	}
+
+	if (options.mCheck)
+	{
+		return RunChecks() ? 0 : 1;
+	}
+
+	if (!options.mBakeTextures.empty())
+	{
+		unsigned int failed = 0;
+		ThreadPool pool;
+		options.mBakeMips.mPool = &pool;
+
+		for (unsigned int i = 0, size = (unsigned int)options.mBakeTextures.size(); i < size; i += 2)
+		{
+			if (!BakeTexture(options.mBakeTextures[i], options.mBakeTextures[i + 1], options.mBakeMips))
+			{
+				failed += 1;
+			}
+		}
+
+		std::cout << "Baked " << (options.mBakeTextures.size() / 2 - failed) << " textures, " << failed << " failed\n";
+		return failed == 0 ? 0 : 1;
+	}
+
+	HeadlessContext context;
+	memset(&context, 0, sizeof(HeadlessContext));
+
+	if (options.mRecordGL)
+	{
+		// GL calls are counted instead of executed, so the render path runs without a context
+		GLRecorder::SetBackend(GLBackend::Recording);
+		GLRecorder::SetLogging(false);
+		std::cout << "Recording GL calls, nothing is drawn\n";
+	}
+	else if (options.mUseGL)
+	{
+		if (!CreateHeadlessContext(options.mWidth, options.mHeight, context))
+		{
+			std::cout << "Run with --no-gl to benchmark without a GL context\n";
+			DestroyHeadlessContext(context);
+			return 1;
+		}
+
+		if (!gladLoadGLLoader(GetGLProcAddress))
+		{
+			std::cout << "Could not initialize GLAD\n";
+			DestroyHeadlessContext(context);
+			return 1;
+		}
+
+		std::cout << "OpenGL Version " << GLVersion.major << "." << GLVersion.minor << "\n";
+		GLExtensions::Load(GetGLProcAddress);
+
+		if (options.mShaderCache != 0)
+		{
+			ShaderCache::SetDirectory(options.mShaderCache);
+		}
+	}
+	else
+	{
+		// Without a context Render is skipped, only Update and CPU side systems are measured
+		std::cout << "Running without a GL context\n";
+	}
+
+	if (options.mUseGL)
+	{
+		glGenVertexArrays(1, &gVertexArrayObject);
+		GLState::BindVertexArray(gVertexArrayObject);
+	}
+
+	if (options.mBench != 0)
+	{
+		bool ran = RunBenchmark(options.mBench, options.mUseGL && !options.mRecordGL, options.mRecordGL);
+		GLRecorder::SetBackend(GLBackend::Native);
+		return ran ? 0 : 1;
+	}
+
+	if (options.mRecordGL)
+	{
+		GLRecorder::BeginFrame();
+	}
+
+	gApplication = new Application();
+	Timer initializeTimer;
+	gApplication->Initialize();
+	double initializeMilliseconds = initializeTimer.GetElapsedMilliseconds();
+
+	if (options.mRecordGL)
+	{
+		GLRecorder::EndFrame();
+	}
+
+	FrameStats updateStats;
+	FrameStats renderStats;
+	FrameStats frameStats;
+	updateStats.Reserve(options.mFrames);
+	renderStats.Reserve(options.mFrames);
+	frameStats.Reserve(options.mFrames);
+
+	float aspect = (float)options.mWidth / (float)options.mHeight;
+	UpdateThread updates(gApplication, options.mFixedStep);
+	Timer frameClock;
+
+	if (options.mThreaded)
+	{
+		updates.CollectUpdateStats(options.mFrames);
+		// Paced, so with --dt every rendered frame still gets exactly one snapshot
+		updates.Start(options.mRealTime ? 0.0 : (double)options.mDeltaTime, true);
+	}
+
+	for (unsigned int frame = 0; frame < options.mFrames; ++frame)
+	{
+		Timer frameTimer;
+
+		if (options.mRecordGL)
+		{
+			GLRecorder::BeginFrame();
+		}
+
+		if (!options.mThreaded)
+		{
+			updates.Update(options.mRealTime ? frameClock.Lap() : (double)options.mDeltaTime);
+		}
+
+		// Threaded this is only the wait for the update thread's snapshot
+		const FrameSnapshot* snapshot = updates.Acquire(true);
+		gApplication->ReadSnapshot(*snapshot);
+		updateStats.Add(frameTimer.GetElapsedMilliseconds());
+
+		if (options.mUseGL)
+		{
+			Timer renderTimer;
+
+			glViewport(0, 0, options.mWidth, options.mHeight);
+			glEnable(GL_DEPTH_TEST);
+			glEnable(GL_CULL_FACE);
+			glPointSize(5.0f);
+			GLState::BindVertexArray(gVertexArrayObject);
+			glClearColor(0.5f, 0.6f, 0.7f, 1.0f);
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
+			gApplication->Render(aspect, snapshot->GetAlpha());
+
+			if (options.mFinish)
+			{
+				glFinish();
+			}
+
+			renderStats.Add(renderTimer.GetElapsedMilliseconds());
+		}
+
+		if (options.mRecordGL)
+		{
+			GLRecorder::EndFrame();
+		}
+
+		frameStats.Add(frameTimer.GetElapsedMilliseconds());
+	}
+
+	updates.Stop();
+	gApplication->Shutdown();
+	delete gApplication;
+	gApplication = 0;
+
+	if (options.mUseGL)
+	{
+		GLState::BindVertexArray(0);
+		GLState::OnDeleteVertexArray(gVertexArrayObject);
+		glDeleteVertexArrays(1, &gVertexArrayObject);
+		gVertexArrayObject = 0;
+		DestroyHeadlessContext(context);
+	}
+
+	if (options.mRealTime)
+	{
+		std::cout << "Ran " << options.mFrames << " frames with measured frame times\n";
+	}
+	else
+	{
+		std::cout << "Ran " << options.mFrames << " frames with dt " << options.mDeltaTime << "s\n";
+	}
+
+	if (options.mFixedStep > 0.0)
+	{
+		std::cout << "Fixed step " << options.mFixedStep << "s, " << updates.GetTimestep().GetTotalSteps() << " updates, " << updates.GetTimestep().GetDroppedSeconds() << "s dropped\n";
+	}
+
+	std::cout << "Timer resolution " << Timer::GetResolution() << " ns\n";
+	std::cout << "Initialize took " << initializeMilliseconds << " ms\n";
+
+	if (ShaderCache::IsEnabled())
+	{
+		const ShaderCacheStats& cache = ShaderCache::GetStats();
+		std::cout << "Shader cache " << cache.mHits << " hits, " << cache.mMisses << " misses, " << cache.mRejected << " rejected, " << cache.mStored << " stored\n";
+	}
+	if (options.mThreaded)
+	{
+		UpdateThreadStats threadStats = updates.GetStats();
+		std::cout << "Update thread published " << threadStats.mPublished << " snapshots, " << threadStats.mOverwritten << " overwritten, " << threadStats.mRepeated << " frames repeated\n";
+		updates.GetUpdateStats().Print("updater");
+		updateStats.Print("wait");
+	}
+	else
+	{
+		updateStats.Print("update");
+	}
+
+	if (options.mUseGL)
+	{
+		renderStats.Print("render");
+	}
+
+	frameStats.Print("frame");
+
+	if (options.mCapture != 0 && frameStats.Write(options.mCapture))
+	{
+		std::cout << "Frame times written to " << options.mCapture << "\n";
+	}
+
+	if (options.mRecordGL)
+	{
+		// The first entry is the startup work done by Initialize
+		GLRecorder::Print("gl", GLRecorder::Average(GLRecorder::GetFrameHistory(), 1));
+		GLRecorder::SetBackend(GLBackend::Native);
+	}
+
+	return 0;
+}
+
+#endif
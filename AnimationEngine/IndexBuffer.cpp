@@ -1,25 +1,52 @@
 #include "IndexBuffer.h"
 #include "glad.h"
+#include "GLState.h"
+
+// Narrowing happens right before the upload, so one scratch buffer serves every index buffer
+static std::vector<unsigned short> sNarrowScratch;
 
 IndexBuffer::IndexBuffer() 
 { 
 	glGenBuffers(1, &mHandle); 
 	mCount = 0; 
+	mIndexType = GL_UNSIGNED_INT;
 } 
 
 IndexBuffer::~IndexBuffer() 
 { 
+	GLState::OnDeleteBuffer(mHandle);
 	glDeleteBuffers(1, &mHandle); 
 }
 
 void IndexBuffer::Set(unsigned int* inputArray, unsigned int arrayLengt) 
 {
+	unsigned int maxIndex = 0;
+
+	for (unsigned int i = 0; i < arrayLengt; ++i)
+	{
+		maxIndex = inputArray[i] > maxIndex ? inputArray[i] : maxIndex;
+	}
+
+	// Most meshes have fewer than 65536 vertices, 16 bit indices halve their index memory
+	if (maxIndex <= 0xFFFF && arrayLengt > 0)
+	{
+		sNarrowScratch.resize(arrayLengt);
+
+		for (unsigned int i = 0; i < arrayLengt; ++i)
+		{
+			sNarrowScratch[i] = (unsigned short)inputArray[i];
+		}
+
+		Set(&sNarrowScratch[0], arrayLengt);
+		return;
+	}
+
 	mCount = arrayLengt; 
+	mIndexType = GL_UNSIGNED_INT;
 	
 	unsigned int size = sizeof(unsigned int); 
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mHandle);
+	GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, mHandle);
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, size * mCount, inputArray, GL_STATIC_DRAW); 
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 } 
 
 void IndexBuffer::Set(std::vector<unsigned int>& input) 
@@ -27,6 +54,31 @@ void IndexBuffer::Set(std::vector<unsigned int>& input)
 	Set(&input[0], (unsigned int)input.size()); 
 }
 
+void IndexBuffer::Set(unsigned short* inputArray, unsigned int arrayLength) 
+{
+	mCount = arrayLength; 
+	mIndexType = GL_UNSIGNED_SHORT;
+	
+	unsigned int size = sizeof(unsigned short); 
+	GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, mHandle);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, size * mCount, inputArray, GL_STATIC_DRAW); 
+} 
+
+void IndexBuffer::Set(std::vector<unsigned short>& input) 
+{ 
+	Set(&input[0], (unsigned int)input.size()); 
+}
+
+unsigned int IndexBuffer::GetIndexType()
+{
+	return mIndexType;
+}
+
+unsigned int IndexBuffer::GetIndexSize()
+{
+	return mIndexType == GL_UNSIGNED_SHORT ? sizeof(unsigned short) : sizeof(unsigned int);
+}
+
 unsigned int IndexBuffer::Count()
 {
 	return mCount;
@@ -7,6 +7,7 @@ class IndexBuffer
 public: 
 	unsigned int mHandle; 
 	unsigned int mCount; 
+	unsigned int mIndexType; // GL_UNSIGNED_SHORT when every index fits, GL_UNSIGNED_INT otherwise
 private: 
 	IndexBuffer(const IndexBuffer& other); 
 	IndexBuffer& operator=(const IndexBuffer& other); 
@@ -16,6 +17,10 @@ public:
 	  
 	void Set(unsigned int* rr, unsigned int len); 
 	void Set(std::vector<unsigned int>& input); 
+	void Set(unsigned short* inputArray, unsigned int arrayLength); 
+	void Set(std::vector<unsigned short>& input); 
 	unsigned int Count(); 
+	unsigned int GetIndexType(); 
+	unsigned int GetIndexSize(); 
 	unsigned int GetHandle();
 };
@@ -0,0 +1,147 @@
+#include "IndirectBatch.h"
+#include "GLExtensions.h"
+#include "GLState.h"
+#include <iostream>
+
+IndirectBatch::IndirectBatch(unsigned int maxDraws)
+{
+	mMaxDraws = maxDraws;
+	mDrawIdSlot = 0xFFFFFFFF;
+	mCommands.reserve(maxDraws);
+	mData.reserve(maxDraws);
+
+	glGenBuffers(1, &mCommandBuffer);
+	glGenBuffers(1, &mDataBuffer);
+	glGenBuffers(1, &mDrawIdBuffer);
+
+	std::vector<unsigned int> drawIds(maxDraws);
+	for (unsigned int i = 0; i < maxDraws; ++i)
+	{
+		drawIds[i] = i;
+	}
+
+	GLState::BindBuffer(GL_ARRAY_BUFFER, mDrawIdBuffer);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(unsigned int) * maxDraws, maxDraws > 0 ? &drawIds[0] : 0, GL_STATIC_DRAW);
+}
+
+IndirectBatch::~IndirectBatch()
+{
+	GLState::OnDeleteBuffer(mCommandBuffer);
+	GLState::OnDeleteBuffer(mDataBuffer);
+	GLState::OnDeleteBuffer(mDrawIdBuffer);
+	glDeleteBuffers(1, &mCommandBuffer);
+	glDeleteBuffers(1, &mDataBuffer);
+	glDeleteBuffers(1, &mDrawIdBuffer);
+}
+
+void IndirectBatch::SetDrawId(unsigned int draw)
+{
+	unsigned int offset = draw * sizeof(unsigned int);
+
+	if (GLState::BindVertexAttrib(mDrawIdSlot, mDrawIdBuffer, offset))
+	{
+		glVertexAttribIPointer(mDrawIdSlot, 1, GL_UNSIGNED_INT, 0, (void*)(size_t)offset);
+	}
+}
+
+void IndirectBatch::AttachDrawIds(VertexArray& vertexArray, unsigned int slot)
+{
+	mDrawIdSlot = slot;
+	vertexArray.Bind();
+	SetDrawId(0);
+	GLState::VertexAttribDivisor(slot, 1);
+}
+
+bool IndirectBatch::Add(unsigned int firstIndex, unsigned int indexCount, int baseVertex, const mat4& model, const vec4& params)
+{
+	unsigned int draw = (unsigned int)mCommands.size();
+
+	if (draw >= mMaxDraws)
+	{
+		return false;
+	}
+
+	DrawElementsIndirectCommand command;
+	command.mCount = indexCount;
+	command.mInstanceCount = 1;
+	command.mFirstIndex = firstIndex;
+	command.mBaseVertex = baseVertex;
+	command.mBaseInstance = draw;
+	mCommands.push_back(command);
+
+	IndirectDrawData data;
+	data.mModel = model;
+	data.mParams = params;
+	mData.push_back(data);
+
+	return true;
+}
+
+void IndirectBatch::Execute(VertexArray& vertexArray, DrawMode mode)
+{
+	unsigned int numDraws = (unsigned int)mCommands.size();
+	IndexBuffer* indexBuffer = vertexArray.GetIndexBuffer();
+
+	if (numDraws == 0)
+	{
+		return;
+	}
+
+	if (indexBuffer == 0 || mDrawIdSlot == 0xFFFFFFFF)
+	{
+		std::cout << "IndirectBatch needs an indexed vertex array with draw ids attached\n";
+		return;
+	}
+
+	GLState::BindBuffer(GL_SHADER_STORAGE_BUFFER, mDataBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(IndirectDrawData) * numDraws, &mData[0], GL_STREAM_DRAW);
+	GLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, INDIRECT_BATCH_STORAGE_BINDING, mDataBuffer);
+
+	vertexArray.Bind();
+	GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer->GetHandle());
+	unsigned int indexType = indexBuffer->GetIndexType();
+	unsigned int primitive = DrawModeToGL(mode);
+
+	if (GLExtensions::HasMultiDrawIndirect())
+	{
+		GLState::BindBuffer(GL_DRAW_INDIRECT_BUFFER, mCommandBuffer);
+		glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(DrawElementsIndirectCommand) * numDraws, &mCommands[0], GL_STREAM_DRAW);
+
+		SetDrawId(0);
+		GLState::PrepareDraw();
+		GLExtensions::MultiDrawElementsIndirect(primitive, indexType, 0, (GLsizei)numDraws, 0);
+		return;
+	}
+
+	// baseInstance is emulated by pointing the drawId attribute at the draw's element
+	unsigned int indexSize = indexBuffer->GetIndexSize();
+	GLState::PrepareDraw();
+
+	for (unsigned int i = 0; i < numDraws; ++i)
+	{
+		const DrawElementsIndirectCommand& command = mCommands[i];
+		SetDrawId(i);
+		glDrawElementsBaseVertex(primitive, command.mCount, indexType, (void*)(size_t)(command.mFirstIndex * indexSize), command.mBaseVertex);
+	}
+}
+
+void IndirectBatch::Clear()
+{
+	mCommands.clear();
+	mData.clear();
+}
+
+bool IndirectBatch::IsIndirect()
+{
+	return GLExtensions::HasMultiDrawIndirect();
+}
+
+unsigned int IndirectBatch::GetNumDraws()
+{
+	return (unsigned int)mCommands.size();
+}
+
+unsigned int IndirectBatch::GetMaxDraws()
+{
+	return mMaxDraws;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <vector>
+#include "mat4.h"
+#include "vec4.h"
+#include "Draw.h"
+
+// Matches the binding of the Draws block in indirect.vert
+#define INDIRECT_BATCH_STORAGE_BINDING 0
+
+// Layout glMultiDrawElementsIndirect reads for every draw
+struct DrawElementsIndirectCommand
+{
+	unsigned int mCount;
+	unsigned int mInstanceCount;
+	unsigned int mFirstIndex;
+	int mBaseVertex;
+	unsigned int mBaseInstance;
+};
+
+// std430 element of the Draws block, keep the member order in sync with indirect.vert.
+// mParams is a uv offset in xy and scale in zw, as TextureAtlas regions store them.
+struct IndirectDrawData
+{
+	mat4 mModel;
+	vec4 mParams;
+};
+
+// Draws many meshes that share a program and a vertex array with one glMultiDrawElementsIndirect.
+// The meshes live at different ranges of the vertex array's index buffer. Per draw data goes to a
+// storage buffer, the shader finds its entry through the drawId attribute: a per instance buffer
+// of 0, 1, 2 ... whose first element each command selects with its baseInstance.
+// Without multi draw indirect Execute issues the commands one by one, moving the drawId
+// attribute to the draw's element instead, the shader still needs storage buffers.
+class IndirectBatch
+{
+protected:
+	std::vector<DrawElementsIndirectCommand> mCommands;
+	std::vector<IndirectDrawData> mData;
+	unsigned int mMaxDraws;
+	unsigned int mCommandBuffer;
+	unsigned int mDataBuffer;
+	unsigned int mDrawIdBuffer;
+	unsigned int mDrawIdSlot;
+	void SetDrawId(unsigned int draw);
+private:
+	IndirectBatch(const IndirectBatch&);
+	IndirectBatch& operator=(const IndirectBatch&);
+public:
+	IndirectBatch(unsigned int maxDraws);
+	~IndirectBatch();
+
+	// Sources the vertex array's drawId slot from the batch, once per vertex array
+	void AttachDrawIds(VertexArray& vertexArray, unsigned int slot);
+	// Draws indices [firstIndex, firstIndex + indexCount) with baseVertex added to each,
+	// returns false once the batch is full
+	bool Add(unsigned int firstIndex, unsigned int indexCount, int baseVertex, const mat4& model, const vec4& params = vec4(0.0f, 0.0f, 1.0f, 1.0f));
+	// Uploads the commands and their data and draws them, the shader has to be bound already
+	void Execute(VertexArray& vertexArray, DrawMode mode);
+	void Clear();
+
+	bool IsIndirect();
+	unsigned int GetNumDraws();
+	unsigned int GetMaxDraws();
+};
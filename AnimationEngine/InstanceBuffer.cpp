@@ -0,0 +1,105 @@
+#include "InstanceBuffer.h"
+
+// transformToMat4 rotates the three basis vectors through quat * vec3 one call at a time. This
+// is the same expansion, 2(q.v)q + (w^2 - q.q)v + 2w(q x v), written out per basis vector.
+static inline void TransformToMatrix(const Transform& t, mat4& out)
+{
+	const quat& q = t.rotation;
+	float s = q.w * q.w - (q.x * q.x + q.y * q.y + q.z * q.z);
+	float x2 = q.x * 2.0f;
+	float y2 = q.y * 2.0f;
+	float z2 = q.z * 2.0f;
+	float w2 = q.w * 2.0f;
+
+	float sx = t.scale.x;
+	float sy = t.scale.y;
+	float sz = t.scale.z;
+
+	out.xx = (x2 * q.x + s) * sx;
+	out.xy = (x2 * q.y + w2 * q.z) * sx;
+	out.xz = (x2 * q.z - w2 * q.y) * sx;
+	out.xw = 0.0f;
+
+	out.yx = (y2 * q.x - w2 * q.z) * sy;
+	out.yy = (y2 * q.y + s) * sy;
+	out.yz = (y2 * q.z + w2 * q.x) * sy;
+	out.yw = 0.0f;
+
+	out.zx = (z2 * q.x + w2 * q.y) * sz;
+	out.zy = (z2 * q.y - w2 * q.x) * sz;
+	out.zz = (z2 * q.z + s) * sz;
+	out.zw = 0.0f;
+
+	out.tx = t.position.x;
+	out.ty = t.position.y;
+	out.tz = t.position.z;
+	out.tw = 1.0f;
+}
+
+InstanceBuffer::InstanceBuffer(StreamBuffer* stream)
+{
+	mStream = stream;
+	mCount = 0;
+	mMatrices.SetUsage(AttributeUsage::Dynamic);
+	mMatrices.SetDivisor(1);
+}
+
+void InstanceBuffer::Upload(unsigned int count)
+{
+	mCount = count;
+
+	if (count == 0)
+	{
+		return;
+	}
+
+	if (mStream != 0)
+	{
+		mMatrices.Set(*mStream, &mScratch[0], count);
+	}
+	else
+	{
+		mMatrices.Set(&mScratch[0], count);
+	}
+}
+
+void InstanceBuffer::Set(const Transform* transforms, unsigned int count)
+{
+	if (mScratch.size() < count)
+	{
+		mScratch.resize(count);
+	}
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		TransformToMatrix(transforms[i], mScratch[i]);
+	}
+
+	Upload(count);
+}
+
+void InstanceBuffer::Set(std::vector<Transform>& transforms)
+{
+	Set(transforms.size() > 0 ? &transforms[0] : 0, (unsigned int)transforms.size());
+}
+
+void InstanceBuffer::Set(const mat4* matrices, unsigned int count)
+{
+	mScratch.assign(matrices, matrices + count);
+	Upload(count);
+}
+
+void InstanceBuffer::BindTo(unsigned int slot)
+{
+	mMatrices.BindTo(slot);
+}
+
+void InstanceBuffer::UnBindFrom(unsigned int slot)
+{
+	mMatrices.UnBindFrom(slot);
+}
+
+unsigned int InstanceBuffer::Count()
+{
+	return mCount;
+}
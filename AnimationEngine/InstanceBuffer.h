@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vector>
+#include "mat4.h"
+#include "Attribute.h"
+#include "Transform.h"
+
+// Model matrices of every instance in a DrawInstanced call, sourced by instanced.vert's
+// instanceModel attribute, which takes four slots. Set rebuilds the matrices from Transforms
+// every frame. With a StreamBuffer they go into its current segment, otherwise into a
+// dynamic buffer that is updated in place.
+// The source offset moves with every streamed Set, BindTo again afterwards with the vertex
+// array bound, GLState skips the pointer calls when nothing moved.
+class InstanceBuffer
+{
+protected:
+	Attribute<mat4> mMatrices;
+	std::vector<mat4> mScratch;
+	StreamBuffer* mStream;
+	unsigned int mCount;
+	void Upload(unsigned int count);
+private:
+	InstanceBuffer(const InstanceBuffer&);
+	InstanceBuffer& operator=(const InstanceBuffer&);
+public:
+	InstanceBuffer(StreamBuffer* stream = 0);
+
+	void Set(const Transform* transforms, unsigned int count);
+	void Set(std::vector<Transform>& transforms);
+	void Set(const mat4* matrices, unsigned int count);
+	void BindTo(unsigned int slot);
+	void UnBindFrom(unsigned int slot);
+	unsigned int Count();
+};
@@ -0,0 +1,160 @@
+#include "InterleavedBuffer.h"
+#include "GLState.h"
+#include "glad.h"
+#include <cstddef>
+
+// Packing happens on the GL thread right before the upload, so one scratch buffer serves every mesh
+static std::vector<unsigned char> sPackScratch;
+
+InterleavedBuffer::InterleavedBuffer()
+{
+	glGenBuffers(1, &mHandle);
+	mCount = 0;
+	mCapacity = 0;
+	mUsage = AttributeUsage::Static;
+}
+
+InterleavedBuffer::~InterleavedBuffer()
+{
+	GLState::OnDeleteBuffer(mHandle);
+	glDeleteBuffers(1, &mHandle);
+}
+
+void InterleavedBuffer::Set(const VertexLayout& layout, const void* vertices, unsigned int vertexCount)
+{
+	if (layout != mLayout)
+	{
+		mLayout = layout;
+		GLState::OnBufferLayoutChanged(mHandle);
+	}
+
+	mCount = vertexCount;
+
+	unsigned int bytes = layout.GetStride() * mCount;
+	GLState::BindBuffer(GL_ARRAY_BUFFER, mHandle);
+
+	if (mUsage == AttributeUsage::Static)
+	{
+		glBufferData(GL_ARRAY_BUFFER, bytes, vertices, GL_STATIC_DRAW);
+		mCapacity = bytes;
+		return;
+	}
+
+	if (bytes > mCapacity)
+	{
+		mCapacity = bytes + bytes / 2;
+		glBufferData(GL_ARRAY_BUFFER, mCapacity, 0, GL_DYNAMIC_DRAW);
+	}
+
+	glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, vertices);
+}
+
+void InterleavedBuffer::Set(const VertexLayout& layout, const void* const* streams, unsigned int vertexCount)
+{
+	unsigned int bytes = layout.GetStride() * vertexCount;
+
+	if (bytes == 0)
+	{
+		Set(layout, (const void*)0, 0);
+		return;
+	}
+
+	if (sPackScratch.size() < bytes)
+	{
+		sPackScratch.resize(bytes);
+	}
+
+	PackVertices(layout, streams, vertexCount, &sPackScratch[0]);
+	Set(layout, (const void*)&sPackScratch[0], vertexCount);
+}
+
+void InterleavedBuffer::SetUsage(AttributeUsage usage)
+{
+	mUsage = usage;
+}
+
+static void SetElementPointer(const VertexElement& element, unsigned int stride)
+{
+	void* offset = (void*)(size_t)element.mOffset;
+
+	switch (element.mFormat)
+	{
+	case VertexFormat::Float:
+		glVertexAttribPointer(element.mSlot, 1, GL_FLOAT, GL_FALSE, stride, offset);
+		break;
+	case VertexFormat::Float2:
+		glVertexAttribPointer(element.mSlot, 2, GL_FLOAT, GL_FALSE, stride, offset);
+		break;
+	case VertexFormat::Float3:
+		glVertexAttribPointer(element.mSlot, 3, GL_FLOAT, GL_FALSE, stride, offset);
+		break;
+	case VertexFormat::Float4:
+		glVertexAttribPointer(element.mSlot, 4, GL_FLOAT, GL_FALSE, stride, offset);
+		break;
+	case VertexFormat::Int:
+		glVertexAttribIPointer(element.mSlot, 1, GL_INT, stride, offset);
+		break;
+	case VertexFormat::Int4:
+		glVertexAttribIPointer(element.mSlot, 4, GL_INT, stride, offset);
+		break;
+	case VertexFormat::Half2:
+		glVertexAttribPointer(element.mSlot, 2, GL_HALF_FLOAT, GL_FALSE, stride, offset);
+		break;
+	case VertexFormat::Half4:
+		glVertexAttribPointer(element.mSlot, 4, GL_HALF_FLOAT, GL_FALSE, stride, offset);
+		break;
+	case VertexFormat::Snorm16x2:
+		glVertexAttribPointer(element.mSlot, 2, GL_SHORT, GL_TRUE, stride, offset);
+		break;
+	case VertexFormat::Unorm8x4:
+		glVertexAttribPointer(element.mSlot, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, offset);
+		break;
+	case VertexFormat::Unorm16x4:
+		glVertexAttribPointer(element.mSlot, 4, GL_UNSIGNED_SHORT, GL_TRUE, stride, offset);
+		break;
+	case VertexFormat::UByte4:
+		glVertexAttribIPointer(element.mSlot, 4, GL_UNSIGNED_BYTE, stride, offset);
+		break;
+	}
+}
+
+void InterleavedBuffer::BindTo()
+{
+	unsigned int stride = mLayout.GetStride();
+
+	for (unsigned int i = 0, size = mLayout.Size(); i < size; ++i)
+	{
+		const VertexElement& element = mLayout[i];
+
+		if (GLState::BindVertexAttrib(element.mSlot, mHandle, element.mOffset))
+		{
+			SetElementPointer(element, stride);
+		}
+
+		// An instanced attribute may have used the slot before, interleaved data is always per vertex
+		GLState::VertexAttribDivisor(element.mSlot, 0);
+	}
+}
+
+void InterleavedBuffer::UnBindFrom()
+{
+	for (unsigned int i = 0, size = mLayout.Size(); i < size; ++i)
+	{
+		GLState::ReleaseVertexAttrib(mLayout[i].mSlot);
+	}
+}
+
+const VertexLayout& InterleavedBuffer::GetLayout()
+{
+	return mLayout;
+}
+
+unsigned int InterleavedBuffer::Count()
+{
+	return mCount;
+}
+
+unsigned int InterleavedBuffer::GetHandle()
+{
+	return mHandle;
+}
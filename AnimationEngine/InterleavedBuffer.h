@@ -0,0 +1,35 @@
+#pragma once
+#include "VertexLayout.h"
+#include "Attribute.h"
+
+// A single vertex buffer holding every attribute of a mesh, one vertex after another.
+// BindTo binds all elements of the layout in one pass from the same buffer.
+class InterleavedBuffer
+{
+protected:
+	unsigned int mHandle;
+	unsigned int mCount;
+	// In bytes, the layout and with it the stride can change between Sets
+	unsigned int mCapacity;
+	AttributeUsage mUsage;
+	VertexLayout mLayout;
+private:
+	InterleavedBuffer(const InterleavedBuffer& other);
+	InterleavedBuffer& operator=(const InterleavedBuffer& other);
+public:
+	InterleavedBuffer();
+	~InterleavedBuffer();
+
+	// vertices must already be interleaved according to layout
+	void Set(const VertexLayout& layout, const void* vertices, unsigned int vertexCount);
+	// Packs one tightly packed array per layout element, then uploads
+	void Set(const VertexLayout& layout, const void* const* streams, unsigned int vertexCount);
+	void SetUsage(AttributeUsage usage);
+
+	void BindTo();
+	void UnBindFrom();
+
+	const VertexLayout& GetLayout();
+	unsigned int Count();
+	unsigned int GetHandle();
+};
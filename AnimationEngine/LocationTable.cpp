@@ -0,0 +1,115 @@
+#include "LocationTable.h"
+
+#define LOCATION_TABLE_MIN_CAPACITY 16
+
+LocationTable::LocationTable()
+{
+	mMask = 0;
+	mCount = 0;
+}
+
+void LocationTable::Clear()
+{
+	mEntries.clear();
+	mMask = 0;
+	mCount = 0;
+}
+
+unsigned int LocationTable::Size() const
+{
+	return mCount;
+}
+
+void LocationTable::GetEntries(std::vector<LocationTableEntry>& out) const
+{
+	out.clear();
+	out.reserve(mCount);
+
+	for (unsigned int i = 0, size = (unsigned int)mEntries.size(); i < size; ++i)
+	{
+		if (mEntries[i].mLocation != LOCATION_TABLE_EMPTY)
+		{
+			out.push_back(mEntries[i]);
+		}
+	}
+}
+
+void LocationTable::Grow()
+{
+	std::vector<LocationTableEntry> old;
+	old.swap(mEntries);
+
+	unsigned int capacity = old.size() == 0 ? LOCATION_TABLE_MIN_CAPACITY : (unsigned int)old.size() * 2;
+	LocationTableEntry empty = { 0, LOCATION_TABLE_EMPTY, 0, 0, 0 };
+	mEntries.resize(capacity, empty);
+	mMask = capacity - 1;
+	mCount = 0;
+
+	for (unsigned int i = 0, size = (unsigned int)old.size(); i < size; ++i)
+	{
+		if (old[i].mLocation != LOCATION_TABLE_EMPTY)
+		{
+			Insert(old[i].mHash, old[i].mCheck, old[i].mLocation, old[i].mSize);
+		}
+	}
+}
+
+bool LocationTable::Insert(unsigned int hash, unsigned long long check, unsigned int location, unsigned int size)
+{
+	if ((mCount + 1) * 2 > (unsigned int)mEntries.size())
+	{
+		Grow();
+	}
+
+	unsigned int index = hash & mMask;
+
+	while (mEntries[index].mLocation != LOCATION_TABLE_EMPTY)
+	{
+		if (mEntries[index].mHash == hash && mEntries[index].mCheck == check)
+		{
+			return false;
+		}
+
+		index = (index + 1) & mMask;
+	}
+
+	mEntries[index].mHash = hash;
+	mEntries[index].mLocation = location;
+	mEntries[index].mSize = size;
+	mEntries[index].mCheck = check;
+	mCount += 1;
+
+	return true;
+}
+
+bool LocationTable::Find(unsigned int hash, unsigned long long check, unsigned int& outLocation) const
+{
+	unsigned int size = 0;
+
+	return Find(hash, check, outLocation, size);
+}
+
+bool LocationTable::Find(unsigned int hash, unsigned long long check, unsigned int& outLocation, unsigned int& outSize) const
+{
+	if (mCount == 0)
+	{
+		return false;
+	}
+
+	const LocationTableEntry* entries = &mEntries[0];
+	unsigned int index = hash & mMask;
+
+	while (entries[index].mLocation != LOCATION_TABLE_EMPTY)
+	{
+		if (entries[index].mHash == hash && entries[index].mCheck == check)
+		{
+			outLocation = entries[index].mLocation;
+			outSize = entries[index].mSize;
+			return true;
+		}
+
+		index = (index + 1) & mMask;
+	}
+
+	return false;
+}
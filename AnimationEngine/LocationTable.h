@@ -0,0 +1,39 @@
+#pragma once
+
+#include <vector>
+
+#define LOCATION_TABLE_EMPTY 0xFFFFFFFF
+
+struct LocationTableEntry
+{
+	unsigned int mHash;
+	unsigned int mLocation; // LOCATION_TABLE_EMPTY marks a free entry
+	unsigned int mSize;     // Array length, element i is at mLocation + i
+	unsigned int mPadding;  // Zero, keeps mCheck aligned and cache files deterministic
+	unsigned long long mCheck;
+};
+
+// Flat open addressing map from a name to a GL location, probed linearly. Names are keyed by both
+// hashes of a StringHash, the 32 bit one picks the slot and the 64 bit one has to match as well,
+// so names whose 32 bit hashes collide still get entries of their own.
+// Kept at most half full so a miss ends within a couple of entries.
+class LocationTable
+{
+protected:
+	std::vector<LocationTableEntry> mEntries;
+	unsigned int mMask;
+	unsigned int mCount;
+protected:
+	void Grow();
+public:
+	LocationTable();
+
+	void Clear();
+	// Returns false if the name is already in the table, or the names collide in both hashes
+	bool Insert(unsigned int hash, unsigned long long check, unsigned int location, unsigned int size = 1);
+	bool Find(unsigned int hash, unsigned long long check, unsigned int& outLocation) const;
+	bool Find(unsigned int hash, unsigned long long check, unsigned int& outLocation, unsigned int& outSize) const;
+	unsigned int Size() const;
+	// Copies out the used entries, inserting them into an empty table rebuilds it
+	void GetEntries(std::vector<LocationTableEntry>& out) const;
+};
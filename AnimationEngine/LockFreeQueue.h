@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+
+// Bounded multi producer, multi consumer queue without locks (Vyukov's design). Every cell
+// carries a sequence number that tells producers and consumers whose turn it is, so Push and
+// Pop only contend on one atomic counter each. Capacity is rounded up to a power of two.
+template<typename T>
+class LockFreeQueue
+{
+protected:
+	struct Cell
+	{
+		std::atomic<unsigned int> mSequence;
+		T mValue;
+	};
+
+	Cell* mCells;
+	unsigned int mMask;
+	// Kept on separate cache lines so producers and consumers don't invalidate each other
+	alignas(64) std::atomic<unsigned int> mEnqueue;
+	alignas(64) std::atomic<unsigned int> mDequeue;
+private:
+	LockFreeQueue(const LockFreeQueue&);
+	LockFreeQueue& operator=(const LockFreeQueue&);
+public:
+	LockFreeQueue(unsigned int capacity)
+	{
+		unsigned int size = 2;
+		while (size < capacity)
+		{
+			size *= 2;
+		}
+
+		mCells = new Cell[size];
+		mMask = size - 1;
+
+		for (unsigned int i = 0; i < size; ++i)
+		{
+			mCells[i].mSequence.store(i, std::memory_order_relaxed);
+		}
+
+		mEnqueue.store(0, std::memory_order_relaxed);
+		mDequeue.store(0, std::memory_order_relaxed);
+	}
+
+	~LockFreeQueue()
+	{
+		delete[] mCells;
+	}
+
+	// Returns false when the queue is full
+	bool Push(const T& value)
+	{
+		unsigned int position = mEnqueue.load(std::memory_order_relaxed);
+		Cell* cell;
+
+		while (true)
+		{
+			cell = &mCells[position & mMask];
+			unsigned int sequence = cell->mSequence.load(std::memory_order_acquire);
+			int difference = (int)(sequence - position);
+
+			if (difference == 0)
+			{
+				if (mEnqueue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if (difference < 0)
+			{
+				return false;
+			}
+			else
+			{
+				position = mEnqueue.load(std::memory_order_relaxed);
+			}
+		}
+
+		cell->mValue = value;
+		cell->mSequence.store(position + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	// Returns false when the queue is empty
+	bool Pop(T& out)
+	{
+		unsigned int position = mDequeue.load(std::memory_order_relaxed);
+		Cell* cell;
+
+		while (true)
+		{
+			cell = &mCells[position & mMask];
+			unsigned int sequence = cell->mSequence.load(std::memory_order_acquire);
+			int difference = (int)(sequence - (position + 1));
+
+			if (difference == 0)
+			{
+				if (mDequeue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if (difference < 0)
+			{
+				return false;
+			}
+			else
+			{
+				position = mDequeue.load(std::memory_order_relaxed);
+			}
+		}
+
+		out = cell->mValue;
+		cell->mSequence.store(position + mMask + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	unsigned int GetCapacity()
+	{
+		return mMask + 1;
+	}
+};
@@ -0,0 +1,163 @@
+#include "MappedFile.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+{
+	mData = 0;
+	mSize = 0;
+#if defined(_WIN32)
+	mFile = INVALID_HANDLE_VALUE;
+	mMapping = 0;
+#else
+	mFile = -1;
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+#if defined(_WIN32)
+
+bool MappedFile::Open(const char* path)
+{
+	Close();
+
+	mFile = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, 0);
+	if (mFile == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(mFile, &size) || size.QuadPart == 0)
+	{
+		Close();
+		return false;
+	}
+
+	mMapping = CreateFileMappingA(mFile, 0, PAGE_READONLY, 0, 0, 0);
+	if (mMapping == 0)
+	{
+		Close();
+		return false;
+	}
+
+	mData = (const unsigned char*)MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0);
+	if (mData == 0)
+	{
+		Close();
+		return false;
+	}
+
+	mSize = (unsigned long long)size.QuadPart;
+
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (mData != 0)
+	{
+		UnmapViewOfFile(mData);
+	}
+
+	if (mMapping != 0)
+	{
+		CloseHandle(mMapping);
+	}
+
+	if (mFile != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(mFile);
+	}
+
+	mData = 0;
+	mSize = 0;
+	mFile = INVALID_HANDLE_VALUE;
+	mMapping = 0;
+}
+
+bool MappedFile::IsOpen()
+{
+	return mData != 0;
+}
+
+#else
+
+bool MappedFile::Open(const char* path)
+{
+	Close();
+
+	mFile = open(path, O_RDONLY);
+	if (mFile < 0)
+	{
+		return false;
+	}
+
+	struct stat info;
+	if (fstat(mFile, &info) != 0 || info.st_size == 0)
+	{
+		Close();
+		return false;
+	}
+
+	void* data = mmap(0, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, mFile, 0);
+	if (data == MAP_FAILED)
+	{
+		Close();
+		return false;
+	}
+
+	// Every byte is read once, front to back, by the upload
+	madvise(data, (size_t)info.st_size, MADV_SEQUENTIAL);
+
+	mData = (const unsigned char*)data;
+	mSize = (unsigned long long)info.st_size;
+
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (mData != 0)
+	{
+		munmap((void*)mData, (size_t)mSize);
+	}
+
+	if (mFile >= 0)
+	{
+		close(mFile);
+	}
+
+	mData = 0;
+	mSize = 0;
+	mFile = -1;
+}
+
+bool MappedFile::IsOpen()
+{
+	return mData != 0;
+}
+
+#endif
+
+const unsigned char* MappedFile::GetData()
+{
+	return mData;
+}
+
+unsigned long long MappedFile::GetSize()
+{
+	return mSize;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+// Read only view of a whole file mapped into memory. Pages are loaded by the OS on first touch,
+// so data that is only handed to GL never goes through an intermediate buffer.
+class MappedFile
+{
+protected:
+	const unsigned char* mData;
+	unsigned long long mSize;
+#if defined(_WIN32)
+	void* mFile;
+	void* mMapping;
+#else
+	int mFile;
+#endif
+private:
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+public:
+	MappedFile();
+	~MappedFile();
+
+	bool Open(const char* path);
+	void Close();
+
+	bool IsOpen();
+	const unsigned char* GetData();
+	unsigned long long GetSize();
+};
@@ -0,0 +1,298 @@
+#include "MeshOptimizer.h"
+#include <cmath>
+#include <cstring>
+
+#define FORSYTH_CACHE_SIZE 32
+#define FORSYTH_MAX_VALENCE 64
+
+static float sCacheScores[FORSYTH_CACHE_SIZE];
+static float sValenceScores[FORSYTH_MAX_VALENCE];
+static bool sScoresReady = false;
+
+static void ComputeScoreTables()
+{
+	const float cacheDecayPower = 1.5f;
+	const float lastTriangleScore = 0.75f;
+	const float valenceBoostScale = 2.0f;
+	const float valenceBoostPower = 0.5f;
+
+	for (unsigned int i = 0; i < FORSYTH_CACHE_SIZE; ++i)
+	{
+		if (i < 3)
+		{
+			// The last triangle's vertices get a fixed score so its neighbours aren't preferred blindly
+			sCacheScores[i] = lastTriangleScore;
+		}
+		else
+		{
+			float scale = 1.0f / (float)(FORSYTH_CACHE_SIZE - 3);
+			sCacheScores[i] = powf(1.0f - (float)(i - 3) * scale, cacheDecayPower);
+		}
+	}
+
+	sValenceScores[0] = 0.0f;
+
+	for (unsigned int i = 1; i < FORSYTH_MAX_VALENCE; ++i)
+	{
+		// Vertices with few triangles left are finished first so they stop occupying the cache
+		sValenceScores[i] = valenceBoostScale * powf((float)i, -valenceBoostPower);
+	}
+
+	sScoresReady = true;
+}
+
+static float VertexScore(int cachePosition, unsigned int remaining)
+{
+	if (remaining == 0)
+	{
+		return -1.0f;
+	}
+
+	float score = cachePosition >= 0 ? sCacheScores[cachePosition] : 0.0f;
+
+	return score + sValenceScores[remaining < FORSYTH_MAX_VALENCE ? remaining : FORSYTH_MAX_VALENCE - 1];
+}
+
+void OptimizeVertexCache(unsigned int* indices, unsigned int indexCount, unsigned int vertexCount)
+{
+	unsigned int triangleCount = indexCount / 3;
+
+	if (triangleCount == 0 || vertexCount == 0)
+	{
+		return;
+	}
+
+	if (!sScoresReady)
+	{
+		ComputeScoreTables();
+	}
+
+	// Triangles touching each vertex, the live ones are kept at the front of every range
+	std::vector<unsigned int> remaining(vertexCount, 0);
+	std::vector<unsigned int> offsets(vertexCount + 1, 0);
+
+	for (unsigned int i = 0; i < triangleCount * 3; ++i)
+	{
+		remaining[indices[i]] += 1;
+	}
+
+	for (unsigned int v = 0; v < vertexCount; ++v)
+	{
+		offsets[v + 1] = offsets[v] + remaining[v];
+	}
+
+	std::vector<unsigned int> adjacency(triangleCount * 3);
+	std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+
+	for (unsigned int t = 0; t < triangleCount; ++t)
+	{
+		for (unsigned int k = 0; k < 3; ++k)
+		{
+			unsigned int v = indices[t * 3 + k];
+			adjacency[fill[v]++] = t;
+		}
+	}
+
+	std::vector<int> cachePosition(vertexCount, -1);
+	std::vector<float> vertexScores(vertexCount);
+	std::vector<float> triangleScores(triangleCount);
+	std::vector<bool> emitted(triangleCount, false);
+
+	for (unsigned int v = 0; v < vertexCount; ++v)
+	{
+		vertexScores[v] = VertexScore(-1, remaining[v]);
+	}
+
+	int best = -1;
+	float bestScore = -1.0f;
+
+	for (unsigned int t = 0; t < triangleCount; ++t)
+	{
+		const unsigned int* tri = indices + t * 3;
+		triangleScores[t] = vertexScores[tri[0]] + vertexScores[tri[1]] + vertexScores[tri[2]];
+
+		if (triangleScores[t] > bestScore)
+		{
+			bestScore = triangleScores[t];
+			best = (int)t;
+		}
+	}
+
+	std::vector<unsigned int> output(triangleCount * 3);
+	unsigned int cache[FORSYTH_CACHE_SIZE + 3];
+	unsigned int newCache[FORSYTH_CACHE_SIZE + 3];
+	unsigned int cacheSize = 0;
+	unsigned int fallbackCursor = 0;
+
+	for (unsigned int emittedCount = 0; emittedCount < triangleCount; ++emittedCount)
+	{
+		if (best < 0)
+		{
+			// Nothing in the cache has triangles left, continue with the next unused one
+			while (emitted[fallbackCursor])
+			{
+				fallbackCursor += 1;
+			}
+
+			best = (int)fallbackCursor;
+		}
+
+		const unsigned int* tri = indices + best * 3;
+		memcpy(&output[emittedCount * 3], tri, sizeof(unsigned int) * 3);
+		emitted[best] = true;
+
+		// Drop the triangle from its vertices' live lists
+		for (unsigned int k = 0; k < 3; ++k)
+		{
+			unsigned int v = tri[k];
+			unsigned int* list = &adjacency[offsets[v]];
+
+			for (unsigned int i = 0; i < remaining[v]; ++i)
+			{
+				if (list[i] == (unsigned int)best)
+				{
+					list[i] = list[remaining[v] - 1];
+					break;
+				}
+			}
+
+			remaining[v] -= 1;
+		}
+
+		// The triangle's vertices move to the front of the LRU cache
+		unsigned int newSize = 0;
+
+		for (unsigned int k = 0; k < 3; ++k)
+		{
+			newCache[newSize++] = tri[k];
+		}
+
+		for (unsigned int i = 0; i < cacheSize; ++i)
+		{
+			unsigned int v = cache[i];
+
+			if (v != tri[0] && v != tri[1] && v != tri[2])
+			{
+				newCache[newSize++] = v;
+			}
+		}
+
+		for (unsigned int i = 0; i < newSize; ++i)
+		{
+			cachePosition[newCache[i]] = i < FORSYTH_CACHE_SIZE ? (int)i : -1;
+			vertexScores[newCache[i]] = VertexScore(cachePosition[newCache[i]], remaining[newCache[i]]);
+		}
+
+		best = -1;
+		bestScore = -1.0f;
+
+		for (unsigned int i = 0; i < newSize; ++i)
+		{
+			unsigned int v = newCache[i];
+			const unsigned int* list = &adjacency[offsets[v]];
+
+			for (unsigned int j = 0; j < remaining[v]; ++j)
+			{
+				unsigned int t = list[j];
+				const unsigned int* other = indices + t * 3;
+				triangleScores[t] = vertexScores[other[0]] + vertexScores[other[1]] + vertexScores[other[2]];
+
+				if (i < FORSYTH_CACHE_SIZE && triangleScores[t] > bestScore)
+				{
+					bestScore = triangleScores[t];
+					best = (int)t;
+				}
+			}
+		}
+
+		cacheSize = newSize < FORSYTH_CACHE_SIZE ? newSize : FORSYTH_CACHE_SIZE;
+		memcpy(cache, newCache, sizeof(unsigned int) * cacheSize);
+	}
+
+	memcpy(indices, &output[0], sizeof(unsigned int) * triangleCount * 3);
+}
+
+unsigned int OptimizeVertexFetch(unsigned int* indices, unsigned int indexCount, unsigned int vertexCount, std::vector<unsigned int>& remap)
+{
+	remap.assign(vertexCount, ~0u);
+	unsigned int next = 0;
+
+	for (unsigned int i = 0; i < indexCount; ++i)
+	{
+		unsigned int v = indices[i];
+
+		if (remap[v] == ~0u)
+		{
+			remap[v] = next++;
+		}
+
+		indices[i] = remap[v];
+	}
+
+	return next;
+}
+
+VertexCacheStats AnalyzeVertexCache(const unsigned int* indices, unsigned int indexCount, unsigned int vertexCount, unsigned int cacheSize)
+{
+	VertexCacheStats result;
+	memset(&result, 0, sizeof(VertexCacheStats));
+
+	// FIFO like most hardware, a vertex is in the cache if it was loaded in the last cacheSize misses
+	std::vector<unsigned int> loadedAt(vertexCount, 0);
+	unsigned int transforms = 0;
+	unsigned int used = 0;
+
+	for (unsigned int i = 0; i < indexCount; ++i)
+	{
+		unsigned int v = indices[i];
+
+		if (loadedAt[v] == 0)
+		{
+			used += 1;
+		}
+
+		if (loadedAt[v] == 0 || transforms - loadedAt[v] >= cacheSize)
+		{
+			transforms += 1;
+			loadedAt[v] = transforms;
+		}
+	}
+
+	result.mTransforms = transforms;
+	result.mACMR = indexCount >= 3 ? (float)transforms / (float)(indexCount / 3) : 0.0f;
+	result.mATVR = used > 0 ? (float)transforms / (float)used : 0.0f;
+
+	return result;
+}
+
+float AnalyzeVertexFetch(const unsigned int* indices, unsigned int indexCount, unsigned int vertexCount, unsigned int vertexSize)
+{
+	// Direct mapped, 256 lines of 64 bytes
+	const unsigned int lineSize = 64;
+	const unsigned int numLines = 256;
+	unsigned int lines[numLines];
+	memset(lines, 0xFF, sizeof(lines));
+
+	unsigned long long bytesFetched = 0;
+
+	for (unsigned int i = 0; i < indexCount; ++i)
+	{
+		unsigned long long start = (unsigned long long)indices[i] * vertexSize;
+		unsigned long long end = start + vertexSize;
+
+		for (unsigned long long line = start / lineSize; line * lineSize < end; ++line)
+		{
+			unsigned int slot = (unsigned int)(line % numLines);
+
+			if (lines[slot] != (unsigned int)line)
+			{
+				lines[slot] = (unsigned int)line;
+				bytesFetched += lineSize;
+			}
+		}
+	}
+
+	unsigned long long bufferSize = (unsigned long long)vertexCount * vertexSize;
+
+	return bufferSize > 0 ? (float)((double)bytesFetched / (double)bufferSize) : 0.0f;
+}
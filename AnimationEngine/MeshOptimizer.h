@@ -0,0 +1,39 @@
+#pragma once
+#include <vector>
+
+struct VertexCacheStats
+{
+	unsigned int mTransforms; // Vertex shader invocations with a FIFO post-transform cache
+	float mACMR;              // Transforms per triangle, 0.5 is the best a regular grid can do
+	float mATVR;              // Transforms per vertex, 1.0 is optimal
+};
+
+// Reorders triangles so vertices are reused while they are still in the post-transform cache,
+// using Tom Forsyth's linear-speed vertex cache optimization
+void OptimizeVertexCache(unsigned int* indices, unsigned int indexCount, unsigned int vertexCount);
+
+// Renumbers vertices in the order the (already cache optimized) triangles first use them, so vertex
+// fetch walks the buffer mostly forward. Fills remap with the new index of every old vertex,
+// unreferenced vertices get ~0u. Returns the number of referenced vertices.
+unsigned int OptimizeVertexFetch(unsigned int* indices, unsigned int indexCount, unsigned int vertexCount, std::vector<unsigned int>& remap);
+
+VertexCacheStats AnalyzeVertexCache(const unsigned int* indices, unsigned int indexCount, unsigned int vertexCount, unsigned int cacheSize = 16);
+// Bytes pulled from memory divided by the size of the vertex buffer, with a small cache of 64 byte lines
+float AnalyzeVertexFetch(const unsigned int* indices, unsigned int indexCount, unsigned int vertexCount, unsigned int vertexSize);
+
+// Moves every attribute array of a mesh to the order produced by OptimizeVertexFetch
+template<typename T>
+void RemapVertices(std::vector<T>& vertices, const std::vector<unsigned int>& remap, unsigned int newVertexCount)
+{
+	std::vector<T> result(newVertexCount);
+
+	for (unsigned int i = 0, size = (unsigned int)vertices.size(); i < size && i < remap.size(); ++i)
+	{
+		if (remap[i] != ~0u)
+		{
+			result[remap[i]] = vertices[i];
+		}
+	}
+
+	vertices.swap(result);
+}
@@ -0,0 +1,501 @@
+#include "MipGenerator.h"
+#include "ThreadPool.h"
+#include <cmath>
+#include <vector>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define MIP_USE_SSE2 1
+#else
+#define MIP_USE_SSE2 0
+#endif
+
+#define MIP_MAX_TAPS 6
+#define MIP_KAISER_ALPHA 4.0f
+#define MIP_SRGB_TABLE_SIZE 4096
+// Levels smaller than this are not worth handing to the pool
+#define MIP_MIN_THREADED_PIXELS (128 * 128)
+#define MIP_BANDS_PER_THREAD 4
+
+struct MipTables
+{
+	float mToLinear[256];
+	unsigned short mToLinear16[256];
+	unsigned char mToSRGB[MIP_SRGB_TABLE_SIZE];
+	float mBox[MIP_MAX_TAPS];
+	float mKaiser[MIP_MAX_TAPS];
+
+	MipTables();
+};
+
+static double BesselI0(double x)
+{
+	double sum = 1.0;
+	double term = 1.0;
+
+	for (int k = 1; k < 32; ++k)
+	{
+		double factor = x / (2.0 * k);
+		term *= factor * factor;
+		sum += term;
+	}
+
+	return sum;
+}
+
+MipTables::MipTables()
+{
+	for (int i = 0; i < 256; ++i)
+	{
+		double c = i / 255.0;
+		mToLinear[i] = (float)(c <= 0.04045 ? c / 12.92 : pow((c + 0.055) / 1.055, 2.4));
+		mToLinear16[i] = (unsigned short)(mToLinear[i] * 65535.0f + 0.5f);
+	}
+
+	for (int i = 0; i < MIP_SRGB_TABLE_SIZE; ++i)
+	{
+		double l = i / (double)(MIP_SRGB_TABLE_SIZE - 1);
+		double c = l <= 0.0031308 ? l * 12.92 : 1.055 * pow(l, 1.0 / 2.4) - 0.055;
+		mToSRGB[i] = (unsigned char)(c * 255.0 + 0.5);
+	}
+
+	// Taps sit at source pixels 2x-2 .. 2x+3, distances are in target pixels from the center
+	// between 2x and 2x+1. The box only uses the middle two.
+	double radius = MIP_MAX_TAPS / 4.0;
+	double total = 0.0;
+	double weights[MIP_MAX_TAPS];
+
+	for (int k = 0; k < MIP_MAX_TAPS; ++k)
+	{
+		double t = (k - (MIP_MAX_TAPS - 1) * 0.5) * 0.5;
+		double sinc = sin(3.14159265358979 * t) / (3.14159265358979 * t);
+		double window = BesselI0(MIP_KAISER_ALPHA * sqrt(1.0 - (t / radius) * (t / radius))) / BesselI0(MIP_KAISER_ALPHA);
+		weights[k] = sinc * window;
+		total += weights[k];
+	}
+
+	for (int k = 0; k < MIP_MAX_TAPS; ++k)
+	{
+		mKaiser[k] = (float)(weights[k] / total);
+		mBox[k] = (k == MIP_MAX_TAPS / 2 - 1 || k == MIP_MAX_TAPS / 2) ? 0.5f : 0.0f;
+	}
+}
+
+static const MipTables& GetTables()
+{
+	static MipTables tables;
+	return tables;
+}
+
+unsigned int GetMipCount(unsigned int width, unsigned int height)
+{
+	unsigned int count = 1;
+
+	while (width > 1 || height > 1)
+	{
+		width = width > 1 ? width / 2 : 1;
+		height = height > 1 ? height / 2 : 1;
+		count += 1;
+	}
+
+	return count;
+}
+
+unsigned int GetMipChainSize(unsigned int width, unsigned int height, unsigned int numLevels)
+{
+	unsigned int size = 0;
+
+	for (unsigned int i = 0; i < numLevels; ++i)
+	{
+		size += width * height * 4;
+		width = width > 1 ? width / 2 : 1;
+		height = height > 1 ? height / 2 : 1;
+	}
+
+	return size;
+}
+
+struct MipJob
+{
+	const unsigned char* mSource;
+	unsigned int mWidth;
+	unsigned int mHeight;
+	unsigned char* mTarget;
+	unsigned int mTargetWidth;
+	unsigned int mTargetHeight;
+	MipOptions mOptions;
+};
+
+// Linear box filter on whole bytes, exact (a + b + c + d + 2) / 4 rounding
+static void BoxRows(const MipJob& job, unsigned int firstRow, unsigned int lastRow)
+{
+	unsigned int width = job.mWidth;
+
+	for (unsigned int y = firstRow; y < lastRow; ++y)
+	{
+		const unsigned char* row0 = job.mSource + (size_t)(y * 2) * width * 4;
+		const unsigned char* row1 = job.mSource + (size_t)(y * 2 + 1 < job.mHeight ? y * 2 + 1 : y * 2) * width * 4;
+		unsigned char* target = job.mTarget + (size_t)y * job.mTargetWidth * 4;
+		unsigned int x = 0;
+
+#if MIP_USE_SSE2
+		// Four target pixels from two rows of eight source pixels
+		__m128i zero = _mm_setzero_si128();
+		__m128i two = _mm_set1_epi16(2);
+
+		for (; job.mOptions.mSIMD && width >= 2 && x + 4 <= width / 2; x += 4)
+		{
+			__m128i a0 = _mm_loadu_si128((const __m128i*)(row0 + x * 8));
+			__m128i a1 = _mm_loadu_si128((const __m128i*)(row0 + x * 8 + 16));
+			__m128i b0 = _mm_loadu_si128((const __m128i*)(row1 + x * 8));
+			__m128i b1 = _mm_loadu_si128((const __m128i*)(row1 + x * 8 + 16));
+
+			// Vertical sums of pixel pairs, 16 bits per channel
+			__m128i s0 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+			__m128i s1 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+			__m128i s2 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+			__m128i s3 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+
+			// Horizontal neighbours are the low and high halves of each register
+			__m128i h0 = _mm_add_epi16(_mm_unpacklo_epi64(s0, s1), _mm_unpackhi_epi64(s0, s1));
+			__m128i h1 = _mm_add_epi16(_mm_unpacklo_epi64(s2, s3), _mm_unpackhi_epi64(s2, s3));
+
+			h0 = _mm_srli_epi16(_mm_add_epi16(h0, two), 2);
+			h1 = _mm_srli_epi16(_mm_add_epi16(h1, two), 2);
+			_mm_storeu_si128((__m128i*)(target + x * 4), _mm_packus_epi16(h0, h1));
+		}
+#endif
+
+		for (; x < job.mTargetWidth; ++x)
+		{
+			unsigned int x0 = x * 2;
+			unsigned int x1 = x0 + 1 < width ? x0 + 1 : x0;
+
+			for (unsigned int c = 0; c < 4; ++c)
+			{
+				unsigned int sum = row0[x0 * 4 + c] + row0[x1 * 4 + c] + row1[x0 * 4 + c] + row1[x1 * 4 + c];
+				target[x * 4 + c] = (unsigned char)((sum + 2) / 4);
+			}
+		}
+	}
+}
+
+// sRGB box filter in 16 bit fixed point linear. The sum of four is scaled onto the table's
+// 0..MIP_SRGB_TABLE_SIZE - 1 range, sum * 4095 still fits in 32 bits.
+static void BoxRowsSRGB(const MipJob& job, unsigned int firstRow, unsigned int lastRow)
+{
+	const MipTables& tables = GetTables();
+	const unsigned int fullSum = 4 * 65535;
+	unsigned int width = job.mWidth;
+
+	for (unsigned int y = firstRow; y < lastRow; ++y)
+	{
+		const unsigned char* row0 = job.mSource + (size_t)(y * 2) * width * 4;
+		const unsigned char* row1 = job.mSource + (size_t)(y * 2 + 1 < job.mHeight ? y * 2 + 1 : y * 2) * width * 4;
+		unsigned char* target = job.mTarget + (size_t)y * job.mTargetWidth * 4;
+
+		for (unsigned int x = 0; x < job.mTargetWidth; ++x)
+		{
+			const unsigned char* a = row0 + x * 8;
+			const unsigned char* b = row1 + x * 8;
+			unsigned int next = x * 2 + 1 < width ? 4 : 0;
+
+			for (unsigned int c = 0; c < 3; ++c)
+			{
+				unsigned int sum = tables.mToLinear16[a[c]] + tables.mToLinear16[a[c + next]] + tables.mToLinear16[b[c]] + tables.mToLinear16[b[c + next]];
+				target[x * 4 + c] = tables.mToSRGB[(sum * (MIP_SRGB_TABLE_SIZE - 1) + fullSum / 2) / fullSum];
+			}
+
+			target[x * 4 + 3] = (unsigned char)((a[3] + a[3 + next] + b[3] + b[3 + next] + 2) / 4);
+		}
+	}
+}
+
+struct float4
+{
+	float v[4];
+};
+
+static inline unsigned int ClampIndex(int i, unsigned int size)
+{
+	return i < 0 ? 0 : ((unsigned int)i >= size ? size - 1 : (unsigned int)i);
+}
+
+static void ToLinear(const unsigned char* source, unsigned int width, bool sRGB, bool simd, const MipTables& tables, float4* out)
+{
+	if (sRGB)
+	{
+		for (unsigned int x = 0; x < width; ++x)
+		{
+			const unsigned char* p = source + x * 4;
+			out[x].v[0] = tables.mToLinear[p[0]];
+			out[x].v[1] = tables.mToLinear[p[1]];
+			out[x].v[2] = tables.mToLinear[p[2]];
+			out[x].v[3] = p[3] * (1.0f / 255.0f);
+		}
+		return;
+	}
+
+	unsigned int x = 0;
+#if MIP_USE_SSE2
+	__m128i zero = _mm_setzero_si128();
+	__m128 scale = _mm_set1_ps(1.0f / 255.0f);
+
+	for (; simd && x + 4 <= width; x += 4)
+	{
+		__m128i bytes = _mm_loadu_si128((const __m128i*)(source + x * 4));
+		__m128i low = _mm_unpacklo_epi8(bytes, zero);
+		__m128i high = _mm_unpackhi_epi8(bytes, zero);
+		_mm_storeu_ps(out[x + 0].v, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero)), scale));
+		_mm_storeu_ps(out[x + 1].v, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero)), scale));
+		_mm_storeu_ps(out[x + 2].v, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero)), scale));
+		_mm_storeu_ps(out[x + 3].v, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero)), scale));
+	}
+#endif
+
+	for (; x < width; ++x)
+	{
+		const unsigned char* p = source + x * 4;
+		for (int c = 0; c < 4; ++c)
+		{
+			out[x].v[c] = p[c] * (1.0f / 255.0f);
+		}
+	}
+}
+
+// Filter weights, splatted into SSE registers once per job when the SIMD loops run
+struct MipWeights
+{
+	float mScalar[MIP_MAX_TAPS];
+#if MIP_USE_SSE2
+	__m128 mSplat[MIP_MAX_TAPS];
+#endif
+	int mTaps;
+	bool mSIMD;
+};
+
+// Weighted sum of taps pixels, each step apart in float4s
+static inline void SumTaps(const float4* first, int step, const MipWeights& weights, float4& out)
+{
+#if MIP_USE_SSE2
+	if (weights.mSIMD)
+	{
+		__m128 sum = _mm_mul_ps(weights.mSplat[0], _mm_loadu_ps(first->v));
+		for (int k = 1; k < weights.mTaps; ++k)
+		{
+			sum = _mm_add_ps(sum, _mm_mul_ps(weights.mSplat[k], _mm_loadu_ps(first[k * step].v)));
+		}
+		_mm_storeu_ps(out.v, sum);
+		return;
+	}
+#endif
+
+	for (int c = 0; c < 4; ++c)
+	{
+		float sum = weights.mScalar[0] * first->v[c];
+		for (int k = 1; k < weights.mTaps; ++k)
+		{
+			sum += weights.mScalar[k] * first[k * step].v[c];
+		}
+		out.v[c] = sum;
+	}
+}
+
+// Separable filter in linear float, one pixel per SSE register. Source rows are converted and
+// filtered horizontally once each into a ring of the last taps rows, the vertical pass then
+// reads its taps straight out of the ring.
+static void FilterRows(const MipJob& job, unsigned int firstRow, unsigned int lastRow)
+{
+	const MipTables& tables = GetTables();
+	const bool kaiser = job.mOptions.mFilter == MipFilter::Kaiser;
+	const float* source = kaiser ? tables.mKaiser : tables.mBox + MIP_MAX_TAPS / 2 - 1;
+	const int taps = kaiser ? MIP_MAX_TAPS : 2;
+	const bool simd = MIP_USE_SSE2 && job.mOptions.mSIMD;
+	MipWeights weights;
+	weights.mTaps = taps;
+	weights.mSIMD = simd;
+	for (int k = 0; k < taps; ++k)
+	{
+		weights.mScalar[k] = source[k];
+#if MIP_USE_SSE2
+		weights.mSplat[k] = _mm_set1_ps(source[k]);
+#endif
+	}
+	const int offset = taps / 2 - 1;
+	const bool sRGB = job.mOptions.mSRGB;
+	const unsigned int width = job.mWidth;
+	const unsigned int targetWidth = job.mTargetWidth;
+
+	std::vector<float4> linear(width);
+	std::vector<float4> ring((size_t)taps * targetWidth);
+	// Source rows live at slot (row - ringBase) % taps, ringBase keeps the index positive
+	int ringBase = (int)firstRow * 2 - offset;
+	int nextRow = ringBase;
+
+	// Target pixels whose taps all lie inside the row, the rest clamp
+	unsigned int interiorStart = (unsigned int)(offset + 1) / 2;
+	unsigned int interiorEnd = width >= (unsigned int)(taps - offset) ? (width - (taps - offset)) / 2 + 1 : 0;
+	if (interiorEnd > targetWidth)
+	{
+		interiorEnd = targetWidth;
+	}
+
+	for (unsigned int y = firstRow; y < lastRow; ++y)
+	{
+		int start = (int)y * 2 - offset;
+
+		for (; nextRow < start + taps; ++nextRow)
+		{
+			ToLinear(job.mSource + (size_t)ClampIndex(nextRow, job.mHeight) * width * 4, width, sRGB, simd, tables, &linear[0]);
+			float4* row = &ring[(size_t)((nextRow - ringBase) % taps) * targetWidth];
+
+			for (unsigned int x = 0; x < targetWidth; ++x)
+			{
+				int first = (int)x * 2 - offset;
+
+				if (x >= interiorStart && x < interiorEnd)
+				{
+					SumTaps(&linear[first], 1, weights, row[x]);
+					continue;
+				}
+
+				float4 gathered[MIP_MAX_TAPS];
+				for (int k = 0; k < taps; ++k)
+				{
+					gathered[k] = linear[ClampIndex(first + k, width)];
+				}
+				SumTaps(gathered, 1, weights, row[x]);
+			}
+		}
+
+		const float4* rows[MIP_MAX_TAPS];
+		for (int k = 0; k < taps; ++k)
+		{
+			rows[k] = &ring[(size_t)((start + k - ringBase) % taps) * targetWidth];
+		}
+
+		unsigned char* target = job.mTarget + (size_t)y * targetWidth * 4;
+
+		for (unsigned int x = 0; x < targetWidth; ++x)
+		{
+			float4 sum;
+#if MIP_USE_SSE2
+			if (simd)
+			{
+				__m128 accumulated = _mm_mul_ps(weights.mSplat[0], _mm_loadu_ps(rows[0][x].v));
+				for (int k = 1; k < taps; ++k)
+				{
+					accumulated = _mm_add_ps(accumulated, _mm_mul_ps(weights.mSplat[k], _mm_loadu_ps(rows[k][x].v)));
+				}
+				accumulated = _mm_min_ps(_mm_max_ps(accumulated, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+
+				if (!sRGB)
+				{
+					// Rounds to nearest, then packs the four channels down to bytes
+					__m128i bytes = _mm_cvtps_epi32(_mm_mul_ps(accumulated, _mm_set1_ps(255.0f)));
+					bytes = _mm_packs_epi32(bytes, bytes);
+					bytes = _mm_packus_epi16(bytes, bytes);
+					*(int*)(target + x * 4) = _mm_cvtsi128_si32(bytes);
+					continue;
+				}
+
+				_mm_storeu_ps(sum.v, accumulated);
+			}
+			else
+#endif
+			{
+				for (int c = 0; c < 4; ++c)
+				{
+					float value = weights.mScalar[0] * rows[0][x].v[c];
+					for (int k = 1; k < taps; ++k)
+					{
+						value += weights.mScalar[k] * rows[k][x].v[c];
+					}
+					sum.v[c] = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+				}
+			}
+
+			unsigned char* p = target + x * 4;
+			if (sRGB)
+			{
+				p[0] = tables.mToSRGB[(int)(sum.v[0] * (MIP_SRGB_TABLE_SIZE - 1) + 0.5f)];
+				p[1] = tables.mToSRGB[(int)(sum.v[1] * (MIP_SRGB_TABLE_SIZE - 1) + 0.5f)];
+				p[2] = tables.mToSRGB[(int)(sum.v[2] * (MIP_SRGB_TABLE_SIZE - 1) + 0.5f)];
+			}
+			else
+			{
+				p[0] = (unsigned char)(sum.v[0] * 255.0f + 0.5f);
+				p[1] = (unsigned char)(sum.v[1] * 255.0f + 0.5f);
+				p[2] = (unsigned char)(sum.v[2] * 255.0f + 0.5f);
+			}
+			p[3] = (unsigned char)(sum.v[3] * 255.0f + 0.5f);
+		}
+	}
+}
+
+static void RunRows(const MipJob& job, unsigned int firstRow, unsigned int lastRow)
+{
+	if (job.mOptions.mFilter == MipFilter::Box && !job.mOptions.mSRGB)
+	{
+		BoxRows(job, firstRow, lastRow);
+	}
+	else if (job.mOptions.mFilter == MipFilter::Box)
+	{
+		BoxRowsSRGB(job, firstRow, lastRow);
+	}
+	else
+	{
+		FilterRows(job, firstRow, lastRow);
+	}
+}
+
+void DownsampleRGBA8(const unsigned char* source, unsigned int width, unsigned int height, unsigned char* target, const MipOptions& options)
+{
+	MipJob job;
+	job.mSource = source;
+	job.mWidth = width;
+	job.mHeight = height;
+	job.mTarget = target;
+	job.mTargetWidth = width > 1 ? width / 2 : 1;
+	job.mTargetHeight = height > 1 ? height / 2 : 1;
+	job.mOptions = options;
+
+	ThreadPool* pool = options.mPool;
+	if (pool == 0 || job.mTargetWidth * job.mTargetHeight < MIP_MIN_THREADED_PIXELS)
+	{
+		RunRows(job, 0, job.mTargetHeight);
+		return;
+	}
+
+	unsigned int numBands = pool->GetNumThreads() * MIP_BANDS_PER_THREAD;
+	if (numBands > job.mTargetHeight)
+	{
+		numBands = job.mTargetHeight;
+	}
+
+	for (unsigned int i = 0; i < numBands; ++i)
+	{
+		unsigned int firstRow = job.mTargetHeight * i / numBands;
+		unsigned int lastRow = job.mTargetHeight * (i + 1) / numBands;
+		pool->Submit([&job, firstRow, lastRow]() { RunRows(job, firstRow, lastRow); });
+	}
+
+	pool->Wait();
+}
+
+void GenerateMipChain(unsigned char* chain, unsigned int width, unsigned int height, unsigned int numLevels, const MipOptions& options)
+{
+	unsigned char* level = chain;
+
+	// Every level is filtered from the one before it, so levels run in order and only the
+	// rows of a level are spread over threads
+	for (unsigned int i = 1; i < numLevels; ++i)
+	{
+		unsigned char* next = level + (size_t)width * height * 4;
+		DownsampleRGBA8(level, width, height, next, options);
+
+		level = next;
+		width = width > 1 ? width / 2 : 1;
+		height = height > 1 ? height / 2 : 1;
+	}
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+class ThreadPool;
+
+enum class MipFilter
+{
+	Box,    // 2x2 average
+	Kaiser  // Kaiser windowed sinc over 6x6 source pixels, keeps detail a box blurs away
+};
+
+struct MipOptions
+{
+	MipFilter mFilter;
+	// Color channels are converted to linear before filtering and back after, alpha never is
+	bool mSRGB;
+	// Large levels are split into row bands run on the pool, which should have nothing else queued.
+	// Never pass the pool a job running on it belongs to, the wait would deadlock.
+	ThreadPool* mPool;
+	// False runs the portable loops even where SSE2 is available, which the SSE2 ones are checked against
+	bool mSIMD;
+
+	MipOptions() : mFilter(MipFilter::Box), mSRGB(false), mPool(0), mSIMD(true) { }
+};
+
+// Levels down to 1x1
+unsigned int GetMipCount(unsigned int width, unsigned int height);
+// Bytes of numLevels RGBA8 levels stored back to back, largest first
+unsigned int GetMipChainSize(unsigned int width, unsigned int height, unsigned int numLevels);
+
+// Halves an RGBA8 image, odd sizes round down. target holds max(width / 2, 1) * max(height / 2, 1) pixels.
+void DownsampleRGBA8(const unsigned char* source, unsigned int width, unsigned int height, unsigned char* target, const MipOptions& options);
+// chain holds GetMipChainSize bytes with level 0 already at the start, the other levels are
+// filled in from each previous one
+void GenerateMipChain(unsigned char* chain, unsigned int width, unsigned int height, unsigned int numLevels, const MipOptions& options);
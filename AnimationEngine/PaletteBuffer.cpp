@@ -0,0 +1,95 @@
+#include "PaletteBuffer.h"
+#include <cstring>
+#include <iostream>
+
+PaletteBuffer::PaletteBuffer(unsigned int numSlots, unsigned int numJoints)
+{
+	unsigned int alignment = UniformBuffer::GetOffsetAlignment();
+	unsigned int blockSize = sizeof(mat4) * PALETTE_MAX_JOINTS;
+
+	mNumJoints = numJoints < 1 ? 1 : (numJoints > PALETTE_MAX_JOINTS ? PALETTE_MAX_JOINTS : numJoints);
+	mSlotStride = (sizeof(mat4) * mNumJoints + alignment - 1) / alignment * alignment;
+	mNumSlots = numSlots < 1 ? 1 : numSlots;
+	mDirtyBegin = 0;
+	mDirtyEnd = 0;
+	mBytesUploaded = 0;
+
+	// The last slot's range still has to fit the whole block
+	mData.resize(mSlotStride * (mNumSlots - 1) + blockSize);
+	mBuffer.Resize((unsigned int)mData.size());
+}
+
+void PaletteBuffer::Set(unsigned int slot, const mat4* palette, unsigned int count, unsigned int first)
+{
+	if (slot >= mNumSlots || first + count > mNumJoints)
+	{
+		std::cout << "Palette update out of range: slot " << slot << ", joints " << first << " + " << count << "\n";
+		return;
+	}
+
+	unsigned int begin = slot * mSlotStride + first * sizeof(mat4);
+	unsigned int end = begin + count * sizeof(mat4);
+	memcpy(&mData[begin], palette, count * sizeof(mat4));
+
+	if (mDirtyBegin == mDirtyEnd)
+	{
+		mDirtyBegin = begin;
+		mDirtyEnd = end;
+	}
+	else
+	{
+		mDirtyBegin = begin < mDirtyBegin ? begin : mDirtyBegin;
+		mDirtyEnd = end > mDirtyEnd ? end : mDirtyEnd;
+	}
+}
+
+void PaletteBuffer::Set(unsigned int slot, std::vector<mat4>& palette)
+{
+	Set(slot, palette.size() == 0 ? 0 : &palette[0], (unsigned int)palette.size(), 0);
+}
+
+void PaletteBuffer::Flush()
+{
+	if (mDirtyBegin == mDirtyEnd)
+	{
+		return;
+	}
+
+	if (mDirtyBegin == 0 && mDirtyEnd == (unsigned int)mData.size())
+	{
+		mBuffer.Set(&mData[0], mDirtyEnd);
+	}
+	else
+	{
+		mBuffer.Set(mDirtyBegin, &mData[mDirtyBegin], mDirtyEnd - mDirtyBegin);
+	}
+
+	mBytesUploaded += mDirtyEnd - mDirtyBegin;
+	mDirtyBegin = 0;
+	mDirtyEnd = 0;
+}
+
+void PaletteBuffer::Bind(unsigned int slot)
+{
+	mBuffer.BindTo(UNIFORM_BINDING_PALETTE, slot * mSlotStride, sizeof(mat4) * PALETTE_MAX_JOINTS);
+}
+
+unsigned int PaletteBuffer::GetNumSlots()
+{
+	return mNumSlots;
+}
+
+unsigned int PaletteBuffer::GetNumJoints()
+{
+	return mNumJoints;
+}
+
+unsigned int PaletteBuffer::GetSlotStride()
+{
+	return mSlotStride;
+}
+
+unsigned long long PaletteBuffer::GetBytesUploaded()
+{
+	return mBytesUploaded;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+#include "mat4.h"
+#include "UniformBuffer.h"
+
+// Matches the pose array of the Palette block in skinned.vert
+#define PALETTE_MAX_JOINTS 120
+
+// Skinning palettes of many characters in one uniform buffer. Every character owns a slot,
+// a draw binds its slot's range to UNIFORM_BINDING_PALETTE. Set only touches a CPU copy and
+// widens the dirty range, Flush sends that range with a single upload.
+// Slots are sized for the rig's joint count, not the block's. A bound range always covers the
+// whole block, so it runs into the next slots, which the shader never indexes.
+class PaletteBuffer
+{
+protected:
+	UniformBuffer mBuffer;
+	std::vector<unsigned char> mData;
+	unsigned int mSlotStride;
+	unsigned int mNumSlots;
+	unsigned int mNumJoints;
+	unsigned int mDirtyBegin;
+	unsigned int mDirtyEnd;
+	unsigned long long mBytesUploaded;
+private:
+	PaletteBuffer(const PaletteBuffer&);
+	PaletteBuffer& operator=(const PaletteBuffer&);
+public:
+	PaletteBuffer(unsigned int numSlots, unsigned int numJoints = PALETTE_MAX_JOINTS);
+
+	// Writes joints [first, first + count) of a slot
+	void Set(unsigned int slot, const mat4* palette, unsigned int count, unsigned int first = 0);
+	void Set(unsigned int slot, std::vector<mat4>& palette);
+	void Flush();
+	void Bind(unsigned int slot);
+
+	unsigned int GetNumSlots();
+	unsigned int GetNumJoints();
+	unsigned int GetSlotStride();
+	unsigned long long GetBytesUploaded();
+};
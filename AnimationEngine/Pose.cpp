@@ -0,0 +1,180 @@
+#include "Pose.h"
+
+Pose::Pose()
+{
+}
+
+Pose::Pose(unsigned int numJoints)
+{
+	Resize(numJoints);
+}
+
+Pose::Pose(const Pose& p)
+{
+	*this = p;
+}
+
+Pose& Pose::operator=(const Pose& p)
+{
+	if (&p == this)
+	{
+		return *this;
+	}
+
+	// Assigning the vectors keeps their capacity, so re-using a pose every frame does not allocate
+	mParents = p.mParents;
+	mJoints = p.mJoints;
+
+	return *this;
+}
+
+void Pose::Resize(unsigned int size)
+{
+	mParents.resize(size);
+	mJoints.resize(size);
+}
+
+unsigned int Pose::Size() const
+{
+	return (unsigned int)mJoints.size();
+}
+
+int Pose::GetParent(unsigned int index) const
+{
+	return mParents[index];
+}
+
+void Pose::SetParent(unsigned int index, int parent)
+{
+	mParents[index] = parent;
+}
+
+Transform Pose::GetLocalTransform(unsigned int index) const
+{
+	return mJoints[index];
+}
+
+void Pose::SetLocalTransform(unsigned int index, const Transform& transform)
+{
+	mJoints[index] = transform;
+}
+
+Transform Pose::GetGlobalTransform(unsigned int index) const
+{
+	Transform result = mJoints[index];
+
+	for (int p = mParents[index]; p >= 0; p = mParents[p])
+	{
+		result = combine(mJoints[p], result);
+	}
+
+	return result;
+}
+
+Transform Pose::operator[](unsigned int index) const
+{
+	return GetGlobalTransform(index);
+}
+
+void Pose::GetMatrixPalette(std::vector<mat4>& out) const
+{
+	unsigned int size = Size();
+
+	if (out.size() != size)
+	{
+		out.resize(size);
+	}
+
+	for (unsigned int i = 0; i < size; ++i)
+	{
+		Transform t = GetGlobalTransform(i);
+		out[i] = transformToMat4(t);
+	}
+}
+
+bool Pose::IsInHierarchy(unsigned int root, unsigned int search) const
+{
+	if (search == root)
+	{
+		return true;
+	}
+
+	for (int p = GetParent(search); p >= 0; p = GetParent(p))
+	{
+		if (p == (int)root)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool Pose::operator==(const Pose& other) const
+{
+	if (mJoints.size() != other.mJoints.size())
+	{
+		return false;
+	}
+
+	if (mParents.size() != other.mParents.size())
+	{
+		return false;
+	}
+
+	unsigned int size = (unsigned int)mJoints.size();
+
+	for (unsigned int i = 0; i < size; ++i)
+	{
+		Transform thisLocal = mJoints[i];
+		Transform otherLocal = other.mJoints[i];
+
+		if (mParents[i] != other.mParents[i])
+		{
+			return false;
+		}
+
+		if (thisLocal.position != otherLocal.position || thisLocal.rotation != otherLocal.rotation || thisLocal.scale != otherLocal.scale)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool Pose::operator!=(const Pose& other) const
+{
+	return !(*this == other);
+}
+
+void Blend(Pose& output, const Pose& a, const Pose& b, float t)
+{
+	unsigned int numJoints = output.Size();
+
+	for (unsigned int i = 0; i < numJoints; ++i)
+	{
+		output.SetLocalTransform(i, mix(a.GetLocalTransform(i), b.GetLocalTransform(i), t));
+	}
+}
+
+void Blend(Pose& output, const Pose& a, const Pose& b, float t, const std::vector<bool>& mask)
+{
+	if (mask.size() == 0)
+	{
+		Blend(output, a, b, t);
+		return;
+	}
+
+	unsigned int numJoints = output.Size();
+
+	for (unsigned int i = 0; i < numJoints; ++i)
+	{
+		if (i < mask.size() && !mask[i])
+		{
+			continue;
+		}
+
+		output.SetLocalTransform(i, mix(a.GetLocalTransform(i), b.GetLocalTransform(i), t));
+	}
+}
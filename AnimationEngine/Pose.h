@@ -0,0 +1,35 @@
+#pragma once
+#include <vector>
+#include "Transform.h"
+#include "mat4.h"
+
+class Pose
+{
+protected:
+	std::vector<Transform> mJoints;
+	std::vector<int> mParents;
+public:
+	Pose();
+	Pose(const Pose& p);
+	Pose& operator=(const Pose& p);
+	Pose(unsigned int numJoints);
+
+	void Resize(unsigned int size);
+	unsigned int Size() const;
+	int GetParent(unsigned int index) const;
+	void SetParent(unsigned int index, int parent);
+	Transform GetLocalTransform(unsigned int index) const;
+	void SetLocalTransform(unsigned int index, const Transform& transform);
+	Transform GetGlobalTransform(unsigned int index) const;
+	Transform operator[](unsigned int index) const;
+	void GetMatrixPalette(std::vector<mat4>& out) const;
+	bool IsInHierarchy(unsigned int root, unsigned int search) const;
+
+	bool operator==(const Pose& other) const;
+	bool operator!=(const Pose& other) const;
+};
+
+// Blends the joints of a and b into output, output is expected to have the same size as a and b
+void Blend(Pose& output, const Pose& a, const Pose& b, float t);
+// Only blends the joints set in mask, an empty mask blends every joint
+void Blend(Pose& output, const Pose& a, const Pose& b, float t, const std::vector<bool>& mask);
@@ -0,0 +1,135 @@
+#include "PoseCache.h"
+#include <cmath>
+#include <cstring>
+
+bool PoseCache::Key::operator==(const Key& other) const
+{
+	return mClip == other.mClip && mTime == other.mTime;
+}
+
+size_t PoseCache::KeyHash::operator()(const Key& key) const
+{
+	size_t h = std::hash<const void*>()(key.mClip);
+	size_t t = std::hash<long long>()(key.mTime);
+
+	return h ^ (t + 0x9e3779b9 + (h << 6) + (h >> 2));
+}
+
+PoseCache::PoseCache()
+{
+	mUsed = 0;
+	mTimeQuantum = 0.0f;
+	ResetStats();
+}
+
+PoseCache::PoseCache(float timeQuantum)
+{
+	mUsed = 0;
+	mTimeQuantum = timeQuantum < 0.0f ? 0.0f : timeQuantum;
+	ResetStats();
+}
+
+void PoseCache::SetTimeQuantum(float timeQuantum)
+{
+	mTimeQuantum = timeQuantum < 0.0f ? 0.0f : timeQuantum;
+	BeginFrame();
+}
+
+float PoseCache::GetTimeQuantum() const
+{
+	return mTimeQuantum;
+}
+
+void PoseCache::BeginFrame()
+{
+	mLookup.clear();
+	mUsed = 0;
+
+	mFrameStats.mHits = 0;
+	mFrameStats.mMisses = 0;
+	mFrameStats.mEntries = 0;
+}
+
+const Pose& PoseCache::Sample(Clip& clip, const Pose& restPose, float time)
+{
+	// Wrap looping clips first so agents a whole loop apart still share the sample
+	float duration = clip.GetDuration();
+
+	if (clip.GetLooping() && duration > 0.0f)
+	{
+		time = fmodf(time - clip.GetStartTime(), duration);
+
+		if (time < 0.0f)
+		{
+			time += duration;
+		}
+
+		time = time + clip.GetStartTime();
+	}
+
+	Key key;
+	key.mClip = &clip;
+
+	if (mTimeQuantum > 0.0f)
+	{
+		key.mTime = (long long)floorf(time / mTimeQuantum + 0.5f);
+		time = (float)key.mTime * mTimeQuantum;
+	}
+	else
+	{
+		unsigned int bits = 0;
+		memcpy(&bits, &time, sizeof(float));
+		key.mTime = (long long)bits;
+	}
+
+	std::unordered_map<Key, unsigned int, KeyHash>::iterator it = mLookup.find(key);
+
+	if (it != mLookup.end())
+	{
+		mFrameStats.mHits += 1;
+		mTotalStats.mHits += 1;
+
+		return mPoses[it->second];
+	}
+
+	if (mUsed == mPoses.size())
+	{
+		mPoses.push_back(Pose());
+	}
+
+	unsigned int index = mUsed++;
+	Pose& pose = mPoses[index];
+	pose = restPose;
+	clip.Sample(pose, time);
+	mLookup[key] = index;
+
+	mFrameStats.mMisses += 1;
+	mFrameStats.mEntries = mUsed;
+	mTotalStats.mMisses += 1;
+
+	return pose;
+}
+
+PoseCacheStats PoseCache::GetFrameStats() const
+{
+	return mFrameStats;
+}
+
+PoseCacheStats PoseCache::GetTotalStats() const
+{
+	PoseCacheStats result = mTotalStats;
+	result.mEntries = mUsed;
+
+	return result;
+}
+
+void PoseCache::ResetStats()
+{
+	mFrameStats.mHits = 0;
+	mFrameStats.mMisses = 0;
+	mFrameStats.mEntries = 0;
+
+	mTotalStats.mHits = 0;
+	mTotalStats.mMisses = 0;
+	mTotalStats.mEntries = 0;
+}
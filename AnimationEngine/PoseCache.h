@@ -0,0 +1,57 @@
+#pragma once
+#include <deque>
+#include <unordered_map>
+#include "Clip.h"
+#include "Pose.h"
+
+struct PoseCacheStats
+{
+	unsigned int mHits;
+	unsigned int mMisses;
+	unsigned int mEntries;
+};
+
+// Per frame cache of sampled poses keyed by clip and quantized playback time, so crowd agents
+// playing the same clip at (nearly) the same time share one sample. Agents sharing a clip are
+// expected to share the rest pose too, the first agent to miss provides it.
+class PoseCache
+{
+protected:
+	struct Key
+	{
+		Clip* mClip;
+		long long mTime;
+
+		bool operator==(const Key& other) const;
+	};
+
+	struct KeyHash
+	{
+		size_t operator()(const Key& key) const;
+	};
+
+	std::unordered_map<Key, unsigned int, KeyHash> mLookup;
+	std::deque<Pose> mPoses; // Deque so references handed out earlier in the frame stay valid while it grows
+	unsigned int mUsed;
+	float mTimeQuantum;
+	PoseCacheStats mFrameStats;
+	PoseCacheStats mTotalStats;
+private:
+	PoseCache(const PoseCache&);
+	PoseCache& operator=(const PoseCache&);
+public:
+	PoseCache();
+	PoseCache(float timeQuantum);
+
+	// A quantum of 0 only shares samples taken at exactly the same time
+	void SetTimeQuantum(float timeQuantum);
+	float GetTimeQuantum() const;
+
+	// Drops last frame's entries, the pose storage is kept so a steady state crowd doesn't allocate
+	void BeginFrame();
+	const Pose& Sample(Clip& clip, const Pose& restPose, float time);
+
+	PoseCacheStats GetFrameStats() const;
+	PoseCacheStats GetTotalStats() const;
+	void ResetStats();
+};
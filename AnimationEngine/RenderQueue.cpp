@@ -0,0 +1,220 @@
+#include "RenderQueue.h"
+#include "glad.h"
+#include "GLState.h"
+#include "Shader.h"
+#include "Texture.h"
+#include "Uniform.h"
+#include "PaletteBuffer.h"
+#include <chrono>
+#include <cstdio>
+
+static const StringHash sModelName("model");
+static const StringHash sSamplerName("tex0");
+
+static double MillisecondsSince(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+RenderQueue::RenderQueue()
+{
+	mSortEnabled = true;
+	mStats = RenderQueueStats();
+}
+
+void RenderQueue::Reserve(unsigned int numCommands)
+{
+	mCommands.reserve(numCommands);
+	mItems.reserve(numCommands);
+	mScratch.reserve(numCommands);
+}
+
+unsigned long long RenderQueue::MakeSortKey(unsigned int program, unsigned int texture, unsigned int vertexArray, float depth)
+{
+	if (depth < 0.0f)
+	{
+		depth = 0.0f;
+	}
+	else if (depth > 1.0f)
+	{
+		depth = 1.0f;
+	}
+
+	unsigned long long depthBits = (unsigned long long)(depth * (float)((1u << RENDER_QUEUE_DEPTH_BITS) - 1));
+	unsigned long long key = program & ((1u << RENDER_QUEUE_PROGRAM_BITS) - 1);
+	key = (key << RENDER_QUEUE_TEXTURE_BITS) | (texture & ((1u << RENDER_QUEUE_TEXTURE_BITS) - 1));
+	key = (key << RENDER_QUEUE_VERTEX_ARRAY_BITS) | (vertexArray & ((1u << RENDER_QUEUE_VERTEX_ARRAY_BITS) - 1));
+	key = (key << RENDER_QUEUE_DEPTH_BITS) | depthBits;
+	return key;
+}
+
+void RenderQueue::Submit(const RenderCommand& command, float depth)
+{
+	SortItem item;
+	item.mKey = MakeSortKey(command.mShader->GetHandle(), command.mTexture != 0 ? command.mTexture->GetHandle() : 0, command.mVertexArray->GetHandle(), depth);
+	item.mIndex = (unsigned int)mCommands.size();
+	item.mPad = 0;
+
+	mCommands.push_back(command);
+	mItems.push_back(item);
+}
+
+// Least significant byte first, each pass is a stable counting sort. All eight histograms are
+// built in one read of the keys, a pass whose byte is the same for every key is left out.
+void RenderQueue::Sort()
+{
+	unsigned int size = (unsigned int)mItems.size();
+	mStats.mSortPasses = 0;
+	if (size < 2)
+	{
+		return;
+	}
+
+	unsigned int counts[8][256] = { };
+	for (unsigned int i = 0; i < size; ++i)
+	{
+		unsigned long long key = mItems[i].mKey;
+		for (unsigned int pass = 0; pass < 8; ++pass)
+		{
+			counts[pass][(key >> (pass * 8)) & 0xff] += 1;
+		}
+	}
+
+	mScratch.resize(size);
+	SortItem* source = &mItems[0];
+	SortItem* target = &mScratch[0];
+
+	for (unsigned int pass = 0; pass < 8; ++pass)
+	{
+		unsigned int* count = counts[pass];
+		if (count[(source[0].mKey >> (pass * 8)) & 0xff] == size)
+		{
+			continue;
+		}
+
+		unsigned int offset = 0;
+		for (unsigned int bucket = 0; bucket < 256; ++bucket)
+		{
+			unsigned int bucketSize = count[bucket];
+			count[bucket] = offset;
+			offset += bucketSize;
+		}
+
+		for (unsigned int i = 0; i < size; ++i)
+		{
+			unsigned int bucket = (unsigned int)(source[i].mKey >> (pass * 8)) & 0xff;
+			target[count[bucket]++] = source[i];
+		}
+
+		SortItem* swap = source;
+		source = target;
+		target = swap;
+		mStats.mSortPasses += 1;
+	}
+
+	if (source != &mItems[0])
+	{
+		mItems.swap(mScratch);
+	}
+}
+
+void RenderQueue::Execute()
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	mStats = RenderQueueStats();
+	if (mSortEnabled)
+	{
+		Sort();
+	}
+	mStats.mSortMilliseconds = MillisecondsSince(start);
+
+	start = std::chrono::steady_clock::now();
+	Shader* shader = 0;
+	ShaderLocation model;
+	ShaderLocation sampler;
+	unsigned int texture = 0;
+	unsigned int vertexArray = 0;
+
+	unsigned int size = (unsigned int)mItems.size();
+	for (unsigned int i = 0; i < size; ++i)
+	{
+		RenderCommand& command = mCommands[mItems[i].mIndex];
+
+		if (command.mShader != shader)
+		{
+			shader = command.mShader;
+			shader->Bind();
+			model = shader->FindUniform(sModelName);
+			sampler = shader->FindUniform(sSamplerName);
+			if (shader->IsCurrent(sampler))
+			{
+				Uniform<int>::Set(sampler.mLocation, 0);
+			}
+			mStats.mProgramChanges += 1;
+		}
+
+		if (command.mTexture != 0 && command.mTexture->GetHandle() != texture)
+		{
+			texture = command.mTexture->GetHandle();
+			GLState::BindTexture(0, GL_TEXTURE_2D, texture);
+			mStats.mTextureChanges += 1;
+		}
+
+		if (command.mVertexArray->GetHandle() != vertexArray)
+		{
+			vertexArray = command.mVertexArray->GetHandle();
+			mStats.mVertexArrayChanges += 1;
+		}
+
+		if (command.mPalette != 0)
+		{
+			command.mPalette->Bind(command.mPaletteSlot);
+		}
+
+		if (shader->IsCurrent(model))
+		{
+			Uniform<mat4>::Set(model.mLocation, command.mModel);
+		}
+
+		if (command.mInstances > 1)
+		{
+			DrawInstanced(*command.mVertexArray, command.mMode, command.mInstances);
+		}
+		else
+		{
+			Draw(*command.mVertexArray, command.mMode);
+		}
+	}
+
+	mStats.mDraws = size;
+	mStats.mExecuteMilliseconds = MillisecondsSince(start);
+	Clear();
+}
+
+void RenderQueue::Clear()
+{
+	mCommands.clear();
+	mItems.clear();
+}
+
+void RenderQueue::SetSortEnabled(bool enabled)
+{
+	mSortEnabled = enabled;
+}
+
+unsigned int RenderQueue::GetNumCommands()
+{
+	return (unsigned int)mCommands.size();
+}
+
+const RenderQueueStats& RenderQueue::GetStats()
+{
+	return mStats;
+}
+
+void RenderQueue::Print(const char* label)
+{
+	printf("%-16s draws %6u  programs %5u  textures %5u  vertex arrays %5u  sort %.3f ms (%u passes)  execute %.3f ms\n",
+		label, mStats.mDraws, mStats.mProgramChanges, mStats.mTextureChanges, mStats.mVertexArrayChanges,
+		mStats.mSortMilliseconds, mStats.mSortPasses, mStats.mExecuteMilliseconds);
+}
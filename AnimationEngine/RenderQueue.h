@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vector>
+#include "mat4.h"
+#include "Draw.h"
+
+class Shader;
+class Texture;
+class PaletteBuffer;
+
+// Bits of the sort key from the top: program, texture, vertex array, depth. Ids are truncated to
+// their field, two objects sharing a field only lose grouping, Execute compares the real objects.
+#define RENDER_QUEUE_PROGRAM_BITS 16
+#define RENDER_QUEUE_TEXTURE_BITS 16
+#define RENDER_QUEUE_VERTEX_ARRAY_BITS 16
+#define RENDER_QUEUE_DEPTH_BITS 16
+
+// Everything one draw needs. The shader is expected to have a "model" matrix and,
+// if mTexture is set, a "tex0" sampler, which is bound to unit 0.
+struct RenderCommand
+{
+	Shader* mShader;
+	VertexArray* mVertexArray;
+	Texture* mTexture;
+	PaletteBuffer* mPalette; // Optional, mPaletteSlot is bound before the draw
+	unsigned int mPaletteSlot;
+	unsigned int mInstances; // 1 for a plain draw
+	DrawMode mMode;
+	mat4 mModel;
+
+	inline RenderCommand() : mShader(0), mVertexArray(0), mTexture(0), mPalette(0), mPaletteSlot(0), mInstances(1), mMode(DrawMode::Triangles) { }
+};
+
+struct RenderQueueStats
+{
+	unsigned int mDraws;
+	unsigned int mProgramChanges;
+	unsigned int mTextureChanges;
+	unsigned int mVertexArrayChanges;
+	unsigned int mSortPasses; // Radix passes that ran, a byte shared by every key is skipped
+	double mSortMilliseconds;
+	double mExecuteMilliseconds;
+};
+
+// Collects a frame's draws instead of issuing them, then sorts them by state and issues them
+// with as few program, texture and vertex array changes as possible. Submit only copies the
+// command and builds its key, Execute sorts, draws and clears the queue for the next frame.
+// Sorting moves 16 byte key / index pairs, the commands themselves stay where they were written.
+class RenderQueue
+{
+protected:
+	struct SortItem
+	{
+		unsigned long long mKey;
+		unsigned int mIndex;
+		unsigned int mPad;
+	};
+
+	std::vector<RenderCommand> mCommands;
+	std::vector<SortItem> mItems;
+	std::vector<SortItem> mScratch;
+	RenderQueueStats mStats;
+	bool mSortEnabled;
+	void Sort();
+private:
+	RenderQueue(const RenderQueue&);
+	RenderQueue& operator=(const RenderQueue&);
+public:
+	RenderQueue();
+
+	void Reserve(unsigned int numCommands);
+	// depth is the view depth mapped to [0, 1], nearer draws go first within a state group
+	void Submit(const RenderCommand& command, float depth);
+	void Execute();
+	void Clear();
+
+	// Off issues the commands in submission order, for comparing against the sorted order
+	void SetSortEnabled(bool enabled);
+	unsigned int GetNumCommands();
+	const RenderQueueStats& GetStats();
+	void Print(const char* label);
+
+	static unsigned long long MakeSortKey(unsigned int program, unsigned int texture, unsigned int vertexArray, float depth);
+};
@@ -1,21 +1,33 @@
 #include "Shader.h"
 #include "glad.h"
+#include "GLState.h"
+#include "UniformBuffer.h"
+#include "ShaderCache.h"
+#include "GLExtensions.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <cstring>
+#include <cstdio>
 
-std::string Shader::ReadFile(const std::string& path)
+bool Shader::ReadFile(const std::string& path, std::string& outContents)
 {
-    std::ifstream file; 
-    file.open(path); 
-
+    std::ifstream file(path.c_str()); 
+    
+    if (!file.good()) 
+    {
+        return false; 
+    }
+    
     std::stringstream contents; 
     contents << file.rdbuf(); 
-    file.close(); 
+    outContents = contents.str(); 
     
-    return contents.str();
+    return true;
 }
 
+// Compiles and links are only submitted here, nothing asks for their status until FinishLoad.
+// Asking right away would make the driver finish every compile before the next one is sent.
 unsigned int Shader::CompileVertexShader(const std::string& vertex)
 {
     unsigned int v = glCreateShader(GL_VERTEX_SHADER); 
@@ -24,19 +36,6 @@ unsigned int Shader::CompileVertexShader(const std::string& vertex)
     glShaderSource(v, 1, &v_source, NULL); 
     glCompileShader(v); 
     
-    int success = 0; 
-    glGetShaderiv(v, GL_COMPILE_STATUS, &success); 
-    
-    if (!success) 
-    {
-        char infoLog[512]; 
-        glGetShaderInfoLog(v, 512, NULL, infoLog); 
-        std::cout << "Vertex compilation failed.\n"; 
-        std::cout << "\t" << infoLog << "\n"; 
-        glDeleteShader(v); 
-        return 0;
-    }
-    
     return v;
 }
 
@@ -47,44 +46,61 @@ unsigned int Shader::CompileFragmentShader(const std::string& fragment)
     glShaderSource(f, 1, &f_source, NULL); 
     glCompileShader(f); 
     
+    return f;
+}
+
+void Shader::LinkShaders(unsigned int vertex, unsigned int fragment)
+{
+    glAttachShader(mHandle, vertex); 
+    glAttachShader(mHandle, fragment); 
+    glLinkProgram(mHandle); 
+}
+
+bool Shader::CheckCompileStatus(unsigned int shader, const char* stage)
+{
     int success = 0; 
-    glGetShaderiv(f, GL_COMPILE_STATUS, &success); 
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success); 
     
     if (!success) 
     {
         char infoLog[512]; 
-        glGetShaderInfoLog(f, 512, NULL, infoLog); 
-        std::cout << "Fragment compilation failed.\n"; std::cout << "\t" << infoLog << "\n"; 
-        glDeleteShader(f); 
-        return 0;
-    } 
+        glGetShaderInfoLog(shader, 512, NULL, infoLog); 
+        std::cout << stage << " compilation failed.\n"; 
+        std::cout << "\t" << infoLog << "\n"; 
+        return false;
+    }
     
-    return f;
+    return true;
 }
 
-bool Shader::LinkShaders(unsigned int vertex, unsigned int fragment)
+bool Shader::CheckLinkStatus()
 {
-    glAttachShader(mHandle, vertex); 
-    glAttachShader(mHandle, fragment); 
-    glLinkProgram(mHandle); 
-    
     int success = 0;
     glGetProgramiv(mHandle, GL_LINK_STATUS, &success); 
     
     if (!success) 
     { 
-        char infoLog[512]; 
-        glGetProgramInfoLog(mHandle, 512, NULL, infoLog); 
-        std::cout << "ERROR: Shader linking failed.\n"; std::cout << "\t" << infoLog << "\n"; 
-        glDeleteShader(vertex); 
-        glDeleteShader(fragment); 
-        return false; 
+        // A failed compile fails the link too, its log says more than the linker's
+        bool compiled = CheckCompileStatus(mVertexShader, "Vertex"); 
+        compiled = CheckCompileStatus(mFragmentShader, "Fragment") && compiled; 
+        
+        if (compiled) 
+        {
+            char infoLog[512]; 
+            glGetProgramInfoLog(mHandle, 512, NULL, infoLog); 
+            std::cout << "ERROR: Shader linking failed.\n"; std::cout << "\t" << infoLog << "\n"; 
+        }
     } 
     
-    glDeleteShader(vertex); 
-    glDeleteShader(fragment); 
+    // Detached so a later Load links only its own stages
+    glDetachShader(mHandle, mVertexShader); 
+    glDetachShader(mHandle, mFragmentShader); 
+    glDeleteShader(mVertexShader); 
+    glDeleteShader(mFragmentShader); 
+    mVertexShader = 0; 
+    mFragmentShader = 0; 
     
-    return true;
+    return success != 0;
 }
 
 void Shader::PopulateAttributes()
@@ -95,7 +111,6 @@ void Shader::PopulateAttributes()
     int size; 
     GLenum type; 
     
-    glUseProgram(mHandle);
     glGetProgramiv(mHandle, GL_ACTIVE_ATTRIBUTES, &count); 
     
     for (int i = 0; i < count; ++i) 
@@ -107,11 +122,24 @@ void Shader::PopulateAttributes()
         
         if (attrib >= 0) 
         { 
-            mAttributes[name] = attrib; 
+            StringHash hash(name);
+
+            if (!mAttributes.Insert(hash.mValue, hash.mCheck, attrib))
+            {
+                std::cout << "Attribute name hash collision: " << name << "\n";
+            }
         } 
     } 
-    
-    glUseProgram(0);
+}
+
+void Shader::InsertUniform(const char* name, unsigned int location, unsigned int size)
+{
+    StringHash hash(name);
+
+    if (!mUniforms.Insert(hash.mValue, hash.mCheck, location, size))
+    {
+        std::cout << "Uniform name hash collision: " << name << "\n";
+    }
 }
 
 void Shader::PopulateUniforms()
@@ -123,7 +151,6 @@ void Shader::PopulateUniforms()
     GLenum type; 
     char testName[256]; 
     
-    glUseProgram(mHandle); 
     glGetProgramiv(mHandle, GL_ACTIVE_UNIFORMS, &count); 
     
     for (int i = 0; i < count; ++i) 
@@ -136,125 +163,474 @@ void Shader::PopulateUniforms()
         
         if (uniform >= 0) 
         { // Is uniform valid?
-            std::string uniformName = name; 
-            
-            // if name contains [, uniform is array 
-            std::size_t found = uniformName.find('['); 
-            
-            if (found != std::string::npos) 
+            // Arrays are reported once as name[0] with their length in size, they get a single entry.
+            // Members of struct arrays are reported one by one with the index inside the name and stay as they are.
+            if (length > 3 && strcmp(name + length - 3, "[0]") == 0) 
             {
-                uniformName.erase(uniformName.begin() + found, uniformName.end()); 
-                unsigned int uniformIndex = 0; 
+                name[length - 3] = 0; 
+                
+                // Element locations are consecutive in practice, check the last one once to be sure
+                snprintf(testName, sizeof(testName), "%s[%d]", name, size - 1); 
                 
-                while (true) 
+                if (size > 1 && glGetUniformLocation(mHandle, testName) != uniform + size - 1) 
                 {
-                    memset(testName, 0, sizeof(char) * 256); 
-                    sprintf_s(testName, "%s[%d]", uniformName.c_str(), uniformIndex++); 
-                    
-                    int uniformLocation = glGetUniformLocation(mHandle, testName); 
-                    
-                    if (uniformLocation < 0) 
+                    for (int element = 1; element < size; ++element) 
                     {
-                        break;
-                    } 
+                        snprintf(testName, sizeof(testName), "%s[%d]", name, element); 
+                        int elementLocation = glGetUniformLocation(mHandle, testName); 
+                        
+                        if (elementLocation >= 0) 
+                        {
+                            InsertUniform(testName, elementLocation, 1); 
+                        }
+                    }
                     
-                    mUniforms[testName] = uniformLocation;
+                    size = 1; 
                 }
             }
-
-            mUniforms[uniformName] = uniform;
+            else 
+            {
+                size = 1; 
+            }
+            
+            InsertUniform(name, uniform, size); 
         }
     } 
+}
+
+void Shader::PopulateUniformBlocks()
+{
+    int count = -1; 
+    int length; 
+    char name[128]; 
+    
+    glGetProgramiv(mHandle, GL_ACTIVE_UNIFORM_BLOCKS, &count); 
+    
+    for (int i = 0; i < count; ++i) 
+    {
+        memset(name, 0, sizeof(char) * 128);
+        glGetActiveUniformBlockName(mHandle, (GLuint)i, 128, &length, name); 
+        
+        int size = 0; 
+        glGetActiveUniformBlockiv(mHandle, (GLuint)i, GL_UNIFORM_BLOCK_DATA_SIZE, &size); 
+        
+        StringHash hash(name);
+        
+        if (!mUniformBlocks.Insert(hash.mValue, hash.mCheck, (unsigned int)i, (unsigned int)size)) 
+        {
+            std::cout << "Uniform block name hash collision: " << name << "\n";
+        }
+    }
+    
+    ConnectUniformBlocks(); 
+}
+
+void Shader::ConnectUniformBlocks()
+{
+    // Blocks every program shares are connected to their fixed binding points here
+    BindUniformBlock(StringHash("FrameConstants"), UNIFORM_BINDING_FRAME_CONSTANTS); 
+    BindUniformBlock(StringHash("Palette"), UNIFORM_BINDING_PALETTE); 
+}
+
+void Shader::GetReflection(ShaderReflection& outReflection)
+{
+    mAttributes.GetEntries(outReflection.mAttributes); 
+    mUniforms.GetEntries(outReflection.mUniforms); 
+    mUniformBlocks.GetEntries(outReflection.mUniformBlocks); 
+}
+
+void Shader::SetReflection(const ShaderReflection& reflection)
+{
+    for (unsigned int i = 0, size = (unsigned int)reflection.mAttributes.size(); i < size; ++i) 
+    {
+        mAttributes.Insert(reflection.mAttributes[i].mHash, reflection.mAttributes[i].mCheck, reflection.mAttributes[i].mLocation, reflection.mAttributes[i].mSize); 
+    }
+    
+    for (unsigned int i = 0, size = (unsigned int)reflection.mUniforms.size(); i < size; ++i) 
+    {
+        mUniforms.Insert(reflection.mUniforms[i].mHash, reflection.mUniforms[i].mCheck, reflection.mUniforms[i].mLocation, reflection.mUniforms[i].mSize); 
+    }
+    
+    for (unsigned int i = 0, size = (unsigned int)reflection.mUniformBlocks.size(); i < size; ++i) 
+    {
+        mUniformBlocks.Insert(reflection.mUniformBlocks[i].mHash, reflection.mUniformBlocks[i].mCheck, reflection.mUniformBlocks[i].mLocation, reflection.mUniformBlocks[i].mSize); 
+    }
     
-    glUseProgram(0);
+    // Block bindings are program state that a loaded binary does not keep
+    ConnectUniformBlocks(); 
 }
 
 Shader::Shader()
 {
     mHandle = glCreateProgram();
+    mGeneration = 0;
+    mVertexShader = 0;
+    mFragmentShader = 0;
+    mCacheKey = 0;
+    mPending = false;
+    mLinked = false;
 }
 
 Shader::Shader(const std::string& vertex, const std::string& fragment)
 {
     mHandle = glCreateProgram(); 
+    mGeneration = 0;
+    mVertexShader = 0;
+    mFragmentShader = 0;
+    mCacheKey = 0;
+    mPending = false;
+    mLinked = false;
     Load(vertex, fragment);
 }
 
 Shader::~Shader()
 {
+    if (mPending)
+    {
+        glDetachShader(mHandle, mVertexShader);
+        glDetachShader(mHandle, mFragmentShader);
+        glDeleteShader(mVertexShader);
+        glDeleteShader(mFragmentShader);
+    }
+    
+    GLState::OnDeleteProgram(mHandle);
     glDeleteProgram(mHandle);
 }
 
 void Shader::Load(const std::string& vertex, const std::string& fragment)
 {
-    std::ifstream f(vertex.c_str()); 
+    BeginLoad(vertex, fragment);
+    FinishLoad();
+}
+
+void Shader::BeginLoad(const std::string& vertex, const std::string& fragment)
+{
+    // A load that was never finished is finished now, its stages are still attached
+    FinishLoad();
     
-    bool vertFile = f.good(); 
-    f.close(); 
+    // Arguments that are not readable files are the sources themselves
+    std::string v_source = vertex; 
+    ReadFile(vertex, v_source); 
     
-    f = std::ifstream(vertex.c_str()); 
-    bool fragFile = f.good(); 
-    f.close(); 
+    std::string f_source = fragment;
+    ReadFile(fragment, f_source); 
     
-    std::string v_source = vertex; 
+    mAttributes.Clear();
+    mUniforms.Clear();
+    mUniformBlocks.Clear();
+    mCacheKey = 0;
     
-    if (vertFile) 
-    { 
-        v_source = ReadFile(vertex); 
-    } 
+    if (ShaderCache::IsEnabled()) 
+    {
+        ShaderReflection reflection; 
+        mCacheKey = ShaderCache::MakeKey(v_source, f_source); 
+        
+        if (ShaderCache::Load(mCacheKey, mHandle, reflection)) 
+        {
+            SetReflection(reflection); 
+            mLinked = true; 
+            
+            // Locations handed out before this load may no longer match the program
+            mGeneration += 1; 
+            return; 
+        }
+    }
     
-    std::string f_source = fragment;
+    mVertexShader = CompileVertexShader(v_source); 
+    mFragmentShader = CompileFragmentShader(f_source); 
+    ShaderCache::PrepareProgram(mHandle); 
+    LinkShaders(mVertexShader, mFragmentShader); 
+    mPending = true; 
+    mLinked = false; 
+}
+
+bool Shader::IsReady()
+{
+    if (!mPending) 
+    {
+        return true; 
+    }
     
-    if (fragFile) 
-    { 
-        f_source = ReadFile(fragment); 
-    } 
+    // Without the extension there is no way to ask, FinishLoad waits for the driver
+    if (!GLExtensions::HasParallelShaderCompile()) 
+    {
+        return true; 
+    }
     
-    unsigned int vert = CompileVertexShader(v_source); 
+    int complete = 0; 
+    glGetProgramiv(mHandle, GL_COMPLETION_STATUS_KHR, &complete); 
     
-    unsigned int frag = CompileFragmentShader(f_source); 
+    return complete != 0;
+}
+
+bool Shader::FinishLoad()
+{
+    if (!mPending) 
+    {
+        return mLinked; 
+    }
     
-    if (LinkShaders(vert, frag)) 
+    mPending = false; 
+    mLinked = CheckLinkStatus(); 
+    
+    if (mLinked) 
     { 
         PopulateAttributes(); 
         PopulateUniforms(); 
+        PopulateUniformBlocks(); 
+        
+        if (ShaderCache::IsEnabled()) 
+        {
+            ShaderReflection reflection; 
+            GetReflection(reflection); 
+            ShaderCache::Store(mCacheKey, mHandle, reflection); 
+        }
     }
+    
+    // Locations handed out before this load may no longer match the program
+    mGeneration += 1;
+    
+    return mLinked;
+}
+
+bool Shader::IsPending()
+{
+    return mPending;
 }
 
 void Shader::Bind()
 {
-    glUseProgram(mHandle);
+    GLState::UseProgram(mHandle);
 }
 
 void Shader::UnBind()
 {
-    glUseProgram(0);
+    // The program stays bound until another shader binds, see GLState
 }
 
 unsigned int Shader::GetAttribute(const std::string& name)
 {
-    std::map<std::string, unsigned int>::iterator it = mAttributes.find(name); 
+    unsigned int location = 0;
     
-    if (it == mAttributes.end()) 
+    StringHash hash(name);
+    
+    if (!mAttributes.Find(hash.mValue, hash.mCheck, location)) 
     { 
         std::cout << "Bad attrib index: " << name << "\n"; 
         return 0; 
     } 
     
-    return it->second;
+    return location;
+}
+
+unsigned int Shader::GetAttribute(const char* name)
+{
+    unsigned int location = 0;
+    
+    StringHash hash(name);
+    
+    if (!mAttributes.Find(hash.mValue, hash.mCheck, location)) 
+    { 
+        std::cout << "Bad attrib index: " << name << "\n"; 
+        return 0; 
+    } 
+    
+    return location;
+}
+
+unsigned int Shader::GetAttribute(StringHash name)
+{
+    unsigned int location = 0;
+    
+    if (!mAttributes.Find(name.mValue, name.mCheck, location)) 
+    { 
+        std::cout << "Bad attrib index: hash " << std::hex << name.mValue << std::dec << "\n"; 
+        return 0; 
+    } 
+    
+    return location;
+}
+
+bool Shader::FindUniformElement(StringHash name, unsigned int index, unsigned int& outLocation)
+{
+    unsigned int size = 0;
+    
+    if (mUniforms.Find(name.mValue, name.mCheck, outLocation, size) && index < size)
+    {
+        outLocation += index;
+        return true;
+    }
+    
+    // Arrays without consecutive locations are stored per element, FNV-1a can hash the suffix on its own
+    char suffix[16];
+    int length = snprintf(suffix, sizeof(suffix), "[%u]", index);
+    StringHash element = name.Append(suffix, (unsigned int)length);
+    
+    return mUniforms.Find(element.mValue, element.mCheck, outLocation);
+}
+
+bool Shader::FindUniformByName(const char* name, unsigned int length, unsigned int& outLocation)
+{
+    StringHash hash(name, length);
+    
+    if (mUniforms.Find(hash.mValue, hash.mCheck, outLocation))
+    {
+        return true;
+    }
+    
+    // name[i] goes through the entry of the array
+    if (length < 4 || name[length - 1] != ']')
+    {
+        return false;
+    }
+    
+    unsigned int open = length - 2;
+    
+    while (open > 0 && name[open] != '[')
+    {
+        --open;
+    }
+    
+    if (open == 0 || open == length - 2)
+    {
+        return false;
+    }
+    
+    unsigned int index = 0;
+    
+    for (unsigned int i = open + 1; i < length - 1; ++i)
+    {
+        if (name[i] < '0' || name[i] > '9')
+        {
+            return false;
+        }
+        
+        index = index * 10 + (unsigned int)(name[i] - '0');
+    }
+    
+    return FindUniformElement(StringHash(name, open), index, outLocation);
 }
 
 unsigned int Shader::GetUniform(const std::string& name)
 {
-    std::map<std::string, unsigned int>::iterator it = mUniforms.find(name);
+    unsigned int location = 0;
+
+    if (!FindUniformByName(name.c_str(), (unsigned int)name.size(), location))
+    {
+        std::cout << "Bad uniform index: " << name << "\n";
+        return 0;
+    }
+
+    return location;
+}
+
+unsigned int Shader::GetUniform(const char* name)
+{
+    unsigned int location = 0;
 
-    if (it == mUniforms.end())
+    if (!FindUniformByName(name, (unsigned int)strlen(name), location))
     {
         std::cout << "Bad uniform index: " << name << "\n";
         return 0;
     }
 
-    return it->second;
+    return location;
+}
+
+unsigned int Shader::GetUniform(StringHash name)
+{
+    unsigned int location = 0;
+
+    if (!mUniforms.Find(name.mValue, name.mCheck, location))
+    {
+        std::cout << "Bad uniform index: hash " << std::hex << name.mValue << std::dec << "\n";
+        return 0;
+    }
+
+    return location;
+}
+
+unsigned int Shader::GetUniform(StringHash name, unsigned int index)
+{
+    unsigned int location = 0;
+
+    if (!FindUniformElement(name, index, location))
+    {
+        std::cout << "Bad uniform index: hash " << std::hex << name.mValue << std::dec << "[" << index << "]\n";
+        return 0;
+    }
+
+    return location;
+}
+
+ShaderLocation Shader::FindAttribute(StringHash name)
+{
+    ShaderLocation result;
+
+    if (mAttributes.Find(name.mValue, name.mCheck, result.mLocation))
+    {
+        result.mGeneration = mGeneration;
+    }
+
+    return result;
+}
+
+ShaderLocation Shader::FindUniform(StringHash name)
+{
+    ShaderLocation result;
+
+    if (mUniforms.Find(name.mValue, name.mCheck, result.mLocation, result.mSize))
+    {
+        result.mGeneration = mGeneration;
+    }
+
+    return result;
+}
+
+ShaderLocation Shader::FindUniform(StringHash name, unsigned int index)
+{
+    ShaderLocation result;
+
+    if (FindUniformElement(name, index, result.mLocation))
+    {
+        result.mGeneration = mGeneration;
+    }
+
+    return result;
+}
+
+bool Shader::BindUniformBlock(StringHash name, unsigned int binding)
+{
+    unsigned int index = 0;
+    
+    if (!mUniformBlocks.Find(name.mValue, name.mCheck, index))
+    {
+        return false;
+    }
+    
+    glUniformBlockBinding(mHandle, index, binding);
+    
+    return true;
+}
+
+unsigned int Shader::GetUniformBlockSize(StringHash name)
+{
+    unsigned int index = 0;
+    unsigned int size = 0;
+    
+    mUniformBlocks.Find(name.mValue, name.mCheck, index, size);
+    
+    return size;
+}
+
+bool Shader::IsCurrent(const ShaderLocation& location)
+{
+    return location.mGeneration != 0 && location.mGeneration == mGeneration;
+}
+
+unsigned int Shader::GetGeneration()
+{
+    return mGeneration;
 }
 
 unsigned int Shader::GetHandle()
@@ -1,30 +1,82 @@
 #pragma once
-#include <map>
 #include <string>
+#include "StringHash.h"
+#include "LocationTable.h"
+
+struct ShaderReflection;
+
+// Location looked up once after Load so render loops don't search by name.
+// mGeneration is the shader load it came from, 0 if the name was not found.
+// Array elements are at mLocation + i for i < mSize.
+struct ShaderLocation
+{
+	unsigned int mLocation;
+	unsigned int mSize;
+	unsigned int mGeneration;
+
+	inline ShaderLocation() : mLocation(0), mSize(1), mGeneration(0) { }
+};
 
 class Shader {
 private: 
 	unsigned int mHandle; 
-	std::map<std::string, unsigned int> mAttributes; 
-	std::map<std::string, unsigned int> mUniforms;
+	LocationTable mAttributes; 
+	LocationTable mUniforms;
+	LocationTable mUniformBlocks; // Block index, with the block's data size in bytes
+	unsigned int mGeneration;
+	unsigned int mVertexShader;   // Stages of a load that has not been finished
+	unsigned int mFragmentShader;
+	unsigned long long mCacheKey;
+	bool mPending;
+	bool mLinked;
 private: 
 	Shader(const Shader&); 
 	Shader& operator=(const Shader& other);
 private: 
-	std::string ReadFile(const std::string& path);
+	bool ReadFile(const std::string& path, std::string& outContents);
 	unsigned int CompileVertexShader(const std::string& vertex); 
 	unsigned int CompileFragmentShader(const std::string& fragment); 
-	bool LinkShaders(unsigned int vertex, unsigned int fragment); 
+	void LinkShaders(unsigned int vertex, unsigned int fragment); 
+	bool CheckCompileStatus(unsigned int shader, const char* stage); 
+	bool CheckLinkStatus(); 
 	void PopulateAttributes(); 
 	void PopulateUniforms();
+	void PopulateUniformBlocks();
+	void ConnectUniformBlocks();
+	void GetReflection(ShaderReflection& outReflection);
+	void SetReflection(const ShaderReflection& reflection);
+	void InsertUniform(const char* name, unsigned int location, unsigned int size);
+	bool FindUniformElement(StringHash name, unsigned int index, unsigned int& outLocation);
+	bool FindUniformByName(const char* name, unsigned int length, unsigned int& outLocation);
 public: 
 	Shader(); 
 	Shader(const std::string& vertex, const std::string& fragment); 
 	~Shader(); 
 	void Load(const std::string& vertex, const std::string& fragment);
+	// Load in two halves. BeginLoad submits the compiles and the link without waiting on them,
+	// IsReady polls without blocking where the driver compiles in parallel, FinishLoad checks
+	// the results and introspects. Lookups are only valid after FinishLoad.
+	void BeginLoad(const std::string& vertex, const std::string& fragment);
+	bool IsReady();
+	bool FinishLoad();
+	bool IsPending();
 	void Bind(); 
 	void UnBind(); 
 	unsigned int GetAttribute(const std::string& name); 
+	unsigned int GetAttribute(const char* name); 
+	unsigned int GetAttribute(StringHash name); 
 	unsigned int GetUniform(const std::string& name); 
+	unsigned int GetUniform(const char* name); 
+	unsigned int GetUniform(StringHash name); 
+	unsigned int GetUniform(StringHash name, unsigned int index); 
+	// Quiet lookups for callers that cache the result, check IsCurrent after a reload
+	ShaderLocation FindAttribute(StringHash name); 
+	ShaderLocation FindUniform(StringHash name); 
+	ShaderLocation FindUniform(StringHash name, unsigned int index); 
+	bool IsCurrent(const ShaderLocation& location); 
+	// Connects a uniform block to a binding point, returns false if the program has no such block
+	bool BindUniformBlock(StringHash name, unsigned int binding); 
+	unsigned int GetUniformBlockSize(StringHash name); 
+	unsigned int GetGeneration();
 	unsigned int GetHandle();
 };
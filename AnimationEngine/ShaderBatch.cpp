@@ -0,0 +1,132 @@
+#include "ShaderBatch.h"
+#include <algorithm>
+#include <iostream>
+
+ShaderBatch::ShaderBatch()
+{
+	mNumLoaded = 0;
+	mNumFailed = 0;
+	mMilliseconds = 0.0;
+	mTiming = false;
+}
+
+void ShaderBatch::Add(Shader& shader, const std::string& vertex, const std::string& fragment)
+{
+	if (!mTiming)
+	{
+		mStart = std::chrono::steady_clock::now();
+		mTiming = true;
+	}
+
+	// A shader that is still pending gets its entry replaced, BeginLoad finishes the old load
+	// and only the new one is counted
+	std::vector<Shader*>::iterator existing = std::find(mPending.begin(), mPending.end(), &shader);
+	if (existing != mPending.end())
+	{
+		mPending.erase(existing);
+	}
+
+	shader.BeginLoad(vertex, fragment);
+
+	// Program cache hits are complete as soon as BeginLoad returns
+	if (shader.IsPending())
+	{
+		mPending.push_back(&shader);
+	}
+	else
+	{
+		mNumLoaded += 1;
+	}
+}
+
+unsigned int ShaderBatch::Poll()
+{
+	unsigned int kept = 0;
+	unsigned int size = (unsigned int)mPending.size();
+
+	for (unsigned int i = 0; i < size; ++i)
+	{
+		Shader* shader = mPending[i];
+
+		if (!shader->IsReady())
+		{
+			mPending[kept++] = shader;
+			continue;
+		}
+
+		if (shader->FinishLoad())
+		{
+			mNumLoaded += 1;
+		}
+		else
+		{
+			mNumFailed += 1;
+		}
+	}
+
+	mPending.resize(kept);
+
+	if (kept == 0)
+	{
+		StopTiming();
+	}
+
+	return kept;
+}
+
+void ShaderBatch::Finish()
+{
+	for (unsigned int i = 0, size = (unsigned int)mPending.size(); i < size; ++i)
+	{
+		if (mPending[i]->FinishLoad())
+		{
+			mNumLoaded += 1;
+		}
+		else
+		{
+			mNumFailed += 1;
+		}
+	}
+
+	mPending.clear();
+	StopTiming();
+}
+
+void ShaderBatch::StopTiming()
+{
+	if (mTiming)
+	{
+		mMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - mStart).count();
+		mTiming = false;
+	}
+}
+
+bool ShaderBatch::IsDone()
+{
+	return mPending.size() == 0;
+}
+
+unsigned int ShaderBatch::GetNumPending()
+{
+	return (unsigned int)mPending.size();
+}
+
+unsigned int ShaderBatch::GetNumLoaded()
+{
+	return mNumLoaded;
+}
+
+unsigned int ShaderBatch::GetNumFailed()
+{
+	return mNumFailed;
+}
+
+double ShaderBatch::GetMilliseconds()
+{
+	return mMilliseconds;
+}
+
+void ShaderBatch::Print(const char* label)
+{
+	std::cout << label << ": " << mNumLoaded << " shaders loaded, " << mNumFailed << " failed, " << mPending.size() << " pending, " << mMilliseconds << " ms\n";
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include "Shader.h"
+
+// Loads many shaders without waiting on any single one. Add submits a shader's compiles and link
+// right away, Poll finishes the ones the driver reports done and can run every Update until
+// IsDone, Finish waits for the rest. With KHR_parallel_shader_compile the driver compiles on its
+// own threads in the meantime, without it Poll finishes everything on the first call.
+class ShaderBatch
+{
+protected:
+	std::vector<Shader*> mPending;
+	unsigned int mNumLoaded;
+	unsigned int mNumFailed;
+	// Wall time from the first Add until the last pending shader finished
+	std::chrono::steady_clock::time_point mStart;
+	double mMilliseconds;
+	bool mTiming;
+	void StopTiming();
+private:
+	ShaderBatch(const ShaderBatch&);
+	ShaderBatch& operator=(const ShaderBatch&);
+public:
+	ShaderBatch();
+
+	// The shader has to outlive the batch or be finished first. Adding a shader that is still
+	// pending replaces its load.
+	void Add(Shader& shader, const std::string& vertex, const std::string& fragment);
+	// Never blocks when the driver can report completion, returns how many are still pending
+	unsigned int Poll();
+	void Finish();
+
+	bool IsDone();
+	unsigned int GetNumPending();
+	unsigned int GetNumLoaded();
+	unsigned int GetNumFailed();
+	double GetMilliseconds();
+	void Print(const char* label);
+};
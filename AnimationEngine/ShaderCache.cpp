@@ -0,0 +1,268 @@
+#include "ShaderCache.h"
+#include "GLExtensions.h"
+#include "StringHash.h"
+#include <fstream>
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#if defined(_WIN32)
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+#define SHADER_CACHE_MAGIC 0x43534541 // "AESC"
+#define SHADER_CACHE_VERSION 2 // 2 added the 64 bit name check to the location entries
+
+struct ShaderCacheHeader
+{
+	unsigned int mMagic;
+	unsigned int mVersion;
+	unsigned long long mKey;
+	unsigned int mBinaryFormat;
+	unsigned int mBinaryLength;
+	unsigned int mNumAttributes;
+	unsigned int mNumUniforms;
+	unsigned int mNumUniformBlocks;
+	unsigned int mPadding;
+};
+
+static std::string sDirectory;
+static ShaderCacheStats sStats;
+static bool sDirectoryCreated = false;
+
+static std::string CachePath(unsigned long long key)
+{
+	char name[32];
+	snprintf(name, sizeof(name), "%016llx.bin", key);
+
+	return sDirectory + name;
+}
+
+static unsigned long long HashDriverString(GLenum name, unsigned long long hash)
+{
+	const char* value = (const char*)glGetString(name);
+
+	if (value == 0)
+	{
+		return hash;
+	}
+
+	return HashString64(value, (unsigned int)strlen(value) + 1, hash);
+}
+
+static bool ReadEntries(std::ifstream& file, unsigned int count, std::vector<LocationTableEntry>& out)
+{
+	out.resize(count);
+
+	if (count == 0)
+	{
+		return true;
+	}
+
+	file.read((char*)&out[0], sizeof(LocationTableEntry) * count);
+
+	return file.good();
+}
+
+static void WriteEntries(std::ofstream& file, const std::vector<LocationTableEntry>& entries)
+{
+	if (entries.size() > 0)
+	{
+		file.write((const char*)&entries[0], sizeof(LocationTableEntry) * entries.size());
+	}
+}
+
+void ShaderCache::SetDirectory(const std::string& directory)
+{
+	sDirectory = directory;
+	sDirectoryCreated = false;
+
+	if (!sDirectory.empty() && sDirectory[sDirectory.size() - 1] != '/' && sDirectory[sDirectory.size() - 1] != '\\')
+	{
+		sDirectory += '/';
+	}
+}
+
+const std::string& ShaderCache::GetDirectory()
+{
+	return sDirectory;
+}
+
+bool ShaderCache::IsEnabled()
+{
+	return !sDirectory.empty() && GLExtensions::HasProgramBinary();
+}
+
+unsigned long long ShaderCache::MakeKey(const std::string& vertex, const std::string& fragment)
+{
+	// The terminators keep "ab" + "c" and "a" + "bc" apart
+	unsigned long long hash = HashString64(vertex.c_str(), (unsigned int)vertex.size() + 1, STRING_HASH64_OFFSET);
+	hash = HashString64(fragment.c_str(), (unsigned int)fragment.size() + 1, hash);
+	hash = HashDriverString(GL_VENDOR, hash);
+	hash = HashDriverString(GL_RENDERER, hash);
+	hash = HashDriverString(GL_VERSION, hash);
+
+	return hash;
+}
+
+void ShaderCache::PrepareProgram(unsigned int program)
+{
+	if (IsEnabled())
+	{
+		GLExtensions::ProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
+}
+
+bool ShaderCache::Load(unsigned long long key, unsigned int program, ShaderReflection& outReflection)
+{
+	if (!IsEnabled())
+	{
+		return false;
+	}
+
+	std::ifstream file(CachePath(key).c_str(), std::ios::binary | std::ios::ate);
+
+	if (!file.good())
+	{
+		sStats.mMisses += 1;
+		return false;
+	}
+
+	unsigned long long fileSize = (unsigned long long)file.tellg();
+	file.seekg(0);
+
+	ShaderCacheHeader header;
+	file.read((char*)&header, sizeof(ShaderCacheHeader));
+
+	// Store writes exactly this much, so damaged counts are caught before they size any allocation
+	unsigned long long expectedSize = sizeof(ShaderCacheHeader) + (unsigned long long)header.mBinaryLength +
+		sizeof(LocationTableEntry) * ((unsigned long long)header.mNumAttributes + header.mNumUniforms + header.mNumUniformBlocks);
+
+	if (!file.good() || header.mMagic != SHADER_CACHE_MAGIC || header.mVersion != SHADER_CACHE_VERSION || header.mKey != key ||
+		expectedSize != fileSize ||
+		!ReadEntries(file, header.mNumAttributes, outReflection.mAttributes) ||
+		!ReadEntries(file, header.mNumUniforms, outReflection.mUniforms) ||
+		!ReadEntries(file, header.mNumUniformBlocks, outReflection.mUniformBlocks))
+	{
+		sStats.mRejected += 1;
+		return false;
+	}
+
+	std::vector<unsigned char> binary(header.mBinaryLength);
+
+	if (header.mBinaryLength > 0)
+	{
+		file.read((char*)&binary[0], header.mBinaryLength);
+	}
+
+	if (header.mBinaryLength == 0 || !file.good())
+	{
+		sStats.mRejected += 1;
+		return false;
+	}
+
+	// Drivers may refuse a binary at any time, after an update that kept the version string for example
+	GLExtensions::ProgramBinary(program, header.mBinaryFormat, &binary[0], (GLsizei)header.mBinaryLength);
+
+	int success = 0;
+	glGetProgramiv(program, GL_LINK_STATUS, &success);
+
+	if (!success)
+	{
+		sStats.mRejected += 1;
+		return false;
+	}
+
+	sStats.mHits += 1;
+
+	return true;
+}
+
+void ShaderCache::Store(unsigned long long key, unsigned int program, const ShaderReflection& reflection)
+{
+	if (!IsEnabled())
+	{
+		return;
+	}
+
+	int length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+
+	if (length <= 0)
+	{
+		return;
+	}
+
+	std::vector<unsigned char> binary(length);
+	GLenum format = 0;
+	GLsizei written = 0;
+	GLExtensions::GetProgramBinary(program, length, &written, &format, &binary[0]);
+
+	if (written <= 0)
+	{
+		return;
+	}
+
+	if (!sDirectoryCreated)
+	{
+		std::string directory = sDirectory.substr(0, sDirectory.size() - 1);
+#if defined(_WIN32)
+		_mkdir(directory.c_str());
+#else
+		mkdir(directory.c_str(), 0755);
+#endif
+		sDirectoryCreated = true;
+	}
+
+	ShaderCacheHeader header;
+	memset(&header, 0, sizeof(ShaderCacheHeader));
+	header.mMagic = SHADER_CACHE_MAGIC;
+	header.mVersion = SHADER_CACHE_VERSION;
+	header.mKey = key;
+	header.mBinaryFormat = format;
+	header.mBinaryLength = (unsigned int)written;
+	header.mNumAttributes = (unsigned int)reflection.mAttributes.size();
+	header.mNumUniforms = (unsigned int)reflection.mUniforms.size();
+	header.mNumUniformBlocks = (unsigned int)reflection.mUniformBlocks.size();
+
+	// Written next to the final name and renamed, so a crash never leaves a truncated cache entry
+	std::string path = CachePath(key);
+	std::string temporary = path + ".tmp";
+
+	{
+		std::ofstream file(temporary.c_str(), std::ios::binary | std::ios::trunc);
+
+		if (!file.good())
+		{
+			std::cout << "Could not write shader cache entry " << temporary << "\n";
+			return;
+		}
+
+		file.write((const char*)&header, sizeof(ShaderCacheHeader));
+		WriteEntries(file, reflection.mAttributes);
+		WriteEntries(file, reflection.mUniforms);
+		WriteEntries(file, reflection.mUniformBlocks);
+		file.write((const char*)&binary[0], written);
+	}
+
+	remove(path.c_str());
+
+	if (rename(temporary.c_str(), path.c_str()) != 0)
+	{
+		remove(temporary.c_str());
+		return;
+	}
+
+	sStats.mStored += 1;
+}
+
+const ShaderCacheStats& ShaderCache::GetStats()
+{
+	return sStats;
+}
+
+void ShaderCache::ResetStats()
+{
+	memset(&sStats, 0, sizeof(ShaderCacheStats));
+}
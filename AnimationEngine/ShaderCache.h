@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "LocationTable.h"
+
+// Introspection results stored next to a program binary, so a program loaded from the
+// cache does not have to query its attributes, uniforms and blocks again
+struct ShaderReflection
+{
+	std::vector<LocationTableEntry> mAttributes;
+	std::vector<LocationTableEntry> mUniforms;
+	std::vector<LocationTableEntry> mUniformBlocks;
+};
+
+struct ShaderCacheStats
+{
+	unsigned int mHits;
+	unsigned int mMisses;
+	unsigned int mRejected; // Entries found on disk that were damaged or that the driver refused, they are rebuilt
+	unsigned int mStored;
+};
+
+// Program binaries on disk, one file per program keyed by a hash of both sources and the
+// driver's vendor, renderer and version strings. A new driver or edited source misses the cache
+// and the program is compiled as usual. Disabled until a directory is set, and always off when
+// the driver has no binary formats.
+class ShaderCache
+{
+private:
+	ShaderCache();
+	ShaderCache(const ShaderCache&);
+	ShaderCache& operator=(const ShaderCache&);
+	~ShaderCache();
+public:
+	// An empty path disables the cache, the directory is created when the first binary is stored
+	static void SetDirectory(const std::string& directory);
+	static const std::string& GetDirectory();
+	static bool IsEnabled();
+
+	static unsigned long long MakeKey(const std::string& vertex, const std::string& fragment);
+	// Asks the driver to keep the binary around, call before linking a program that will be stored
+	static void PrepareProgram(unsigned int program);
+	// On success the program is linked and the reflection is filled in
+	static bool Load(unsigned long long key, unsigned int program, ShaderReflection& outReflection);
+	static void Store(unsigned long long key, unsigned int program, const ShaderReflection& reflection);
+
+	static const ShaderCacheStats& GetStats();
+	static void ResetStats();
+};
@@ -0,0 +1,158 @@
+#include "StreamBuffer.h"
+#include "GLExtensions.h"
+#include "GLState.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#define STREAM_BUFFER_ALIGNMENT 16
+
+StreamBuffer::StreamBuffer(unsigned int segmentSize, unsigned int numSegments)
+{
+	mSegmentSize = (segmentSize + STREAM_BUFFER_ALIGNMENT - 1) & ~(STREAM_BUFFER_ALIGNMENT - 1);
+	mNumSegments = numSegments < 1 ? 1 : (numSegments > STREAM_BUFFER_MAX_SEGMENTS ? STREAM_BUFFER_MAX_SEGMENTS : numSegments);
+	mSegment = 0;
+	mHead = 0;
+	mMapped = 0;
+	memset(mFences, 0, sizeof(mFences));
+	ResetStats();
+
+	unsigned int size = mSegmentSize * mNumSegments;
+	glGenBuffers(1, &mHandle);
+	GLState::BindBuffer(GL_COPY_WRITE_BUFFER, mHandle);
+
+	if (GLExtensions::HasBufferStorage())
+	{
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		GLExtensions::BufferStorage(GL_COPY_WRITE_BUFFER, size, 0, flags);
+		mMapped = (unsigned char*)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, size, flags);
+
+		if (mMapped == 0)
+		{
+			std::cout << "Could not map stream buffer persistently\n";
+		}
+	}
+	else
+	{
+		glBufferData(GL_COPY_WRITE_BUFFER, size, 0, GL_STREAM_DRAW);
+	}
+}
+
+StreamBuffer::~StreamBuffer()
+{
+	for (unsigned int i = 0; i < mNumSegments; ++i)
+	{
+		if (mFences[i] != 0)
+		{
+			glDeleteSync((GLsync)mFences[i]);
+		}
+	}
+
+	if (mMapped != 0)
+	{
+		GLState::BindBuffer(GL_COPY_WRITE_BUFFER, mHandle);
+		glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+	}
+
+	GLState::OnDeleteBuffer(mHandle);
+	glDeleteBuffers(1, &mHandle);
+}
+
+void StreamBuffer::BeginFrame()
+{
+	mSegment = (mSegment + 1) % mNumSegments;
+	mHead = 0;
+	mStats.mFrames += 1;
+
+	GLsync fence = (GLsync)mFences[mSegment];
+
+	if (fence == 0)
+	{
+		return;
+	}
+
+	if (glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+
+		mStats.mWaits += 1;
+		mStats.mStallMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	glDeleteSync(fence);
+	mFences[mSegment] = 0;
+}
+
+void StreamBuffer::EndFrame()
+{
+	if (mFences[mSegment] != 0)
+	{
+		glDeleteSync((GLsync)mFences[mSegment]);
+	}
+
+	mFences[mSegment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+bool StreamBuffer::Write(const void* data, unsigned int bytes, unsigned int& outOffset)
+{
+	unsigned int aligned = (bytes + STREAM_BUFFER_ALIGNMENT - 1) & ~(STREAM_BUFFER_ALIGNMENT - 1);
+
+	if (mHead + aligned > mSegmentSize)
+	{
+		mStats.mOverflows += 1;
+		return false;
+	}
+
+	outOffset = mSegment * mSegmentSize + mHead;
+	mHead += aligned;
+
+	if (mMapped != 0)
+	{
+		memcpy(mMapped + outOffset, data, bytes);
+	}
+	else
+	{
+		// The fence in BeginFrame already guarantees the GPU is done with this range
+		GLState::BindBuffer(GL_COPY_WRITE_BUFFER, mHandle);
+		void* target = glMapBufferRange(GL_COPY_WRITE_BUFFER, outOffset, bytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+
+		if (target == 0)
+		{
+			return false;
+		}
+
+		memcpy(target, data, bytes);
+		glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+	}
+
+	mStats.mWrites += 1;
+	mStats.mBytesWritten += bytes;
+
+	return true;
+}
+
+bool StreamBuffer::IsPersistent()
+{
+	return mMapped != 0;
+}
+
+unsigned int StreamBuffer::GetHandle()
+{
+	return mHandle;
+}
+
+unsigned int StreamBuffer::GetSegmentSize()
+{
+	return mSegmentSize;
+}
+
+const StreamBufferStats& StreamBuffer::GetStats()
+{
+	return mStats;
+}
+
+void StreamBuffer::ResetStats()
+{
+	memset(&mStats, 0, sizeof(StreamBufferStats));
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#define STREAM_BUFFER_MAX_SEGMENTS 4
+
+struct StreamBufferStats
+{
+	unsigned int mFrames;
+	unsigned long long mBytesWritten;
+	unsigned int mWrites;
+	unsigned int mOverflows; // Writes that did not fit in the frame's segment
+	unsigned int mWaits;     // Frames whose segment was still in use by the GPU
+	double mStallMilliseconds;
+};
+
+// Ring of per-frame segments for vertex data that is rewritten every frame. The GPU reads one
+// segment while the CPU writes the next, a fence per segment guards reuse. The buffer is
+// persistently mapped when glBufferStorage is available, otherwise every write maps its range
+// unsynchronized. Writes return the offset an Attribute should source its data from.
+class StreamBuffer
+{
+protected:
+	unsigned int mHandle;
+	unsigned int mSegmentSize;
+	unsigned int mNumSegments;
+	unsigned int mSegment;
+	unsigned int mHead;
+	unsigned char* mMapped;
+	void* mFences[STREAM_BUFFER_MAX_SEGMENTS];
+	StreamBufferStats mStats;
+private:
+	StreamBuffer(const StreamBuffer&);
+	StreamBuffer& operator=(const StreamBuffer&);
+public:
+	StreamBuffer(unsigned int segmentSize, unsigned int numSegments = 3);
+	~StreamBuffer();
+
+	// Moves to the next segment, waiting for the GPU if it still reads from it
+	void BeginFrame();
+	// Call after the draws that read this frame's data have been submitted
+	void EndFrame();
+
+	bool Write(const void* data, unsigned int bytes, unsigned int& outOffset);
+
+	bool IsPersistent();
+	unsigned int GetHandle();
+	unsigned int GetSegmentSize();
+	const StreamBufferStats& GetStats();
+	void ResetStats();
+};
@@ -0,0 +1,21 @@
+#include "StringHash.h"
+
+unsigned int HashString(const char* str, unsigned int length, unsigned int hash)
+{
+	for (unsigned int i = 0; i < length; ++i)
+	{
+		hash = (hash ^ (unsigned int)(unsigned char)str[i]) * STRING_HASH_PRIME;
+	}
+
+	return hash;
+}
+
+unsigned long long HashString64(const char* str, unsigned int length, unsigned long long hash)
+{
+	for (unsigned int i = 0; i < length; ++i)
+	{
+		hash = (hash ^ (unsigned long long)(unsigned char)str[i]) * STRING_HASH64_PRIME;
+	}
+
+	return hash;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+
+#define STRING_HASH_OFFSET 2166136261u
+#define STRING_HASH_PRIME 16777619u
+#define STRING_HASH64_OFFSET 14695981039346656037ull
+#define STRING_HASH64_PRIME 1099511628211ull
+
+// 32 bit FNV-1a, constexpr so names written as literals can be hashed by the compiler
+constexpr unsigned int HashString(const char* str, unsigned int hash = STRING_HASH_OFFSET)
+{
+	return *str == 0 ? hash : HashString(str + 1, (hash ^ (unsigned int)(unsigned char)*str) * STRING_HASH_PRIME);
+}
+
+// 64 bit FNV-1a, for keys that identify whole files or sources, and to tell apart names whose
+// 32 bit hashes collide
+constexpr unsigned long long HashString64(const char* str, unsigned long long hash = STRING_HASH64_OFFSET)
+{
+	return *str == 0 ? hash : HashString64(str + 1, (hash ^ (unsigned long long)(unsigned char)*str) * STRING_HASH64_PRIME);
+}
+
+unsigned int HashString(const char* str, unsigned int length, unsigned int hash);
+unsigned long long HashString64(const char* str, unsigned int length, unsigned long long hash = STRING_HASH64_OFFSET);
+
+// Wraps a hashed name so lookups taking one can't be confused with lookups taking a location.
+// constexpr StringHash kModel("model") hashes at compile time, a runtime string hashes when wrapped.
+// mValue picks the table slot, mCheck is an independent 64 bit hash of the same name that the
+// table compares too, so two names only mix up if both hashes collide.
+struct StringHash
+{
+	unsigned int mValue;
+	unsigned long long mCheck;
+
+	constexpr StringHash() : mValue(STRING_HASH_OFFSET), mCheck(STRING_HASH64_OFFSET) { }
+	constexpr explicit StringHash(const char* str) : mValue(HashString(str)), mCheck(HashString64(str)) { }
+	inline StringHash(const char* str, unsigned int length) : mValue(HashString(str, length, STRING_HASH_OFFSET)), mCheck(HashString64(str, length, STRING_HASH64_OFFSET)) { }
+	inline explicit StringHash(const std::string& str) : mValue(HashString(str.c_str(), (unsigned int)str.size(), STRING_HASH_OFFSET)), mCheck(HashString64(str.c_str(), (unsigned int)str.size(), STRING_HASH64_OFFSET)) { }
+
+	// Hash of this name followed by suffix, FNV-1a continues where the name left off
+	inline StringHash Append(const char* suffix, unsigned int length) const
+	{
+		StringHash result;
+		result.mValue = HashString(suffix, length, mValue);
+		result.mCheck = HashString64(suffix, length, mCheck);
+		return result;
+	}
+};
+
+inline bool operator==(const StringHash& a, const StringHash& b) { return a.mValue == b.mValue && a.mCheck == b.mCheck; }
+inline bool operator!=(const StringHash& a, const StringHash& b) { return !(a == b); }
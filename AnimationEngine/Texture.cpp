@@ -1,6 +1,17 @@
 #include "Texture.h"
 #include "glad.h"
+#include "GLState.h"
+#include "GLExtensions.h"
+#include "MappedFile.h"
+#include "MipGenerator.h"
+#include "TextureFile.h"
 #include "stb_image.h"
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+static MipOptions sMipOptions;
+static bool sCpuMips = false;
 
 Texture::Texture()
 {
@@ -13,51 +24,199 @@ Texture::Texture()
 
 Texture::Texture(const char* path)
 {
+	mWidth = 0; 
+	mHeight = 0; 
+	mChannels = 0; 
+
 	glGenTextures(1, &mHandle); 
 	Load(path);
 }
 
 Texture::~Texture()
 {
+	GLState::OnDeleteTexture(mHandle);
 	glDeleteTextures(1, &mHandle);
 }
 
 void Texture::Load(const char* path)
 {
-	glBindTexture(GL_TEXTURE_2D, mHandle); 
-	
+	if (IsTextureFilePath(path))
+	{
+		LoadBaked(path);
+		return;
+	}
+
 	int width, height, channels; 
 	unsigned char* data = stbi_load(path, &width, &height, &channels, 4); 
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data); 
-	glGenerateMipmap(GL_TEXTURE_2D);
-	
+
+	if (data == 0)
+	{
+		std::cout << "Could not load texture " << path << "\n";
+		return;
+	}
+
+	if (sCpuMips)
+	{
+		unsigned int numLevels = GetMipCount(width, height);
+		std::vector<unsigned char> chain(GetMipChainSize(width, height, numLevels));
+		memcpy(&chain[0], data, (size_t)width * height * 4);
+		stbi_image_free(data);
+
+		GenerateMipChain(&chain[0], width, height, numLevels, sMipOptions);
+		UploadChain(width, height, channels, &chain[0], numLevels);
+		return;
+	}
+
+	Upload(width, height, channels, data);
 	stbi_image_free(data); 
+}
+
+void Texture::Upload(unsigned int width, unsigned int height, unsigned int channels, const void* pixels)
+{
+	GLState::BindTexture(GLState::GetActiveTexture(), GL_TEXTURE_2D, mHandle); 
+	
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels); 
+	glGenerateMipmap(GL_TEXTURE_2D);
 	
+	// The texture may have held a shorter stored chain before
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 1000);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT); 
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT); 
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR); 
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR); 
-	glBindTexture(GL_TEXTURE_2D, 0);
 	mWidth = width; 
 	mHeight = height; 
 	mChannels = channels;
 }
 
+void Texture::UploadChain(unsigned int width, unsigned int height, unsigned int channels, const void* pixels, unsigned int numLevels)
+{
+	GLState::BindTexture(GLState::GetActiveTexture(), GL_TEXTURE_2D, mHandle);
+
+	// Offsets into an unpack buffer are pointers as far as GL is concerned
+	const unsigned char* level = (const unsigned char*)pixels;
+	unsigned int levelWidth = width;
+	unsigned int levelHeight = height;
+
+	for (unsigned int i = 0; i < numLevels; ++i)
+	{
+		glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA, levelWidth, levelHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, level);
+
+		level += (size_t)levelWidth * levelHeight * 4;
+		levelWidth = levelWidth > 1 ? levelWidth / 2 : 1;
+		levelHeight = levelHeight > 1 ? levelHeight / 2 : 1;
+	}
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, numLevels - 1);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	mWidth = width;
+	mHeight = height;
+	mChannels = channels;
+}
+
+bool Texture::LoadBaked(const char* path)
+{
+	MappedFile file;
+	if (!file.Open(path))
+	{
+		std::cout << "Could not open texture " << path << "\n";
+		return false;
+	}
+
+	const TextureFileHeader* header = ReadTextureFileHeader(file.GetData(), file.GetSize());
+	if (header == 0)
+	{
+		std::cout << "Invalid texture file " << path << "\n";
+		return false;
+	}
+
+	TextureFormat format = (TextureFormat)header->mFormat;
+	GLenum internalFormat = 0;
+
+	if (format == TextureFormat::BC1 && GLExtensions::HasS3TC())
+	{
+		internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+	}
+	else if (format == TextureFormat::BC3 && GLExtensions::HasS3TC())
+	{
+		internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+	}
+	else if (format == TextureFormat::BC7 && GLExtensions::HasBPTC())
+	{
+		internalFormat = GL_COMPRESSED_RGBA_BPTC_UNORM;
+	}
+	else if (format != TextureFormat::RGBA8)
+	{
+		std::cout << "Texture format of " << path << " is not supported by this driver\n";
+		return false;
+	}
+
+	GLState::BindTexture(GLState::GetActiveTexture(), GL_TEXTURE_2D, mHandle);
+	// Uploads must not source from a pixel unpack buffer someone left bound
+	GLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	for (unsigned int i = 0; i < header->mNumLevels; ++i)
+	{
+		const TextureFileLevel& level = header->mLevels[i];
+		const unsigned char* data = file.GetData() + level.mOffset;
+
+		if (format == TextureFormat::RGBA8)
+		{
+			glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA, level.mWidth, level.mHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+		}
+		else
+		{
+			glCompressedTexImage2D(GL_TEXTURE_2D, i, internalFormat, level.mWidth, level.mHeight, 0, level.mSize, data);
+		}
+	}
+
+	// A chain that stops early is still complete up to its last stored level
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, header->mNumLevels - 1);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	mWidth = header->mWidth;
+	mHeight = header->mHeight;
+	mChannels = header->mChannels;
+
+	return true;
+}
+
+bool Texture::IsLoaded()
+{
+	return mWidth != 0;
+}
+
 void Texture::Set(unsigned int uniform, unsigned int texIndex)
 {
-	glActiveTexture(GL_TEXTURE0 + texIndex);
-	glBindTexture(GL_TEXTURE_2D, mHandle); 
+	GLState::BindTexture(texIndex, GL_TEXTURE_2D, mHandle); 
 	glUniform1i(uniform, texIndex);
 }
 
 void Texture::UnSet(unsigned int textureIndex)
 {
-	glActiveTexture(GL_TEXTURE0 + textureIndex); 
-	glBindTexture(GL_TEXTURE_2D, 0); 
-	glActiveTexture(GL_TEXTURE0);
+	// The texture stays bound until another one is set on the same unit, see GLState
 }
 
 unsigned int Texture::GetHandle()
 {
 	return mHandle;
 }
+
+void Texture::SetMipOptions(const MipOptions* options)
+{
+	sCpuMips = options != 0;
+	if (options != 0)
+	{
+		sMipOptions = *options;
+	}
+}
+
+const MipOptions* Texture::GetMipOptions()
+{
+	return sCpuMips ? &sMipOptions : 0;
+}
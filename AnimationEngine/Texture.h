@@ -1,4 +1,7 @@
 #pragma once
+
+struct MipOptions;
+
 class Texture 
 {
 protected: 
@@ -14,7 +17,22 @@ public:
 	Texture(const char* path); 
 	~Texture(); 
 	
+	// Files ending in TEXTURE_FILE_EXTENSION go through LoadBaked, anything else through stb_image
 	void Load(const char* path); 
+	// Maps a file written by BakeTexture and uploads its stored mips as they are
+	bool LoadBaked(const char* path);
+	// Sets level 0 from 8 bit RGBA pixels and generates the mips. With a GL_PIXEL_UNPACK_BUFFER
+	// bound, pixels is an offset into that buffer. channels only records what the source had.
+	void Upload(unsigned int width, unsigned int height, unsigned int channels, const void* pixels);
+	// Levels stored back to back, largest first, as GenerateMipChain leaves them. Also takes an
+	// offset into a bound GL_PIXEL_UNPACK_BUFFER.
+	void UploadChain(unsigned int width, unsigned int height, unsigned int channels, const void* pixels, unsigned int numLevels);
+	bool IsLoaded();
+
+	// Load and TextureLoader build mips on the CPU with these options instead of calling
+	// glGenerateMipmap. Null goes back to the driver.
+	static void SetMipOptions(const MipOptions* options);
+	static const MipOptions* GetMipOptions();
 	void Set(unsigned int uniform, unsigned int texIndex); 
 	void UnSet(unsigned int textureIndex); 
 	unsigned int GetHandle();
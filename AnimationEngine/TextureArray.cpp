@@ -0,0 +1,195 @@
+#include "TextureArray.h"
+#include "glad.h"
+#include "GLState.h"
+#include "MappedFile.h"
+#include "MipGenerator.h"
+#include "Texture.h"
+#include "TextureFile.h"
+#include "stb_image.h"
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+TextureArray::TextureArray()
+{
+	mWidth = 0;
+	mHeight = 0;
+	mLayers = 0;
+	mLevels = 0;
+
+	glGenTextures(1, &mHandle);
+}
+
+TextureArray::~TextureArray()
+{
+	GLState::OnDeleteTexture(mHandle);
+	glDeleteTextures(1, &mHandle);
+}
+
+void TextureArray::Allocate(unsigned int width, unsigned int height, unsigned int layers, unsigned int numLevels)
+{
+	unsigned int maxLevels = GetMipCount(width, height);
+	mWidth = width;
+	mHeight = height;
+	mLayers = layers;
+	mLevels = numLevels == 0 || numLevels > maxLevels ? maxLevels : numLevels;
+
+	GLState::BindTexture(GLState::GetActiveTexture(), GL_TEXTURE_2D_ARRAY, mHandle);
+	GLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	unsigned int levelWidth = width;
+	unsigned int levelHeight = height;
+
+	for (unsigned int i = 0; i < mLevels; ++i)
+	{
+		glTexImage3D(GL_TEXTURE_2D_ARRAY, i, GL_RGBA8, levelWidth, levelHeight, layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+
+		levelWidth = levelWidth > 1 ? levelWidth / 2 : 1;
+		levelHeight = levelHeight > 1 ? levelHeight / 2 : 1;
+	}
+
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, mLevels - 1);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+}
+
+void TextureArray::SetLayer(unsigned int layer, const void* pixels)
+{
+	if (layer >= mLayers)
+	{
+		std::cout << "Layer " << layer << " is outside the texture array\n";
+		return;
+	}
+
+	GLState::BindTexture(GLState::GetActiveTexture(), GL_TEXTURE_2D_ARRAY, mHandle);
+	GLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, mWidth, mHeight, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+}
+
+void TextureArray::SetLayerChain(unsigned int layer, const void* chain)
+{
+	if (layer >= mLayers)
+	{
+		std::cout << "Layer " << layer << " is outside the texture array\n";
+		return;
+	}
+
+	GLState::BindTexture(GLState::GetActiveTexture(), GL_TEXTURE_2D_ARRAY, mHandle);
+	GLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	const unsigned char* level = (const unsigned char*)chain;
+	unsigned int levelWidth = mWidth;
+	unsigned int levelHeight = mHeight;
+
+	for (unsigned int i = 0; i < mLevels; ++i)
+	{
+		glTexSubImage3D(GL_TEXTURE_2D_ARRAY, i, 0, 0, layer, levelWidth, levelHeight, 1, GL_RGBA, GL_UNSIGNED_BYTE, level);
+
+		level += (size_t)levelWidth * levelHeight * 4;
+		levelWidth = levelWidth > 1 ? levelWidth / 2 : 1;
+		levelHeight = levelHeight > 1 ? levelHeight / 2 : 1;
+	}
+}
+
+bool TextureArray::LoadLayer(unsigned int layer, const char* path)
+{
+	if (layer >= mLayers)
+	{
+		std::cout << "Layer " << layer << " is outside the texture array\n";
+		return false;
+	}
+
+	if (IsTextureFilePath(path))
+	{
+		MappedFile file;
+		const TextureFileHeader* header = file.Open(path) ? ReadTextureFileHeader(file.GetData(), file.GetSize()) : 0;
+
+		if (header == 0 || header->mFormat != (unsigned int)TextureFormat::RGBA8 || header->mWidth != mWidth || header->mHeight != mHeight)
+		{
+			std::cout << "Texture " << path << " can not be a layer of this array\n";
+			return false;
+		}
+
+		GLState::BindTexture(GLState::GetActiveTexture(), GL_TEXTURE_2D_ARRAY, mHandle);
+		GLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+		for (unsigned int i = 0; i < mLevels && i < header->mNumLevels; ++i)
+		{
+			const TextureFileLevel& level = header->mLevels[i];
+			glTexSubImage3D(GL_TEXTURE_2D_ARRAY, i, 0, 0, layer, level.mWidth, level.mHeight, 1, GL_RGBA, GL_UNSIGNED_BYTE, file.GetData() + level.mOffset);
+		}
+
+		return true;
+	}
+
+	int width, height, channels;
+	unsigned char* data = stbi_load(path, &width, &height, &channels, 4);
+
+	if (data == 0 || (unsigned int)width != mWidth || (unsigned int)height != mHeight)
+	{
+		std::cout << "Texture " << path << " can not be a layer of this array\n";
+		stbi_image_free(data);
+		return false;
+	}
+
+	const MipOptions* mipOptions = Texture::GetMipOptions();
+	if (mipOptions != 0 && mLevels > 1)
+	{
+		std::vector<unsigned char> chain(GetMipChainSize(mWidth, mHeight, mLevels));
+		memcpy(&chain[0], data, (size_t)mWidth * mHeight * 4);
+		GenerateMipChain(&chain[0], mWidth, mHeight, mLevels, *mipOptions);
+		SetLayerChain(layer, &chain[0]);
+	}
+	else
+	{
+		SetLayer(layer, data);
+	}
+
+	stbi_image_free(data);
+
+	return true;
+}
+
+void TextureArray::GenerateMipmaps()
+{
+	GLState::BindTexture(GLState::GetActiveTexture(), GL_TEXTURE_2D_ARRAY, mHandle);
+	glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+}
+
+void TextureArray::Set(unsigned int uniform, unsigned int texIndex)
+{
+	GLState::BindTexture(texIndex, GL_TEXTURE_2D_ARRAY, mHandle);
+	glUniform1i(uniform, texIndex);
+}
+
+void TextureArray::UnSet(unsigned int textureIndex)
+{
+	// The array stays bound until another one is set on the same unit, see GLState
+}
+
+unsigned int TextureArray::GetHandle()
+{
+	return mHandle;
+}
+
+unsigned int TextureArray::GetWidth()
+{
+	return mWidth;
+}
+
+unsigned int TextureArray::GetHeight()
+{
+	return mHeight;
+}
+
+unsigned int TextureArray::GetLayers()
+{
+	return mLayers;
+}
+
+unsigned int TextureArray::GetLevels()
+{
+	return mLevels;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+// GL_TEXTURE_2D_ARRAY of equally sized RGBA8 layers. Variations of the same kind of texture go
+// in one array and draws pick theirs with a layer index, so switching variation is a uniform or
+// an instance attribute instead of a texture bind. Sample with sampler2DArray and vec3(uv, layer).
+class TextureArray
+{
+protected:
+	unsigned int mWidth;
+	unsigned int mHeight;
+	unsigned int mLayers;
+	unsigned int mLevels;
+	unsigned int mHandle;
+private:
+	TextureArray(const TextureArray& other);
+	TextureArray& operator=(const TextureArray& other);
+public:
+	TextureArray();
+	~TextureArray();
+
+	// Storage for every layer and level, numLevels 0 is a full chain. Contents are undefined until set.
+	void Allocate(unsigned int width, unsigned int height, unsigned int layers, unsigned int numLevels = 0);
+	// Level 0 only, call GenerateMipmaps once every layer is set
+	void SetLayer(unsigned int layer, const void* pixels);
+	// All allocated levels back to back, largest first, as GenerateMipChain leaves them
+	void SetLayerChain(unsigned int layer, const void* chain);
+	// stb_image files or baked ones with the same size. Builds the layer's mips on the CPU when
+	// Texture::SetMipOptions is set or copies the stored ones, otherwise only sets level 0.
+	bool LoadLayer(unsigned int layer, const char* path);
+	void GenerateMipmaps();
+
+	void Set(unsigned int uniform, unsigned int texIndex);
+	void UnSet(unsigned int textureIndex);
+	unsigned int GetHandle();
+	unsigned int GetWidth();
+	unsigned int GetHeight();
+	unsigned int GetLayers();
+	unsigned int GetLevels();
+};
@@ -0,0 +1,247 @@
+#include "TextureAtlas.h"
+#include "MipGenerator.h"
+#include "Texture.h"
+#include "stb_image.h"
+#include <cstring>
+#include <iostream>
+
+TextureAtlas::TextureAtlas(unsigned int width, unsigned int height, unsigned int padding)
+{
+	mWidth = width;
+	mHeight = height;
+	mPadding = 2;
+	while (mPadding < padding)
+	{
+		mPadding *= 2;
+	}
+
+	mPixels.resize((size_t)width * height * 4);
+	Clear();
+}
+
+void TextureAtlas::Clear()
+{
+	mUsedPixels = 0;
+	mRegions.clear();
+	mSkyline.clear();
+	memset(&mPixels[0], 0, mPixels.size());
+
+	SkylineNode node;
+	node.mX = 0;
+	node.mY = 0;
+	node.mWidth = mWidth;
+	mSkyline.push_back(node);
+}
+
+bool TextureAtlas::FindPosition(unsigned int width, unsigned int height, unsigned int& outNode, unsigned int& outX, unsigned int& outY)
+{
+	unsigned int bestTop = 0xFFFFFFFF;
+	unsigned int bestWidth = 0xFFFFFFFF;
+
+	for (unsigned int i = 0, size = (unsigned int)mSkyline.size(); i < size; ++i)
+	{
+		unsigned int x = mSkyline[i].mX;
+		if (x + width > mWidth)
+		{
+			break;
+		}
+
+		// The slot rests on the highest node it spans
+		unsigned int y = 0;
+		unsigned int covered = 0;
+		for (unsigned int j = i; covered < width; ++j)
+		{
+			y = mSkyline[j].mY > y ? mSkyline[j].mY : y;
+			covered += mSkyline[j].mWidth;
+		}
+
+		if (y + height > mHeight)
+		{
+			continue;
+		}
+
+		// Bottom-left, ties go to the narrower node so wide gaps stay open for wide images
+		if (y + height < bestTop || (y + height == bestTop && mSkyline[i].mWidth < bestWidth))
+		{
+			bestTop = y + height;
+			bestWidth = mSkyline[i].mWidth;
+			outNode = i;
+			outX = x;
+			outY = y;
+		}
+	}
+
+	return bestTop != 0xFFFFFFFF;
+}
+
+void TextureAtlas::AddSkylineLevel(unsigned int node, unsigned int x, unsigned int y, unsigned int width, unsigned int height)
+{
+	SkylineNode level;
+	level.mX = x;
+	level.mY = y + height;
+	level.mWidth = width;
+	mSkyline.insert(mSkyline.begin() + node, level);
+
+	// Nodes now under the new level shrink or go away
+	for (unsigned int i = node + 1; i < mSkyline.size(); ++i)
+	{
+		unsigned int end = mSkyline[i - 1].mX + mSkyline[i - 1].mWidth;
+		if (mSkyline[i].mX >= end)
+		{
+			break;
+		}
+
+		unsigned int shrink = end - mSkyline[i].mX;
+		if (shrink < mSkyline[i].mWidth)
+		{
+			mSkyline[i].mX += shrink;
+			mSkyline[i].mWidth -= shrink;
+			break;
+		}
+
+		mSkyline.erase(mSkyline.begin() + i);
+		--i;
+	}
+
+	for (unsigned int i = 0; i + 1 < mSkyline.size(); ++i)
+	{
+		if (mSkyline[i].mY == mSkyline[i + 1].mY)
+		{
+			mSkyline[i].mWidth += mSkyline[i + 1].mWidth;
+			mSkyline.erase(mSkyline.begin() + i + 1);
+			--i;
+		}
+	}
+}
+
+int TextureAtlas::Add(const unsigned char* pixels, unsigned int width, unsigned int height)
+{
+	unsigned int border = mPadding / 2;
+	unsigned int slotWidth = (width + mPadding + mPadding - 1) & ~(mPadding - 1);
+	unsigned int slotHeight = (height + mPadding + mPadding - 1) & ~(mPadding - 1);
+	unsigned int node, slotX, slotY;
+
+	if (!FindPosition(slotWidth, slotHeight, node, slotX, slotY))
+	{
+		return -1;
+	}
+
+	AddSkylineLevel(node, slotX, slotY, slotWidth, slotHeight);
+
+	AtlasRegion region;
+	region.mX = slotX + border;
+	region.mY = slotY + border;
+	region.mWidth = width;
+	region.mHeight = height;
+	region.mUVTransform = vec4((float)region.mX / mWidth, (float)region.mY / mHeight, (float)width / mWidth, (float)height / mHeight);
+
+	// The image plus its border, border pixels repeat the nearest edge pixel
+	for (unsigned int y = 0; y < height + border * 2; ++y)
+	{
+		unsigned int sourceY = y < border ? 0 : (y - border >= height ? height - 1 : y - border);
+		const unsigned char* source = pixels + (size_t)sourceY * width * 4;
+		unsigned char* target = &mPixels[((size_t)(slotY + y) * mWidth + slotX) * 4];
+
+		for (unsigned int x = 0; x < border; ++x)
+		{
+			memcpy(target + x * 4, source, 4);
+			memcpy(target + (border + width + x) * 4, source + (width - 1) * 4, 4);
+		}
+
+		memcpy(target + border * 4, source, (size_t)width * 4);
+	}
+
+	mUsedPixels += (unsigned long long)width * height;
+	mRegions.push_back(region);
+
+	return (int)mRegions.size() - 1;
+}
+
+int TextureAtlas::Add(const char* path)
+{
+	int width, height, channels;
+	unsigned char* data = stbi_load(path, &width, &height, &channels, 4);
+
+	if (data == 0)
+	{
+		std::cout << "Could not load texture " << path << "\n";
+		return -1;
+	}
+
+	int index = Add(data, (unsigned int)width, (unsigned int)height);
+	stbi_image_free(data);
+
+	if (index < 0)
+	{
+		std::cout << "Texture " << path << " does not fit in the atlas\n";
+	}
+
+	return index;
+}
+
+void TextureAtlas::Upload(Texture& texture)
+{
+	MipOptions options;
+	const MipOptions* mipOptions = Texture::GetMipOptions();
+	options.mSRGB = mipOptions != 0 && mipOptions->mSRGB;
+	options.mPool = mipOptions != 0 ? mipOptions->mPool : 0;
+
+	unsigned int numLevels = GetSafeLevels();
+	std::vector<unsigned char> chain(GetMipChainSize(mWidth, mHeight, numLevels));
+	memcpy(&chain[0], &mPixels[0], mPixels.size());
+	GenerateMipChain(&chain[0], mWidth, mHeight, numLevels, options);
+
+	texture.UploadChain(mWidth, mHeight, 4, &chain[0], numLevels);
+}
+
+unsigned int TextureAtlas::GetNumRegions()
+{
+	return (unsigned int)mRegions.size();
+}
+
+const AtlasRegion& TextureAtlas::GetRegion(unsigned int index)
+{
+	return mRegions[index];
+}
+
+vec2 TextureAtlas::RemapUV(unsigned int index, const vec2& uv)
+{
+	const vec4& transform = mRegions[index].mUVTransform;
+	return vec2(uv.x * transform.z + transform.x, uv.y * transform.w + transform.y);
+}
+
+unsigned int TextureAtlas::GetSafeLevels()
+{
+	// A level k texel covers 2^k pixels and bilinear filtering reaches one texel further, both
+	// stay inside a slot while 2^k is no more than the border
+	unsigned int levels = 1;
+	unsigned int border = mPadding / 2;
+	unsigned int maxLevels = GetMipCount(mWidth, mHeight);
+
+	while ((1u << levels) <= border && levels < maxLevels)
+	{
+		levels += 1;
+	}
+
+	return levels;
+}
+
+float TextureAtlas::GetOccupancy()
+{
+	return (float)((double)mUsedPixels / ((double)mWidth * mHeight));
+}
+
+unsigned int TextureAtlas::GetWidth()
+{
+	return mWidth;
+}
+
+unsigned int TextureAtlas::GetHeight()
+{
+	return mHeight;
+}
+
+const unsigned char* TextureAtlas::GetPixels()
+{
+	return &mPixels[0];
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vector>
+#include "vec2.h"
+#include "vec4.h"
+
+class Texture;
+
+#define TEXTURE_ATLAS_DEFAULT_PADDING 8
+
+struct AtlasRegion
+{
+	// Pixels of the image itself, the border around it is not included
+	unsigned int mX;
+	unsigned int mY;
+	unsigned int mWidth;
+	unsigned int mHeight;
+	// uv * zw + xy takes the image's own 0..1 UVs into the atlas
+	vec4 mUVTransform;
+};
+
+// Packs many small RGBA8 images into one texture, so picking a variation is a UV transform
+// instead of a bind. Images are placed with a skyline bottom-left packer in slots aligned to
+// padding, which is a power of two. Half the padding surrounds every image with its edge pixels,
+// so filtering never reaches a neighbour. UVs outside 0..1 (wrapping) can not be atlased.
+class TextureAtlas
+{
+protected:
+	struct SkylineNode
+	{
+		unsigned int mX;
+		unsigned int mY;
+		unsigned int mWidth;
+	};
+
+	unsigned int mWidth;
+	unsigned int mHeight;
+	unsigned int mPadding;
+	unsigned long long mUsedPixels;
+	std::vector<SkylineNode> mSkyline;
+	std::vector<AtlasRegion> mRegions;
+	std::vector<unsigned char> mPixels;
+
+	bool FindPosition(unsigned int width, unsigned int height, unsigned int& outNode, unsigned int& outX, unsigned int& outY);
+	void AddSkylineLevel(unsigned int node, unsigned int x, unsigned int y, unsigned int width, unsigned int height);
+private:
+	TextureAtlas(const TextureAtlas&);
+	TextureAtlas& operator=(const TextureAtlas&);
+public:
+	TextureAtlas(unsigned int width, unsigned int height, unsigned int padding = TEXTURE_ATLAS_DEFAULT_PADDING);
+
+	// Returns the region index, or -1 when the image no longer fits
+	int Add(const unsigned char* pixels, unsigned int width, unsigned int height);
+	int Add(const char* path);
+	void Clear();
+
+	// Box filtered CPU mips, stopping at the last level where borders still keep regions apart.
+	// Honours the sRGB flag of Texture::SetMipOptions.
+	void Upload(Texture& texture);
+
+	unsigned int GetNumRegions();
+	const AtlasRegion& GetRegion(unsigned int index);
+	vec2 RemapUV(unsigned int index, const vec2& uv);
+	// Mip levels that stay free of bleeding, including level 0
+	unsigned int GetSafeLevels();
+	// Fraction of the atlas covered by images, borders and gaps excluded
+	float GetOccupancy();
+	unsigned int GetWidth();
+	unsigned int GetHeight();
+	const unsigned char* GetPixels();
+};
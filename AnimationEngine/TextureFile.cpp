@@ -0,0 +1,159 @@
+#include "TextureFile.h"
+#include "stb_image.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+unsigned long long GetTextureLevelSize(TextureFormat format, unsigned int width, unsigned int height)
+{
+	unsigned long long blocks = ((width + 3ull) / 4) * ((height + 3ull) / 4);
+
+	switch (format)
+	{
+	case TextureFormat::RGBA8:
+		return (unsigned long long)width * height * 4;
+	case TextureFormat::BC1:
+		return blocks * 8;
+	case TextureFormat::BC3:
+	case TextureFormat::BC7:
+		return blocks * 16;
+	}
+
+	return 0;
+}
+
+const TextureFileHeader* ReadTextureFileHeader(const unsigned char* data, unsigned long long size)
+{
+	if (data == 0 || size < sizeof(TextureFileHeader))
+	{
+		return 0;
+	}
+
+	const TextureFileHeader* header = (const TextureFileHeader*)data;
+
+	if (header->mMagic != TEXTURE_FILE_MAGIC || header->mVersion != TEXTURE_FILE_VERSION ||
+		header->mFormat > (unsigned int)TextureFormat::BC7 || header->mNumLevels == 0 || header->mNumLevels > TEXTURE_FILE_MAX_LEVELS ||
+		header->mWidth == 0 || header->mHeight == 0 || header->mWidth > TEXTURE_FILE_MAX_DIMENSION || header->mHeight > TEXTURE_FILE_MAX_DIMENSION)
+	{
+		return 0;
+	}
+
+	unsigned int levelWidth = header->mWidth;
+	unsigned int levelHeight = header->mHeight;
+
+	for (unsigned int i = 0; i < header->mNumLevels; ++i)
+	{
+		const TextureFileLevel& level = header->mLevels[i];
+
+		if (level.mWidth != levelWidth || level.mHeight != levelHeight ||
+			level.mSize != GetTextureLevelSize((TextureFormat)header->mFormat, level.mWidth, level.mHeight) ||
+			level.mOffset < sizeof(TextureFileHeader) || (unsigned long long)level.mOffset + level.mSize > size)
+		{
+			return 0;
+		}
+
+		levelWidth = levelWidth > 1 ? levelWidth / 2 : 1;
+		levelHeight = levelHeight > 1 ? levelHeight / 2 : 1;
+	}
+
+	return header;
+}
+
+bool IsTextureFilePath(const char* path)
+{
+	size_t length = strlen(path);
+	size_t extension = sizeof(TEXTURE_FILE_EXTENSION) - 1;
+
+	return length >= extension && strcmp(path + length - extension, TEXTURE_FILE_EXTENSION) == 0;
+}
+
+bool BakeTexture(const char* input, const char* output, const MipOptions& options)
+{
+	int width, height, channels;
+	unsigned char* pixels = stbi_load(input, &width, &height, &channels, 4);
+
+	if (pixels == 0)
+	{
+		std::cout << "Could not load texture " << input << "\n";
+		return false;
+	}
+
+	if ((unsigned int)width > TEXTURE_FILE_MAX_DIMENSION || (unsigned int)height > TEXTURE_FILE_MAX_DIMENSION)
+	{
+		std::cout << "Texture " << input << " is larger than " << TEXTURE_FILE_MAX_DIMENSION << " pixels\n";
+		stbi_image_free(pixels);
+		return false;
+	}
+
+	TextureFileHeader header;
+	memset(&header, 0, sizeof(TextureFileHeader));
+	header.mMagic = TEXTURE_FILE_MAGIC;
+	header.mVersion = TEXTURE_FILE_VERSION;
+	header.mFormat = (unsigned int)TextureFormat::RGBA8;
+	header.mWidth = (unsigned int)width;
+	header.mHeight = (unsigned int)height;
+	header.mChannels = (unsigned int)channels;
+
+	unsigned int numLevels = GetMipCount(header.mWidth, header.mHeight);
+	if (numLevels > TEXTURE_FILE_MAX_LEVELS)
+	{
+		numLevels = TEXTURE_FILE_MAX_LEVELS;
+	}
+
+	std::vector<unsigned char> chain(GetMipChainSize(header.mWidth, header.mHeight, numLevels));
+	memcpy(&chain[0], pixels, (size_t)width * height * 4);
+	stbi_image_free(pixels);
+	GenerateMipChain(&chain[0], header.mWidth, header.mHeight, numLevels, options);
+
+	unsigned int offset = (sizeof(TextureFileHeader) + TEXTURE_FILE_ALIGNMENT - 1) & ~(TEXTURE_FILE_ALIGNMENT - 1);
+	unsigned int levelWidth = header.mWidth;
+	unsigned int levelHeight = header.mHeight;
+
+	for (unsigned int i = 0; i < numLevels; ++i)
+	{
+		TextureFileLevel& level = header.mLevels[i];
+		level.mOffset = offset;
+		level.mSize = (unsigned int)GetTextureLevelSize(TextureFormat::RGBA8, levelWidth, levelHeight);
+		level.mWidth = levelWidth;
+		level.mHeight = levelHeight;
+		offset = (offset + level.mSize + TEXTURE_FILE_ALIGNMENT - 1) & ~(TEXTURE_FILE_ALIGNMENT - 1);
+
+		levelWidth = levelWidth > 1 ? levelWidth / 2 : 1;
+		levelHeight = levelHeight > 1 ? levelHeight / 2 : 1;
+	}
+
+	header.mNumLevels = numLevels;
+
+	std::ofstream file(output, std::ios::binary | std::ios::trunc);
+	if (!file)
+	{
+		std::cout << "Could not write texture " << output << "\n";
+		return false;
+	}
+
+	static const char padding[TEXTURE_FILE_ALIGNMENT] = { 0 };
+	file.write((const char*)&header, sizeof(TextureFileHeader));
+	unsigned int position = sizeof(TextureFileHeader);
+	const unsigned char* level = &chain[0];
+
+	for (unsigned int i = 0; i < header.mNumLevels; ++i)
+	{
+		const TextureFileLevel& stored = header.mLevels[i];
+		file.write(padding, stored.mOffset - position);
+		file.write((const char*)level, stored.mSize);
+		position = stored.mOffset + stored.mSize;
+		level += stored.mSize;
+	}
+
+	file.close();
+	if (!file)
+	{
+		std::cout << "Could not write texture " << output << "\n";
+		remove(output);
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include "MipGenerator.h"
+
+// Engine texture container, written offline by BakeTexture and mapped at load time.
+//   TextureFileHeader, then every mip level from largest to smallest
+// Level offsets are from the start of the file and aligned to TEXTURE_FILE_ALIGNMENT, so each
+// level can be handed to GL straight out of the mapping.
+
+#define TEXTURE_FILE_MAGIC 0x58544541u // "AETX"
+#define TEXTURE_FILE_VERSION 1
+#define TEXTURE_FILE_MAX_LEVELS 16
+// Largest width or height a full chain fits in TEXTURE_FILE_MAX_LEVELS for
+#define TEXTURE_FILE_MAX_DIMENSION (1u << (TEXTURE_FILE_MAX_LEVELS - 1))
+#define TEXTURE_FILE_ALIGNMENT 64
+#define TEXTURE_FILE_EXTENSION ".aetex"
+
+enum class TextureFormat
+{
+	RGBA8 = 0,
+	BC1 = 1, // 4x4 blocks of 8 bytes, needs EXT_texture_compression_s3tc
+	BC3 = 2, // 4x4 blocks of 16 bytes, needs EXT_texture_compression_s3tc
+	BC7 = 3  // 4x4 blocks of 16 bytes, needs GL 4.2 or ARB_texture_compression_bptc
+};
+
+struct TextureFileLevel
+{
+	unsigned int mOffset;
+	unsigned int mSize;
+	unsigned int mWidth;
+	unsigned int mHeight;
+};
+
+struct TextureFileHeader
+{
+	unsigned int mMagic;
+	unsigned int mVersion;
+	unsigned int mFormat;
+	unsigned int mWidth;
+	unsigned int mHeight;
+	unsigned int mChannels; // Of the source image, the stored data always has four
+	unsigned int mNumLevels;
+	unsigned int mReserved;
+	TextureFileLevel mLevels[TEXTURE_FILE_MAX_LEVELS];
+};
+
+// 64 bit, so sizes from a damaged header can't wrap around
+unsigned long long GetTextureLevelSize(TextureFormat format, unsigned int width, unsigned int height);
+// Checks the header, that the levels halve from the header's size down and that every level lies
+// inside the data, returns 0 for anything else
+const TextureFileHeader* ReadTextureFileHeader(const unsigned char* data, unsigned long long size);
+bool IsTextureFilePath(const char* path);
+
+// Decodes any image stb_image reads and writes it as RGBA8 with a full mip chain built by
+// GenerateMipChain. There is no block compressor, BC levels have to come from an external tool.
+bool BakeTexture(const char* input, const char* output, const MipOptions& options = MipOptions());
@@ -0,0 +1,262 @@
+#include "TextureLoader.h"
+#include "glad.h"
+#include "GLState.h"
+#include "MipGenerator.h"
+#include "stb_image.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+TextureLoader::TextureLoader(unsigned int budget, unsigned int numThreads) : mDecoded(TEXTURE_LOADER_QUEUE_SIZE), mPool(numThreads)
+{
+	mHasHeld = false;
+	mBudget = budget;
+	mPending = 0;
+	mStopping.store(false);
+	ResetStats();
+
+	glGenBuffers(1, &mUploadBuffer);
+}
+
+TextureLoader::~TextureLoader()
+{
+	// Workers waiting on a full queue give up once they see this, so the pool can join them
+	mStopping.store(true);
+	mPool.Stop();
+
+	DecodedImage image;
+	while (mDecoded.Pop(image))
+	{
+		FreePixels(image);
+	}
+
+	if (mHasHeld)
+	{
+		FreePixels(mHeld);
+	}
+
+	GLState::OnDeleteBuffer(mUploadBuffer);
+	glDeleteBuffers(1, &mUploadBuffer);
+}
+
+void TextureLoader::Load(Texture& texture, const std::string& path)
+{
+	Texture* target = &texture;
+
+	mPending += 1;
+	mStats.mRequested += 1;
+	mPool.Submit([this, target, path]() { Decode(target, path); });
+}
+
+void TextureLoader::Decode(Texture* texture, const std::string& path)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	DecodedImage image;
+	int width = 0, height = 0, channels = 0;
+	image.mTexture = texture;
+	image.mPixels = stbi_load(path.c_str(), &width, &height, &channels, 4);
+	image.mWidth = (unsigned int)width;
+	image.mHeight = (unsigned int)height;
+	image.mChannels = (unsigned int)channels;
+	image.mNumLevels = 1;
+	image.mOwnsChain = false;
+	image.mBytes = image.mWidth * image.mHeight * 4;
+
+	const MipOptions* mipOptions = Texture::GetMipOptions();
+	if (mipOptions != 0 && image.mPixels != 0)
+	{
+		// Already on a pool thread, the levels are built in one go
+		MipOptions options = *mipOptions;
+		options.mPool = 0;
+
+		unsigned int numLevels = GetMipCount(image.mWidth, image.mHeight);
+		unsigned int bytes = GetMipChainSize(image.mWidth, image.mHeight, numLevels);
+		unsigned char* chain = new unsigned char[bytes];
+		memcpy(chain, image.mPixels, image.mBytes);
+		stbi_image_free(image.mPixels);
+		GenerateMipChain(chain, image.mWidth, image.mHeight, numLevels, options);
+
+		image.mPixels = chain;
+		image.mNumLevels = numLevels;
+		image.mBytes = bytes;
+		image.mOwnsChain = true;
+	}
+
+	image.mDecodeMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	image.mPath = path;
+
+	// The GL thread drains the queue every frame, a full queue only means it is behind
+	while (!mDecoded.Push(image))
+	{
+		if (mStopping.load())
+		{
+			FreePixels(image);
+			return;
+		}
+
+		std::this_thread::yield();
+	}
+}
+
+void TextureLoader::Upload(DecodedImage& image)
+{
+	mPending -= 1;
+	mStats.mDecodeMilliseconds += image.mDecodeMilliseconds;
+
+	if (image.mPixels == 0)
+	{
+		std::cout << "Could not load texture " << image.mPath << "\n";
+		mStats.mFailed += 1;
+		return;
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	unsigned int bytes = image.mBytes;
+
+	// Orphaning gives fresh storage every upload, so the copy never waits on the previous
+	// texture still being read out of the buffer
+	GLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, mUploadBuffer);
+	glBufferData(GL_PIXEL_UNPACK_BUFFER, bytes, 0, GL_STREAM_DRAW);
+	void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, bytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+	// Offset 0 into the unpack buffer, or the pixels themselves when it could not be mapped
+	const void* source = 0;
+
+	if (mapped != 0)
+	{
+		memcpy(mapped, image.mPixels, bytes);
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+	}
+	else
+	{
+		GLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		source = image.mPixels;
+	}
+
+	if (image.mNumLevels > 1)
+	{
+		image.mTexture->UploadChain(image.mWidth, image.mHeight, image.mChannels, source, image.mNumLevels);
+	}
+	else
+	{
+		image.mTexture->Upload(image.mWidth, image.mHeight, image.mChannels, source);
+	}
+
+	// Other texture uploads expect client memory, not this buffer
+	GLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	FreePixels(image);
+
+	double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	mStats.mUploaded += 1;
+	mStats.mBytesUploaded += bytes;
+	mStats.mUploadMilliseconds += milliseconds;
+	if (milliseconds > mStats.mLongestUpload)
+	{
+		mStats.mLongestUpload = milliseconds;
+	}
+}
+
+void TextureLoader::FreePixels(DecodedImage& image)
+{
+	if (image.mOwnsChain)
+	{
+		delete[] image.mPixels;
+	}
+	else
+	{
+		stbi_image_free(image.mPixels);
+	}
+
+	image.mPixels = 0;
+}
+
+unsigned int TextureLoader::Update()
+{
+	unsigned int uploaded = 0;
+	unsigned int spent = 0;
+
+	while (true)
+	{
+		if (!mHasHeld)
+		{
+			if (!mDecoded.Pop(mHeld))
+			{
+				break;
+			}
+
+			mHasHeld = true;
+		}
+
+		unsigned int bytes = mHeld.mBytes;
+		if (uploaded != 0 && spent + bytes > mBudget)
+		{
+			mStats.mDeferred += 1;
+			break;
+		}
+
+		mHasHeld = false;
+		Upload(mHeld);
+		spent += bytes;
+		uploaded += 1;
+	}
+
+	return uploaded;
+}
+
+void TextureLoader::Finish()
+{
+	while (mPending != 0)
+	{
+		if (mHasHeld)
+		{
+			mHasHeld = false;
+			Upload(mHeld);
+		}
+		else if (mDecoded.Pop(mHeld))
+		{
+			mHasHeld = true;
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+bool TextureLoader::IsDone()
+{
+	return mPending == 0;
+}
+
+unsigned int TextureLoader::GetNumPending()
+{
+	return mPending;
+}
+
+void TextureLoader::SetBudget(unsigned int bytes)
+{
+	mBudget = bytes;
+}
+
+unsigned int TextureLoader::GetBudget()
+{
+	return mBudget;
+}
+
+const TextureLoaderStats& TextureLoader::GetStats()
+{
+	return mStats;
+}
+
+void TextureLoader::ResetStats()
+{
+	memset(&mStats, 0, sizeof(TextureLoaderStats));
+}
+
+void TextureLoader::Print(const char* label)
+{
+	std::cout << label << ": " << mStats.mUploaded << " of " << mStats.mRequested << " textures uploaded, " << mStats.mFailed << " failed, "
+		<< (mStats.mBytesUploaded / 1024) << " KB, decode " << mStats.mDecodeMilliseconds << " ms on workers, upload "
+		<< mStats.mUploadMilliseconds << " ms (longest " << mStats.mLongestUpload << " ms), " << mStats.mDeferred << " updates hit the budget\n";
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include "LockFreeQueue.h"
+#include "Texture.h"
+#include "ThreadPool.h"
+
+#define TEXTURE_LOADER_DEFAULT_BUDGET (4 * 1024 * 1024)
+#define TEXTURE_LOADER_QUEUE_SIZE 64
+
+struct TextureLoaderStats
+{
+	unsigned int mRequested;
+	unsigned int mUploaded;
+	unsigned int mFailed;
+	unsigned int mDeferred;  // Updates that left decoded images waiting because of the budget
+	unsigned long long mBytesUploaded;
+	double mDecodeMilliseconds;  // Summed over the workers, includes CPU mips
+	double mUploadMilliseconds;  // Spent on the GL thread
+	double mLongestUpload;
+};
+
+// Streams textures in without decoding on the GL thread. Workers decode with stb_image and push
+// the pixels onto a lock-free queue, Update pops them on the GL thread and uploads through a
+// pixel unpack buffer, at most budget bytes per call. A texture larger than the budget still
+// goes up, alone, so nothing waits forever. Textures must outlive their request. With
+// Texture::SetMipOptions set before Load, the workers also build the mip chains.
+class TextureLoader
+{
+protected:
+	struct DecodedImage
+	{
+		Texture* mTexture;
+		unsigned char* mPixels;
+		unsigned int mWidth;
+		unsigned int mHeight;
+		unsigned int mChannels;
+		unsigned int mNumLevels;  // More than one when the worker built the mips
+		bool mOwnsChain;  // Pixels were allocated with new[] for a mip chain, not by stb_image
+		unsigned int mBytes;
+		double mDecodeMilliseconds;
+		std::string mPath;
+	};
+
+	LockFreeQueue<DecodedImage> mDecoded;
+	DecodedImage mHeld;  // Popped but over this frame's budget
+	bool mHasHeld;
+	unsigned int mUploadBuffer;
+	unsigned int mBudget;
+	unsigned int mPending;
+	std::atomic<bool> mStopping;
+	TextureLoaderStats mStats;
+	ThreadPool mPool;
+
+	void Decode(Texture* texture, const std::string& path);
+	void Upload(DecodedImage& image);
+	static void FreePixels(DecodedImage& image);
+private:
+	TextureLoader(const TextureLoader&);
+	TextureLoader& operator=(const TextureLoader&);
+public:
+	TextureLoader(unsigned int budget = TEXTURE_LOADER_DEFAULT_BUDGET, unsigned int numThreads = 0);
+	~TextureLoader();
+
+	void Load(Texture& texture, const std::string& path);
+	// Call once per frame on the GL thread, returns how many textures were uploaded
+	unsigned int Update();
+	// Blocks until every requested texture is uploaded, ignoring the budget
+	void Finish();
+
+	bool IsDone();
+	unsigned int GetNumPending();
+	void SetBudget(unsigned int bytes);
+	unsigned int GetBudget();
+	const TextureLoaderStats& GetStats();
+	void ResetStats();
+	void Print(const char* label);
+};
@@ -0,0 +1,99 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(unsigned int numThreads)
+{
+	mBusy = 0;
+	mStopping = false;
+
+	if (numThreads == 0)
+	{
+		unsigned int hardware = std::thread::hardware_concurrency();
+		numThreads = hardware > 1 ? hardware - 1 : 1;
+	}
+
+	mThreads.reserve(numThreads);
+	for (unsigned int i = 0; i < numThreads; ++i)
+	{
+		mThreads.push_back(std::thread(&ThreadPool::Run, this));
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	Stop();
+}
+
+void ThreadPool::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStopping = true;
+		mJobs.clear();
+	}
+
+	mWake.notify_all();
+
+	for (unsigned int i = 0, size = (unsigned int)mThreads.size(); i < size; ++i)
+	{
+		mThreads[i].join();
+	}
+
+	mThreads.clear();
+}
+
+void ThreadPool::Run()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	while (true)
+	{
+		while (!mStopping && mJobs.empty())
+		{
+			mWake.wait(lock);
+		}
+
+		if (mStopping)
+		{
+			return;
+		}
+
+		std::function<void()> job = mJobs.front();
+		mJobs.pop_front();
+		mBusy += 1;
+
+		lock.unlock();
+		job();
+		lock.lock();
+
+		mBusy -= 1;
+		if (mBusy == 0 && mJobs.empty())
+		{
+			mIdle.notify_all();
+		}
+	}
+}
+
+void ThreadPool::Submit(const std::function<void()>& job)
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mJobs.push_back(job);
+	}
+
+	mWake.notify_one();
+}
+
+void ThreadPool::Wait()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	while (mBusy != 0 || !mJobs.empty())
+	{
+		mIdle.wait(lock);
+	}
+}
+
+unsigned int ThreadPool::GetNumThreads()
+{
+	return (unsigned int)mThreads.size();
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads running jobs in submission order. Jobs must not touch GL, results
+// meant for the GL thread are handed back through a queue the GL thread polls.
+class ThreadPool
+{
+protected:
+	std::vector<std::thread> mThreads;
+	std::deque<std::function<void()> > mJobs;
+	std::mutex mMutex;
+	std::condition_variable mWake;
+	std::condition_variable mIdle;
+	unsigned int mBusy;
+	bool mStopping;
+
+	void Run();
+private:
+	ThreadPool(const ThreadPool&);
+	ThreadPool& operator=(const ThreadPool&);
+public:
+	// 0 uses one thread less than the hardware has, but at least one
+	ThreadPool(unsigned int numThreads = 0);
+	~ThreadPool();
+
+	void Submit(const std::function<void()>& job);
+	// Blocks until every submitted job has run
+	void Wait();
+	// Jobs that have not started yet are dropped, running ones are finished and the threads
+	// joined. Also done by the destructor.
+	void Stop();
+
+	unsigned int GetNumThreads();
+};
@@ -0,0 +1,86 @@
+#include "Timer.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <time.h>
+#endif
+
+#if defined(_WIN32)
+static unsigned long long GetFrequency()
+{
+	static unsigned long long sFrequency = 0;
+
+	if (sFrequency == 0)
+	{
+		LARGE_INTEGER frequency;
+		QueryPerformanceFrequency(&frequency);
+		sFrequency = (unsigned long long)frequency.QuadPart;
+	}
+
+	return sFrequency;
+}
+#endif
+
+unsigned long long Timer::GetNanoseconds()
+{
+#if defined(_WIN32)
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	unsigned long long ticks = (unsigned long long)counter.QuadPart;
+	unsigned long long frequency = GetFrequency();
+
+	// Split so ticks * 1e9 can't overflow after a long uptime
+	return (ticks / frequency) * 1000000000ull + (ticks % frequency) * 1000000000ull / frequency;
+#else
+	timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (unsigned long long)now.tv_sec * 1000000000ull + (unsigned long long)now.tv_nsec;
+#endif
+}
+
+unsigned long long Timer::GetResolution()
+{
+#if defined(_WIN32)
+	unsigned long long frequency = GetFrequency();
+	return frequency >= 1000000000ull ? 1 : (1000000000ull + frequency - 1) / frequency;
+#else
+	timespec resolution;
+	clock_getres(CLOCK_MONOTONIC, &resolution);
+	return (unsigned long long)resolution.tv_sec * 1000000000ull + (unsigned long long)resolution.tv_nsec;
+#endif
+}
+
+Timer::Timer()
+{
+	Reset();
+}
+
+void Timer::Reset()
+{
+	mStart = GetNanoseconds();
+}
+
+double Timer::Lap()
+{
+	unsigned long long now = GetNanoseconds();
+	double seconds = (double)(now - mStart) * 1e-9;
+	mStart = now;
+	return seconds;
+}
+
+unsigned long long Timer::GetElapsedNanoseconds() const
+{
+	return GetNanoseconds() - mStart;
+}
+
+double Timer::GetElapsedMilliseconds() const
+{
+	return (double)GetElapsedNanoseconds() * 1e-6;
+}
+
+double Timer::GetElapsedSeconds() const
+{
+	return (double)GetElapsedNanoseconds() * 1e-9;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+// Monotonic clock at the platform's best resolution, QueryPerformanceCounter on Windows and
+// clock_gettime(CLOCK_MONOTONIC) elsewhere. A Timer measures from its last Reset or Lap.
+class Timer
+{
+protected:
+	unsigned long long mStart;
+public:
+	Timer();
+
+	void Reset();
+	// Time since the last Lap or Reset in seconds, the next lap starts now
+	double Lap();
+	unsigned long long GetElapsedNanoseconds() const;
+	double GetElapsedMilliseconds() const;
+	double GetElapsedSeconds() const;
+
+	// Nanoseconds since an unspecified fixed point, only differences mean anything
+	static unsigned long long GetNanoseconds();
+	// Smallest step the clock can show, in nanoseconds
+	static unsigned long long GetResolution();
+};
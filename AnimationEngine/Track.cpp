@@ -2,10 +2,6 @@
 #include "vec3.h"
 #include "quat.h"
 
-template Track<float, 1>; 
-template Track<vec3, 3>; 
-template Track<quat, 4>;
-
 namespace TrackHelpers
 {
 	inline float Interpolate(float a, float b, float t)
@@ -81,7 +77,6 @@ template<> quat Track<quat, 4>::Cast(float* value)
 	return normalized(r);
 }
 
-
 template<typename T, int N>
 inline T Track<T, N>::SampleLinear(float time, bool looping)
 {
@@ -112,7 +107,6 @@ inline T Track<T, N>::SampleLinear(float time, bool looping)
 	return TrackHelpers::Interpolate(start, end, t);
 }
 
-
 template<typename T, int N>
 inline T Track<T, N>::Hermite(float t, const T& p1, const T& s1, const T& _p2, const T& s2)
 {
@@ -130,4 +124,8 @@ inline T Track<T, N>::Hermite(float t, const T& p1, const T& s1, const T& _p2, c
 	T result = p1 * h1 + p2 * h2 + s1 * h3 + s2 * h4;
 
 	return TrackHelpers::AdjustHermiteResult(result);
-}
\ No newline at end of file
+}
+
+template class Track<float, 1>;
+template class Track<vec3, 3>;
+template class Track<quat, 4>;
@@ -5,6 +5,8 @@
 #include "Frame.h"
 #include <vector>
 #include <cassert>
+#include <cstring>
+#include <cmath>
 
 template<typename T, int N> 
 class Track 
@@ -1,4 +1,5 @@
 #include "TransformTrack.h"
+#include <limits>
 
 TransformTrack::TransformTrack()
 {
@@ -64,30 +65,30 @@ float TransformTrack::GetStartTime()
 
 float TransformTrack::GetEndTime()
 {
-	float result = std::numeric_limits<float>::min();
+	float result = -std::numeric_limits<float>::max();
 
 	if (mPosition.Size() > 1)
 	{
-		result = mPosition.GetStartTime();
+		result = mPosition.GetEndTime();
 	}
 
 	if (mRotation.Size() > 1)
 	{
-		float rotationStart = mRotation.GetStartTime();
+		float rotationEnd = mRotation.GetEndTime();
 
-		if (rotationStart > result)
+		if (rotationEnd > result)
 		{
-			result = rotationStart;
+			result = rotationEnd;
 		}
 	}
 
 	if (mScale.Size() > 1)
 	{
-		float scaleStart = mScale.GetStartTime();
+		float scaleEnd = mScale.GetEndTime();
 
-		if (scaleStart > result)
+		if (scaleEnd > result)
 		{
-			result = scaleStart;
+			result = scaleEnd;
 		}
 	}
 
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+
+// Hands the newest value from one producer thread to one consumer thread without locks. The
+// producer owns one slot, the consumer another and the third is shared. Publish swaps the
+// producer's slot with the shared one and marks it fresh, Acquire swaps the consumer's slot with
+// the shared one if it is fresh. Neither side ever waits. Values the consumer was too slow to take
+// are overwritten, the consumer keeps its last value when nothing new was published.
+// Slots are reused, so values holding containers stop allocating once they reached their size.
+template<typename T>
+class TripleBuffer
+{
+protected:
+	// Index of the shared slot in the low bits, set when it holds a value the consumer hasn't taken
+	enum { SlotMask = 3, FreshBit = 4 };
+
+	T mSlots[3];
+	// Written by both threads, kept off the cache lines of the slot indices each thread owns
+	alignas(64) std::atomic<unsigned int> mShared;
+	alignas(64) unsigned int mWrite;
+	alignas(64) unsigned int mRead;
+private:
+	TripleBuffer(const TripleBuffer&);
+	TripleBuffer& operator=(const TripleBuffer&);
+public:
+	TripleBuffer()
+	{
+		mWrite = 0;
+		mShared.store(1, std::memory_order_relaxed);
+		mRead = 2;
+	}
+
+	// Producer side, the slot to fill before Publish. Holds whatever was written to it two
+	// publishes ago, or nothing on the first calls.
+	T& GetWriteBuffer()
+	{
+		return mSlots[mWrite];
+	}
+
+	// Producer side. Returns false when the previous value was never taken by the consumer.
+	bool Publish()
+	{
+		unsigned int previous = mShared.exchange(mWrite | FreshBit, std::memory_order_acq_rel);
+		mWrite = previous & SlotMask;
+
+		return (previous & FreshBit) == 0;
+	}
+
+	// Consumer side. Returns false and keeps the current read buffer when nothing new was published.
+	bool Acquire()
+	{
+		if ((mShared.load(std::memory_order_relaxed) & FreshBit) == 0)
+		{
+			return false;
+		}
+
+		unsigned int previous = mShared.exchange(mRead, std::memory_order_acq_rel);
+		mRead = previous & SlotMask;
+
+		return true;
+	}
+
+	// Consumer side, the value taken by the last successful Acquire
+	const T& GetReadBuffer() const
+	{
+		return mSlots[mRead];
+	}
+
+	// Either side, true while a published value waits for the consumer
+	bool HasPending() const
+	{
+		return (mShared.load(std::memory_order_acquire) & FreshBit) != 0;
+	}
+};
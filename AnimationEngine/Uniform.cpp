@@ -4,16 +4,6 @@
 #include "quat.h"
 #include "glad.h"
 
-template Uniform<int>; 
-template Uniform<ivec4>; 
-template Uniform<ivec2>; 
-template Uniform<float>;
-template Uniform<vec2>; 
-template Uniform<vec3>; 
-template Uniform<vec4>; 
-template Uniform<quat>; 
-template Uniform<mat4>;
-
 template <typename T> 
 void Uniform<T>::Set(unsigned int slot, const T& value) 
 { 
@@ -45,3 +35,13 @@ void Uniform<mat4>::Set(unsigned int slot, mat4* inputArray, unsigned int arrayL
 { 
 	glUniformMatrix4fv(slot, (GLsizei)arrayLength, false, (float*)&inputArray[0]); 
 }
+
+template class Uniform<int>;
+template class Uniform<ivec4>;
+template class Uniform<ivec2>;
+template class Uniform<float>;
+template class Uniform<vec2>;
+template class Uniform<vec3>;
+template class Uniform<vec4>;
+template class Uniform<quat>;
+template class Uniform<mat4>;
@@ -0,0 +1,97 @@
+#include "UniformBuffer.h"
+#include "glad.h"
+#include "GLState.h"
+#include <iostream>
+
+UniformBuffer::UniformBuffer()
+{
+	glGenBuffers(1, &mHandle);
+	mSize = 0;
+}
+
+UniformBuffer::UniformBuffer(unsigned int size)
+{
+	glGenBuffers(1, &mHandle);
+	mSize = 0;
+	Resize(size);
+}
+
+UniformBuffer::~UniformBuffer()
+{
+	GLState::OnDeleteBuffer(mHandle);
+	glDeleteBuffers(1, &mHandle);
+}
+
+void UniformBuffer::Resize(unsigned int size)
+{
+	GLState::BindBuffer(GL_UNIFORM_BUFFER, mHandle);
+	glBufferData(GL_UNIFORM_BUFFER, size, 0, GL_DYNAMIC_DRAW);
+	mSize = size;
+}
+
+void UniformBuffer::Set(const void* data, unsigned int size)
+{
+	// A full rewrite respecifies the storage, so the driver can hand out fresh memory
+	// instead of waiting for draws still reading the old contents
+	GLState::BindBuffer(GL_UNIFORM_BUFFER, mHandle);
+	glBufferData(GL_UNIFORM_BUFFER, size > mSize ? size : mSize, size >= mSize ? data : 0, GL_DYNAMIC_DRAW);
+
+	if (size < mSize)
+	{
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, size, data);
+	}
+	else
+	{
+		mSize = size;
+	}
+}
+
+void UniformBuffer::Set(unsigned int offset, const void* data, unsigned int size)
+{
+	if (offset + size > mSize)
+	{
+		std::cout << "Uniform buffer update out of range: " << offset << " + " << size << " > " << mSize << "\n";
+		return;
+	}
+
+	GLState::BindBuffer(GL_UNIFORM_BUFFER, mHandle);
+	glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+}
+
+void UniformBuffer::BindTo(unsigned int binding)
+{
+	GLState::BindBufferBase(GL_UNIFORM_BUFFER, binding, mHandle);
+}
+
+void UniformBuffer::BindTo(unsigned int binding, unsigned int offset, unsigned int size)
+{
+	GLState::BindBufferRange(GL_UNIFORM_BUFFER, binding, mHandle, offset, size);
+}
+
+unsigned int UniformBuffer::Size()
+{
+	return mSize;
+}
+
+unsigned int UniformBuffer::GetHandle()
+{
+	return mHandle;
+}
+
+unsigned int UniformBuffer::GetOffsetAlignment()
+{
+	static int alignment = 0;
+
+	if (alignment <= 0)
+	{
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+
+		// 256 covers every implementation if the query is not answered
+		if (alignment <= 0)
+		{
+			alignment = 256;
+		}
+	}
+
+	return (unsigned int)alignment;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+// Binding points shared by every program, Shader::Load connects blocks with these names to them
+#define UNIFORM_BINDING_FRAME_CONSTANTS 0
+#define UNIFORM_BINDING_PALETTE 1
+
+// Backing storage for a std140 uniform block. Data set here is shared by every program whose
+// block is connected to the binding point the buffer is bound to, instead of being sent per program.
+class UniformBuffer
+{
+protected:
+	unsigned int mHandle;
+	unsigned int mSize;
+private:
+	UniformBuffer(const UniformBuffer&);
+	UniformBuffer& operator=(const UniformBuffer&);
+public:
+	UniformBuffer();
+	UniformBuffer(unsigned int size);
+	~UniformBuffer();
+
+	// Reallocates the storage, old contents are lost
+	void Resize(unsigned int size);
+	// Replaces all of the contents, the buffer grows if needed
+	void Set(const void* data, unsigned int size);
+	// Updates a sub range in place, it has to be inside the current size
+	void Set(unsigned int offset, const void* data, unsigned int size);
+
+	void BindTo(unsigned int binding);
+	void BindTo(unsigned int binding, unsigned int offset, unsigned int size);
+
+	unsigned int Size();
+	unsigned int GetHandle();
+
+	// Offsets handed to BindTo have to be multiples of this
+	static unsigned int GetOffsetAlignment();
+};
@@ -0,0 +1,151 @@
+#include "UpdateThread.h"
+#include "Timer.h"
+
+UpdateThread::UpdateThread(Application* application, double fixedStep) : mTimestep(fixedStep)
+{
+	mApplication = application;
+	mStopping.store(false, std::memory_order_relaxed);
+	mDeltaTime = 0.0;
+	mPaced = true;
+	mHasSnapshot = false;
+	mCollectStats = false;
+	mUpdates = 0;
+	mTime = 0.0;
+	mStats.mPublished = 0;
+	mStats.mOverwritten = 0;
+	mStats.mRepeated = 0;
+}
+
+UpdateThread::~UpdateThread()
+{
+	Stop();
+}
+
+void UpdateThread::Start(double deltaTime, bool paced)
+{
+	Stop();
+
+	mDeltaTime = deltaTime;
+	mPaced = paced;
+	mStopping.store(false, std::memory_order_relaxed);
+	mThread = std::thread(&UpdateThread::Run, this);
+}
+
+void UpdateThread::Stop()
+{
+	if (!mThread.joinable())
+	{
+		return;
+	}
+
+	mStopping.store(true, std::memory_order_relaxed);
+	mThread.join();
+}
+
+bool UpdateThread::IsRunning() const
+{
+	return mThread.joinable();
+}
+
+void UpdateThread::Update(double frameSeconds)
+{
+	Timer updateTimer;
+	double step = mTimestep.GetStep();
+	float alpha = 1.0f;
+
+	if (step > 0.0)
+	{
+		for (unsigned int steps = mTimestep.Advance(frameSeconds); steps > 0; --steps)
+		{
+			mApplication->Update((float)step);
+			mTime += step;
+			++mUpdates;
+		}
+
+		alpha = mTimestep.GetAlpha();
+	}
+	else
+	{
+		mApplication->Update((float)frameSeconds);
+		mTime += frameSeconds;
+		++mUpdates;
+	}
+
+	FrameSnapshot& snapshot = mSnapshots.GetWriteBuffer();
+	snapshot.SetUpdate(mUpdates);
+	snapshot.SetTime(mTime);
+	snapshot.SetAlpha(alpha);
+	mApplication->WriteSnapshot(snapshot);
+
+	if (mCollectStats)
+	{
+		mUpdateStats.Add(updateTimer.GetElapsedMilliseconds());
+	}
+
+	if (!mSnapshots.Publish())
+	{
+		++mStats.mOverwritten;
+	}
+	++mStats.mPublished;
+}
+
+void UpdateThread::Run()
+{
+	Timer frameClock;
+
+	while (!mStopping.load(std::memory_order_relaxed))
+	{
+		Update(mDeltaTime > 0.0 ? mDeltaTime : frameClock.Lap());
+
+		if (mPaced)
+		{
+			while (mSnapshots.HasPending() && !mStopping.load(std::memory_order_relaxed))
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+}
+
+const FrameSnapshot* UpdateThread::Acquire(bool wait)
+{
+	bool acquired = mSnapshots.Acquire();
+
+	while (!acquired && wait && IsRunning())
+	{
+		std::this_thread::yield();
+		acquired = mSnapshots.Acquire();
+	}
+
+	if (acquired)
+	{
+		mHasSnapshot = true;
+	}
+	else if (mHasSnapshot)
+	{
+		++mStats.mRepeated;
+	}
+
+	return mHasSnapshot ? &mSnapshots.GetReadBuffer() : 0;
+}
+
+void UpdateThread::CollectUpdateStats(unsigned int maxFrames)
+{
+	mUpdateStats.SetCapacity(maxFrames);
+	mCollectStats = maxFrames > 0;
+}
+
+const FrameStats& UpdateThread::GetUpdateStats() const
+{
+	return mUpdateStats;
+}
+
+const FixedTimestep& UpdateThread::GetTimestep() const
+{
+	return mTimestep;
+}
+
+UpdateThreadStats UpdateThread::GetStats() const
+{
+	return mStats;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include "Application.h"
+#include "FixedTimestep.h"
+#include "FrameSnapshot.h"
+#include "FrameStats.h"
+#include "TripleBuffer.h"
+
+struct UpdateThreadStats
+{
+	unsigned long long mPublished;
+	// Snapshots replaced by a newer one before the GL thread took them
+	unsigned long long mOverwritten;
+	// GL thread frames that found no new snapshot and drew the last one again
+	unsigned long long mRepeated;
+};
+
+// Runs Application::Update and WriteSnapshot on a thread of its own, so the thread owning the GL
+// context only reads snapshots and renders. Snapshots are handed over through a TripleBuffer.
+// Without Start the GL thread calls Update itself before Acquire, which runs the serial loop
+// through the same snapshots.
+class UpdateThread
+{
+protected:
+	Application* mApplication;
+	TripleBuffer<FrameSnapshot> mSnapshots;
+	FixedTimestep mTimestep;
+	std::thread mThread;
+	std::atomic<bool> mStopping;
+	double mDeltaTime;
+	bool mPaced;
+	bool mHasSnapshot;
+	bool mCollectStats;
+	// Update thread only, read after Stop
+	FrameStats mUpdateStats;
+	unsigned long long mUpdates;
+	double mTime;
+	UpdateThreadStats mStats;
+
+	void Run();
+private:
+	UpdateThread(const UpdateThread&);
+	UpdateThread& operator=(const UpdateThread&);
+public:
+	// A fixedStep of 0 runs one Application::Update per snapshot, otherwise Updates run in steps of
+	// that size and the snapshot carries the alpha
+	UpdateThread(Application* application, double fixedStep = 0.0);
+	~UpdateThread();
+
+	// Runs the Updates for frameSeconds and publishes a snapshot
+	void Update(double frameSeconds);
+
+	// A deltaTime of 0 measures the time between snapshots. Paced keeps the update thread at most
+	// one snapshot ahead of the GL thread, with a fixed deltaTime every rendered frame then gets
+	// exactly one new snapshot and runs repeat.
+	void Start(double deltaTime, bool paced);
+	// Finishes the snapshot being written and joins the thread. Also done by the destructor.
+	void Stop();
+	bool IsRunning() const;
+
+	// GL thread. Takes the newest snapshot and returns it, or the last one when nothing new was
+	// published. Wait spins until a new one arrives instead. Null until the first publish.
+	const FrameSnapshot* Acquire(bool wait);
+
+	// Off by default. Times the last maxFrames Updates into GetUpdateStats, call before Start.
+	void CollectUpdateStats(unsigned int maxFrames);
+	// Only valid while the thread isn't running
+	const FrameStats& GetUpdateStats() const;
+	const FixedTimestep& GetTimestep() const;
+	UpdateThreadStats GetStats() const;
+};
@@ -0,0 +1,92 @@
+#include "VertexArray.h"
+#include "GLState.h"
+#include "glad.h"
+#include "vec2.h"
+#include "vec3.h"
+#include "vec4.h"
+#include "mat4.h"
+#include "VertexEncoding.h"
+
+VertexArray::VertexArray()
+{
+	glGenVertexArrays(1, &mHandle);
+	mVertexCount = 0;
+	mIndexBuffer = 0;
+}
+
+VertexArray::~VertexArray()
+{
+	GLState::OnDeleteVertexArray(mHandle);
+	glDeleteVertexArrays(1, &mHandle);
+}
+
+template<typename T>
+void VertexArray::SetAttribute(unsigned int slot, Attribute<T>& attribute)
+{
+	// The array stays bound afterwards, GLState tracks it like any other binding
+	Bind();
+	attribute.BindTo(slot);
+
+	// Per instance data says nothing about the vertex count
+	if (attribute.GetDivisor() != 0)
+	{
+		return;
+	}
+
+	if (mVertexCount == 0 || attribute.Count() < mVertexCount)
+	{
+		mVertexCount = attribute.Count();
+	}
+}
+
+void VertexArray::SetInterleaved(InterleavedBuffer& buffer)
+{
+	Bind();
+	buffer.BindTo();
+
+	if (mVertexCount == 0 || buffer.Count() < mVertexCount)
+	{
+		mVertexCount = buffer.Count();
+	}
+}
+
+void VertexArray::SetIndexBuffer(IndexBuffer& indexBuffer)
+{
+	Bind();
+	GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer.GetHandle());
+	mIndexBuffer = &indexBuffer;
+}
+
+void VertexArray::Bind()
+{
+	GLState::BindVertexArray(mHandle);
+}
+
+unsigned int VertexArray::GetVertexCount()
+{
+	return mVertexCount;
+}
+
+IndexBuffer* VertexArray::GetIndexBuffer()
+{
+	return mIndexBuffer;
+}
+
+unsigned int VertexArray::GetHandle()
+{
+	return mHandle;
+}
+
+template void VertexArray::SetAttribute<int>(unsigned int, Attribute<int>&);
+template void VertexArray::SetAttribute<float>(unsigned int, Attribute<float>&);
+template void VertexArray::SetAttribute<vec2>(unsigned int, Attribute<vec2>&);
+template void VertexArray::SetAttribute<vec3>(unsigned int, Attribute<vec3>&);
+template void VertexArray::SetAttribute<vec4>(unsigned int, Attribute<vec4>&);
+template void VertexArray::SetAttribute<mat4>(unsigned int, Attribute<mat4>&);
+template void VertexArray::SetAttribute<ivec4>(unsigned int, Attribute<ivec4>&);
+template void VertexArray::SetAttribute<ubvec4>(unsigned int, Attribute<ubvec4>&);
+template void VertexArray::SetAttribute<half2>(unsigned int, Attribute<half2>&);
+template void VertexArray::SetAttribute<half4>(unsigned int, Attribute<half4>&);
+template void VertexArray::SetAttribute<snorm16x2>(unsigned int, Attribute<snorm16x2>&);
+template void VertexArray::SetAttribute<unorm8x4>(unsigned int, Attribute<unorm8x4>&);
+template void VertexArray::SetAttribute<unorm16x4>(unsigned int, Attribute<unorm16x4>&);
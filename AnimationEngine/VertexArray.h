@@ -0,0 +1,33 @@
+#pragma once
+#include "Attribute.h"
+#include "IndexBuffer.h"
+#include "InterleavedBuffer.h"
+
+// Owns a vertex array object that remembers which attributes and index buffer a mesh uses.
+// The bindings are captured once with SetAttribute / SetIndexBuffer, drawing afterwards is a
+// single bind instead of a BindTo per attribute.
+class VertexArray
+{
+protected:
+	unsigned int mHandle;
+	unsigned int mVertexCount;
+	IndexBuffer* mIndexBuffer;
+private:
+	VertexArray(const VertexArray& other);
+	VertexArray& operator=(const VertexArray& other);
+public:
+	VertexArray();
+	~VertexArray();
+
+	template<typename T>
+	void SetAttribute(unsigned int slot, Attribute<T>& attribute);
+	// Captures every element of the buffer's layout
+	void SetInterleaved(InterleavedBuffer& buffer);
+	void SetIndexBuffer(IndexBuffer& indexBuffer);
+	void Bind();
+
+	// Smallest Count of the attributes set so far, used for non indexed draws
+	unsigned int GetVertexCount();
+	IndexBuffer* GetIndexBuffer();
+	unsigned int GetHandle();
+};
@@ -0,0 +1,291 @@
+#include "VertexEncoding.h"
+#include <cmath>
+#include <cstring>
+
+unsigned short FloatToHalf(float value)
+{
+	unsigned int bits;
+	memcpy(&bits, &value, sizeof(float));
+
+	unsigned int sign = (bits >> 16) & 0x8000;
+	unsigned int exponent = (bits >> 23) & 0xFF;
+	unsigned int mantissa = bits & 0x7FFFFF;
+
+	if (exponent == 0xFF) // Inf and NaN
+	{
+		return (unsigned short)(sign | 0x7C00 | (mantissa != 0 ? 0x200 : 0));
+	}
+
+	int halfExponent = (int)exponent - 127 + 15;
+
+	if (halfExponent >= 31) // Too large, becomes Inf
+	{
+		return (unsigned short)(sign | 0x7C00);
+	}
+
+	if (halfExponent <= 0) // Subnormal or zero
+	{
+		if (halfExponent < -10)
+		{
+			return (unsigned short)sign;
+		}
+
+		mantissa |= 0x800000;
+		unsigned int shift = (unsigned int)(14 - halfExponent);
+		unsigned int half = mantissa >> shift;
+		unsigned int remainder = mantissa & ((1u << shift) - 1);
+		unsigned int halfway = 1u << (shift - 1);
+
+		if (remainder > halfway || (remainder == halfway && (half & 1)))
+		{
+			half += 1;
+		}
+
+		return (unsigned short)(sign | half);
+	}
+
+	// Round to nearest even, a carry out of the mantissa correctly bumps the exponent
+	unsigned int half = ((unsigned int)halfExponent << 10) | (mantissa >> 13);
+	unsigned int remainder = mantissa & 0x1FFF;
+
+	if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+	{
+		half += 1;
+	}
+
+	return (unsigned short)(sign | half);
+}
+
+float HalfToFloat(unsigned short value)
+{
+	unsigned int sign = (unsigned int)(value & 0x8000) << 16;
+	unsigned int exponent = (value >> 10) & 0x1F;
+	unsigned int mantissa = value & 0x3FF;
+	unsigned int bits = 0;
+
+	if (exponent == 0)
+	{
+		if (mantissa == 0)
+		{
+			bits = sign;
+		}
+		else
+		{
+			exponent = 1;
+
+			while ((mantissa & 0x400) == 0)
+			{
+				mantissa <<= 1;
+				exponent -= 1;
+			}
+
+			mantissa &= 0x3FF;
+			bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+		}
+	}
+	else if (exponent == 31)
+	{
+		bits = sign | 0x7F800000 | (mantissa << 13);
+	}
+	else
+	{
+		bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+	}
+
+	float result;
+	memcpy(&result, &bits, sizeof(float));
+
+	return result;
+}
+
+half2 EncodeHalf2(const vec2& v)
+{
+	half2 result;
+	result.x = FloatToHalf(v.x);
+	result.y = FloatToHalf(v.y);
+
+	return result;
+}
+
+half4 EncodeHalf4(const vec3& v)
+{
+	half4 result;
+	result.x = FloatToHalf(v.x);
+	result.y = FloatToHalf(v.y);
+	result.z = FloatToHalf(v.z);
+	result.w = 0x3C00; // 1.0
+
+	return result;
+}
+
+static float SignNotZero(float f)
+{
+	return f >= 0.0f ? 1.0f : -1.0f;
+}
+
+static short FloatToSnorm16(float f)
+{
+	f = f < -1.0f ? -1.0f : (f > 1.0f ? 1.0f : f);
+
+	return (short)roundf(f * 32767.0f);
+}
+
+snorm16x2 EncodeOctahedral(const vec3& n)
+{
+	float l1 = fabsf(n.x) + fabsf(n.y) + fabsf(n.z);
+	snorm16x2 result;
+
+	if (l1 < VEC3_EPSILON)
+	{
+		result.x = 0;
+		result.y = 0;
+		return result;
+	}
+
+	float x = n.x / l1;
+	float y = n.y / l1;
+
+	// Fold the lower hemisphere over the diagonals
+	if (n.z < 0.0f)
+	{
+		float foldedX = (1.0f - fabsf(y)) * SignNotZero(x);
+		float foldedY = (1.0f - fabsf(x)) * SignNotZero(y);
+		x = foldedX;
+		y = foldedY;
+	}
+
+	result.x = FloatToSnorm16(x);
+	result.y = FloatToSnorm16(y);
+
+	return result;
+}
+
+vec3 DecodeOctahedral(const snorm16x2& e)
+{
+	float x = e.x < -32767 ? -1.0f : (float)e.x / 32767.0f;
+	float y = e.y < -32767 ? -1.0f : (float)e.y / 32767.0f;
+	vec3 n(x, y, 1.0f - fabsf(x) - fabsf(y));
+
+	float t = n.z < 0.0f ? -n.z : 0.0f;
+	n.x += n.x >= 0.0f ? -t : t;
+	n.y += n.y >= 0.0f ? -t : t;
+
+	return normalized(n);
+}
+
+// Rounds every weight, then hands the rounding error to the largest weight so the sum stays exact
+static void QuantizeWeights(const vec4& weights, float scale, unsigned int* out)
+{
+	float sum = weights.x + weights.y + weights.z + weights.w;
+	float normalize = sum > 0.0f ? scale / sum : 0.0f;
+	int total = 0;
+	unsigned int largest = 0;
+
+	for (unsigned int i = 0; i < 4; ++i)
+	{
+		float w = weights.v[i] < 0.0f ? 0.0f : weights.v[i];
+		out[i] = (unsigned int)(w * normalize + 0.5f);
+		total += (int)out[i];
+
+		if (weights.v[i] > weights.v[largest])
+		{
+			largest = i;
+		}
+	}
+
+	if (sum > 0.0f)
+	{
+		out[largest] = (unsigned int)((int)out[largest] + ((int)scale - total));
+	}
+}
+
+unorm8x4 EncodeWeights8(const vec4& weights)
+{
+	unsigned int q[4];
+	QuantizeWeights(weights, 255.0f, q);
+
+	unorm8x4 result;
+	result.x = (unsigned char)q[0];
+	result.y = (unsigned char)q[1];
+	result.z = (unsigned char)q[2];
+	result.w = (unsigned char)q[3];
+
+	return result;
+}
+
+unorm16x4 EncodeWeights16(const vec4& weights)
+{
+	unsigned int q[4];
+	QuantizeWeights(weights, 65535.0f, q);
+
+	unorm16x4 result;
+	result.x = (unsigned short)q[0];
+	result.y = (unsigned short)q[1];
+	result.z = (unsigned short)q[2];
+	result.w = (unsigned short)q[3];
+
+	return result;
+}
+
+void EncodeHalf2(const vec2* input, half2* output, unsigned int count)
+{
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		output[i] = EncodeHalf2(input[i]);
+	}
+}
+
+void EncodeHalf4(const vec3* input, half4* output, unsigned int count)
+{
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		output[i] = EncodeHalf4(input[i]);
+	}
+}
+
+void EncodeOctahedral(const vec3* input, snorm16x2* output, unsigned int count)
+{
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		output[i] = EncodeOctahedral(input[i]);
+	}
+}
+
+void EncodeWeights8(const vec4* input, unorm8x4* output, unsigned int count)
+{
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		output[i] = EncodeWeights8(input[i]);
+	}
+}
+
+void EncodeWeights16(const vec4* input, unorm16x4* output, unsigned int count)
+{
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		output[i] = EncodeWeights16(input[i]);
+	}
+}
+
+bool EncodeJoints(const ivec4* input, ubvec4* output, unsigned int count)
+{
+	bool fits = true;
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		for (unsigned int j = 0; j < 4; ++j)
+		{
+			int joint = input[i].v[j];
+
+			if (joint < 0 || joint > 255)
+			{
+				fits = false;
+				joint = joint < 0 ? 0 : 255;
+			}
+
+			output[i].v[j] = (unsigned char)joint;
+		}
+	}
+
+	return fits;
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include "vec2.h"
+#include "vec3.h"
+#include "vec4.h"
+
+// Compact vertex formats. Each one maps to an Attribute<T> / VertexFormat with the matching
+// GL type, the shaders keep declaring vec2/vec3/vec4 inputs and get floats back.
+
+struct half2
+{
+	unsigned short x;
+	unsigned short y;
+};
+
+// Positions use four halves, three would leave the attribute 2 byte aligned. w is 1.0.
+struct half4
+{
+	unsigned short x;
+	unsigned short y;
+	unsigned short z;
+	unsigned short w;
+};
+
+// Octahedral unit vector, decode in the vertex shader with:
+//   vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+//   float t = max(-n.z, 0.0);
+//   n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+//   n = normalize(n);
+struct snorm16x2
+{
+	short x;
+	short y;
+};
+
+struct unorm8x4
+{
+	unsigned char x;
+	unsigned char y;
+	unsigned char z;
+	unsigned char w;
+};
+
+struct unorm16x4
+{
+	unsigned short x;
+	unsigned short y;
+	unsigned short z;
+	unsigned short w;
+};
+
+unsigned short FloatToHalf(float value);
+float HalfToFloat(unsigned short value);
+
+half2 EncodeHalf2(const vec2& v);
+half4 EncodeHalf4(const vec3& v);
+snorm16x2 EncodeOctahedral(const vec3& n);
+vec3 DecodeOctahedral(const snorm16x2& e);
+// Weights are normalized and rounded so the encoded values still add up to exactly 1.0
+unorm8x4 EncodeWeights8(const vec4& weights);
+unorm16x4 EncodeWeights16(const vec4& weights);
+
+void EncodeHalf2(const vec2* input, half2* output, unsigned int count);
+void EncodeHalf4(const vec3* input, half4* output, unsigned int count);
+void EncodeOctahedral(const vec3* input, snorm16x2* output, unsigned int count);
+void EncodeWeights8(const vec4* input, unorm8x4* output, unsigned int count);
+void EncodeWeights16(const vec4* input, unorm16x4* output, unsigned int count);
+// Returns false if an index does not fit in a byte, those are clamped to 255
+bool EncodeJoints(const ivec4* input, ubvec4* output, unsigned int count);
@@ -0,0 +1,134 @@
+#include "VertexLayout.h"
+#include <cstring>
+
+VertexLayout::VertexLayout()
+{
+	mStride = 0;
+}
+
+VertexLayout& VertexLayout::Add(unsigned int slot, VertexFormat format)
+{
+	VertexElement element;
+	element.mSlot = slot;
+	element.mFormat = format;
+	element.mOffset = mStride;
+
+	mElements.push_back(element);
+	// Keep every element 4 byte aligned, some drivers fall off the fast path otherwise
+	mStride += (VertexFormatSize(format) + 3) & ~3;
+
+	return *this;
+}
+
+unsigned int VertexLayout::Size() const
+{
+	return (unsigned int)mElements.size();
+}
+
+unsigned int VertexLayout::GetStride() const
+{
+	return mStride;
+}
+
+const VertexElement& VertexLayout::operator[](unsigned int index) const
+{
+	return mElements[index];
+}
+
+bool VertexLayout::operator==(const VertexLayout& other) const
+{
+	if (mStride != other.mStride || mElements.size() != other.mElements.size())
+	{
+		return false;
+	}
+
+	for (unsigned int i = 0, size = (unsigned int)mElements.size(); i < size; ++i)
+	{
+		if (mElements[i].mSlot != other.mElements[i].mSlot || mElements[i].mFormat != other.mElements[i].mFormat)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool VertexLayout::operator!=(const VertexLayout& other) const
+{
+	return !(*this == other);
+}
+
+unsigned int VertexFormatSize(VertexFormat format)
+{
+	switch (format)
+	{
+	case VertexFormat::Float:
+		return 4;
+	case VertexFormat::Float2:
+		return 8;
+	case VertexFormat::Float3:
+		return 12;
+	case VertexFormat::Float4:
+		return 16;
+	case VertexFormat::Int:
+		return 4;
+	case VertexFormat::Int4:
+		return 16;
+	case VertexFormat::Half2:
+		return 4;
+	case VertexFormat::Half4:
+		return 8;
+	case VertexFormat::Snorm16x2:
+		return 4;
+	case VertexFormat::Unorm8x4:
+		return 4;
+	case VertexFormat::Unorm16x4:
+		return 8;
+	case VertexFormat::UByte4:
+		return 4;
+	}
+
+	return 0;
+}
+
+// A compile time size lets the copy become a couple of register moves instead of a memcpy call
+template<unsigned int N>
+static void PackElement(const unsigned char* src, unsigned char* dst, unsigned int stride, unsigned int vertexCount)
+{
+	for (unsigned int v = 0; v < vertexCount; ++v)
+	{
+		memcpy(dst, src, N);
+		src += N;
+		dst += stride;
+	}
+}
+
+void PackVertices(const VertexLayout& layout, const void* const* streams, unsigned int vertexCount, void* out)
+{
+	unsigned int stride = layout.GetStride();
+	unsigned char* dst = (unsigned char*)out;
+
+	// One element at a time keeps the reads sequential, the writes are strided either way
+	for (unsigned int e = 0, numElements = layout.Size(); e < numElements; ++e)
+	{
+		const VertexElement& element = layout[e];
+		const unsigned char* src = (const unsigned char*)streams[e];
+		unsigned char* target = dst + element.mOffset;
+
+		switch (VertexFormatSize(element.mFormat))
+		{
+		case 4:
+			PackElement<4>(src, target, stride, vertexCount);
+			break;
+		case 8:
+			PackElement<8>(src, target, stride, vertexCount);
+			break;
+		case 12:
+			PackElement<12>(src, target, stride, vertexCount);
+			break;
+		case 16:
+			PackElement<16>(src, target, stride, vertexCount);
+			break;
+		}
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <vector>
+
+enum class VertexFormat
+{
+	Float,
+	Float2,
+	Float3,
+	Float4,
+	Int,
+	Int4,
+	Half2,		// half2
+	Half4,		// half4
+	Snorm16x2,	// snorm16x2, octahedral normals
+	Unorm8x4,	// unorm8x4 weights
+	Unorm16x4,	// unorm16x4 weights
+	UByte4		// ubvec4 joint indices, read as integers
+};
+
+struct VertexElement
+{
+	unsigned int mSlot;
+	VertexFormat mFormat;
+	unsigned int mOffset;
+};
+
+// Describes one interleaved vertex: which attribute slot every element feeds, its format and
+// where it sits in the vertex. Elements are packed in the order they are added.
+class VertexLayout
+{
+protected:
+	std::vector<VertexElement> mElements;
+	unsigned int mStride;
+public:
+	VertexLayout();
+
+	VertexLayout& Add(unsigned int slot, VertexFormat format);
+	unsigned int Size() const;
+	unsigned int GetStride() const;
+	const VertexElement& operator[](unsigned int index) const;
+	bool operator==(const VertexLayout& other) const;
+	bool operator!=(const VertexLayout& other) const;
+};
+
+unsigned int VertexFormatSize(VertexFormat format);
+
+// Interleaves separate, tightly packed arrays (one per element, in layout order) into out,
+// which must hold vertexCount * layout.GetStride() bytes
+void PackVertices(const VertexLayout& layout, const void* const* streams, unsigned int vertexCount, void* out);
@@ -1,3 +1,6 @@
+// Windowed entry point, HeadlessMain.cpp drives the Application on other platforms
+#if defined(_WIN32)
+
 #define _CRT_SECURE_NO_WARNINGS
 #define WIN32_LEAN_AND_MEAN
 #define WIN32_EXTRA_LEAN
@@ -6,6 +9,12 @@
 #include <Windows.h>
 #include <iostream>
 #include "Application.h"
+#include "FrameStats.h"
+#include "GLState.h"
+#include "GLExtensions.h"
+#include "ShaderCache.h"
+#include "Timer.h"
+#include "UpdateThread.h"
 #include "vec3.h"
 
 int WINAPI WinMain(HINSTANCE, HINSTANCE, PSTR, int);
@@ -18,6 +27,13 @@ LRESULT CALLBACK WndProc(HWND, UINT, WPARAM, LPARAM);
 #define WGL_CONTEXT_FLAGS_ARB             0x2094
 #define WGL_CONTEXT_PROFILE_MASK_ARB      0x9126
 #define WGL_CONTEXT_CORE_PROFILE_BIT_ARB  0x00000001
+// Seconds per Update, 0 runs one Update per frame with the measured frame time
+#define WINMAIN_FIXED_STEP 0.0
+// 1 runs Update on an UpdateThread, the window thread then only renders its snapshots
+#define WINMAIN_UPDATE_THREAD 0
+// Frame times kept for the summary printed at exit, the last minute at 60 Hz
+#define WINMAIN_STATS_FRAMES 3600
+
 typedef HGLRC(WINAPI* PFNWGLCREATECONTEXTATTRIBSARBPROC) (HDC hDC, HGLRC hShareContext, const int* attribList);
 
 typedef const char* (WINAPI* PFNWGLGETEXTENSIONSSTRINGEXTPROC) (void); 
@@ -26,6 +42,20 @@ typedef int (WINAPI* PFNWGLGETSWAPINTERVALEXTPROC) (void);
 
 Application* gApplication = 0; 
 GLuint gVertexArrayObject = 0;
+UpdateThread* gUpdateThread = 0;
+
+// wglGetProcAddress only knows entry points above OpenGL 1.1, the rest come from opengl32.dll
+static void* GetGLProcAddress(const char* name)
+{
+	void* proc = (void*)wglGetProcAddress(name);
+
+	if (proc == 0 || proc == (void*)0x1 || proc == (void*)0x2 || proc == (void*)0x3 || proc == (void*)-1)
+	{
+		proc = (void*)GetProcAddress(GetModuleHandleA("opengl32.dll"), name);
+	}
+
+	return proc;
+}
 
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR szCmdLine, int iCmdShow)
 {
@@ -97,6 +127,8 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR szCmdLine,
 	else
 	{
 		std::cout << "OpenGL Version " << GLVersion.major << "." << GLVersion.minor << "\n";
+		GLExtensions::Load(GetGLProcAddress);
+		ShaderCache::SetDirectory("ShaderCache");
 	}
 
 	PFNWGLGETEXTENSIONSSTRINGEXTPROC _wglGetExtensionsStringEXT = (PFNWGLGETEXTENSIONSSTRINGEXTPROC)wglGetProcAddress("wglGetExtensionsStringEXT"); bool swapControlSupported = strstr(_wglGetExtensionsStringEXT(), "WGL_EXT_swap_control") != 0;
@@ -122,15 +154,24 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR szCmdLine,
 	}
 
 	glGenVertexArrays(1, &gVertexArrayObject);
-	glBindVertexArray(gVertexArrayObject);
+	GLState::BindVertexArray(gVertexArrayObject);
 
 	ShowWindow(hwnd, SW_SHOW);
 	UpdateWindow(hwnd);
 	gApplication->Initialize();
 
-	DWORD lastTick = GetTickCount();
+	Timer frameClock;
+	UpdateThread updates(gApplication, WINMAIN_FIXED_STEP);
+	gUpdateThread = &updates;
+	FrameStats frameStats;
+	frameStats.SetCapacity(WINMAIN_STATS_FRAMES);
 	MSG msg;
 
+	if (WINMAIN_UPDATE_THREAD)
+	{
+		updates.Start(0.0, true);
+	}
+
 	while (true)
 	{
 		if (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE))
@@ -144,17 +185,21 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR szCmdLine,
 			DispatchMessage(&msg);
 		}
 
-		DWORD thisTick = GetTickCount();
-		float dt = float(thisTick - lastTick) * 0.001f;
-		lastTick = thisTick;
+		double dt = frameClock.Lap();
+		frameStats.Add(dt * 1000.0);
 
-		if (gApplication != 0)
+		if (gApplication != 0 && !updates.IsRunning())
 		{
-			gApplication->Update(dt);
+			updates.Update(dt);
 		}
 
-		if (gApplication != 0)
+		// Null until the update thread published its first snapshot
+		const FrameSnapshot* snapshot = gApplication != 0 ? updates.Acquire(false) : 0;
+
+		if (snapshot != 0)
 		{
+			gApplication->ReadSnapshot(*snapshot);
+
 			RECT clientRect;
 			GetClientRect(hwnd, &clientRect);
 
@@ -165,12 +210,12 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR szCmdLine,
 			glEnable(GL_DEPTH_TEST);
 			glEnable(GL_CULL_FACE);
 			glPointSize(5.0f);
-			glBindVertexArray(gVertexArrayObject);
+			GLState::BindVertexArray(gVertexArrayObject);
 			glClearColor(0.5f, 0.6f, 0.7f, 1.0f);
 			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 
 			float aspect = (float)clientWidth / (float)clientHeight;
-			gApplication->Render(aspect);
+			gApplication->Render(aspect, snapshot->GetAlpha());
 		}
 
 		if (gApplication != 0)
@@ -183,6 +228,9 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR szCmdLine,
 		}
 	}// End of Game Loop
 
+	gUpdateThread = 0;
+	frameStats.Print("frame");
+
 	if (gApplication != 0)
 	{
 		std::cout << "Expected application to be null on exit\n"; delete gApplication;
@@ -199,6 +247,10 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT iMsg, WPARAM wParam, LPARAM lParam)
 	case WM_CLOSE: 
 		if (gApplication != 0) 
 		{
+			if (gUpdateThread != 0)
+			{
+				gUpdateThread->Stop();
+			}
 			gApplication->Shutdown(); 
 			delete gApplication; 
 			gApplication = 0; 
@@ -214,7 +266,8 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT iMsg, WPARAM wParam, LPARAM lParam)
 		{
 			HDC hdc = GetDC(hwnd); 
 			HGLRC hglrc = wglGetCurrentContext();
-			glBindVertexArray(0); 
+			GLState::BindVertexArray(0); 
+			GLState::OnDeleteVertexArray(gVertexArrayObject);
 			glDeleteVertexArrays(1, &gVertexArrayObject); 
 			gVertexArrayObject = 0; 
 			wglMakeCurrent(NULL, NULL); 
@@ -245,3 +298,5 @@ int main(int argc, const char** argv)
 #pragma comment(linker, "/subsystem:windows")
 #endif
 #pragma comment(lib, "opengl32.lib")
+
+#endif
@@ -0,0 +1,33 @@
+#version 430 core 
+layout(std140) uniform FrameConstants 
+{ 
+	mat4 view; 
+	mat4 projection; 
+	vec4 light; 
+}; 
+struct DrawData 
+{ 
+	mat4 model; 
+	vec4 params; 
+}; 
+layout(std430, binding = 0) readonly buffer Draws 
+{ 
+	DrawData draws[]; 
+}; 
+in vec3 position; 
+in vec3 normal; 
+in vec2 texCoord; 
+in uint drawId; 
+
+out vec3 norm;
+out vec3 fragPos; 
+out vec2 uv; 
+
+void main() 
+{ 
+	mat4 model = draws[drawId].model; 
+	gl_Position = projection * view * model * vec4(position, 1.0); 
+	fragPos = vec3(model * vec4(position, 1.0)); 
+	norm = vec3(model * vec4(normal, 0.0f)); 
+	uv = texCoord * draws[drawId].params.zw + draws[drawId].params.xy; 
+}
@@ -0,0 +1,23 @@
+#version 330 core 
+layout(std140) uniform FrameConstants 
+{ 
+	mat4 view; 
+	mat4 projection; 
+	vec4 light; 
+}; 
+in vec3 position; 
+in vec3 normal; 
+in vec2 texCoord; 
+in mat4 instanceModel; 
+
+out vec3 norm;
+out vec3 fragPos; 
+out vec2 uv; 
+
+void main() 
+{ 
+	gl_Position = projection * view * instanceModel * vec4(position, 1.0); 
+	fragPos = vec3(instanceModel * vec4(position, 1.0)); 
+	norm = vec3(instanceModel * vec4(normal, 0.0f)); 
+	uv = texCoord; 
+}
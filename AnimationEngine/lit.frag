@@ -1,8 +1,13 @@
 #version 330 core 
+layout(std140) uniform FrameConstants 
+{ 
+	mat4 view; 
+	mat4 projection; 
+	vec4 light; 
+}; 
 in vec3 norm; 
 in vec3 fragPos; 
 in vec2 uv; 
-uniform vec3 light;
 uniform sampler2D tex0; 
 out vec4 FragColor; 
 
@@ -10,7 +15,7 @@ void main()
 { 
 	vec4 diffuseColor = texture(tex0, uv); 
 	vec3 n = normalize(norm); 
-	vec3 l = normalize(light); 
+	vec3 l = normalize(light.xyz); 
 	float diffuseIntensity = clamp(dot(n, l), 0, 1); 
 	FragColor = diffuseColor * diffuseIntensity; 
 }
@@ -0,0 +1,23 @@
+#version 330 core 
+layout(std140) uniform FrameConstants 
+{ 
+	mat4 view; 
+	mat4 projection; 
+	vec4 light; 
+}; 
+in vec3 norm; 
+in vec3 fragPos; 
+in vec2 uv; 
+uniform sampler2DArray tex0; 
+// Picks the variation, a layer of the texture array 
+uniform int layer; 
+out vec4 FragColor; 
+
+void main() 
+{ 
+	vec4 diffuseColor = texture(tex0, vec3(uv, float(layer))); 
+	vec3 n = normalize(norm); 
+	vec3 l = normalize(light.xyz); 
+	float diffuseIntensity = clamp(dot(n, l), 0, 1); 
+	FragColor = diffuseColor * diffuseIntensity; 
+}
@@ -0,0 +1,23 @@
+#version 330 core 
+layout(std140) uniform FrameConstants 
+{ 
+	mat4 view; 
+	mat4 projection; 
+	vec4 light; 
+}; 
+in vec3 norm; 
+in vec3 fragPos; 
+in vec2 uv; 
+uniform sampler2D tex0; 
+// Region of the atlas holding this variation, see TextureAtlas 
+uniform vec4 uvTransform; 
+out vec4 FragColor; 
+
+void main() 
+{ 
+	vec4 diffuseColor = texture(tex0, uv * uvTransform.zw + uvTransform.xy); 
+	vec3 n = normalize(norm); 
+	vec3 l = normalize(light.xyz); 
+	float diffuseIntensity = clamp(dot(n, l), 0, 1); 
+	FragColor = diffuseColor * diffuseIntensity; 
+}
@@ -10,8 +10,6 @@ struct mat4
 	union 
 	{
 		float v[16];
-	
-		struct { vec4 right; vec4 up; vec4 forward; vec4 position; };
 		
 		struct 
 		{ 
@@ -16,11 +16,6 @@ struct quat
 			float z; 
 			float w; 
 		}; 
-		struct 
-		{ 
-			vec3 vector; 
-			float scalar; 
-		}; 
 		float v[4]; 
 	}; 
 	
@@ -0,0 +1,34 @@
+#version 330 core 
+layout(std140) uniform FrameConstants 
+{ 
+	mat4 view; 
+	mat4 projection; 
+	vec4 light; 
+}; 
+layout(std140) uniform Palette 
+{ 
+	mat4 pose[120]; 
+}; 
+uniform mat4 model; 
+in vec3 position; 
+in vec3 normal; 
+in vec2 texCoord; 
+in vec4 weights; 
+in ivec4 joints; 
+
+out vec3 norm;
+out vec3 fragPos; 
+out vec2 uv; 
+
+void main() 
+{ 
+	mat4 skin = pose[joints.x] * weights.x + 
+		pose[joints.y] * weights.y + 
+		pose[joints.z] * weights.z + 
+		pose[joints.w] * weights.w; 
+	
+	gl_Position = projection * view * model * skin * vec4(position, 1.0); 
+	fragPos = vec3(model * skin * vec4(position, 1.0)); 
+	norm = vec3(model * skin * vec4(normal, 0.0f)); 
+	uv = texCoord; 
+}
@@ -1,7 +1,11 @@
 #version 330 core 
+layout(std140) uniform FrameConstants 
+{ 
+	mat4 view; 
+	mat4 projection; 
+	vec4 light; 
+}; 
 uniform mat4 model; 
-uniform mat4 view; 
-uniform mat4 projection; 
 in vec3 position; 
 in vec3 normal; 
 in vec2 texCoord; 